@@ -123,7 +123,8 @@ class HyperElasticPotential
         Eigen::Ref<VectorX const> const& x,
         bool bWithGradient,
         bool bWithHessian,
-        bool bWithSpdProjection);
+        bool bWithSpdProjection,
+        pbat::fem::EHessianProjection eProjection);
 
     Scalar Eval() const;
     VectorX ToVector() const;
@@ -170,6 +171,11 @@ void BindHyperElasticPotential(pybind11::module& m)
         .value("StableNeoHookean", EHyperElasticEnergy::StableNeoHookean)
         .export_values();
 
+    pyb::enum_<pbat::fem::EHessianProjection>(m, "HessianProjection")
+        .value("Element", pbat::fem::EHessianProjection::Element)
+        .value("QuadraturePoint", pbat::fem::EHessianProjection::QuadraturePoint)
+        .export_values();
+
     pyb::class_<HyperElasticPotential>(m, "HyperElasticPotential")
         .def(
             pyb::init<
@@ -223,11 +229,16 @@ void BindHyperElasticPotential(pybind11::module& m)
             "compute_element_elasticity",
             &HyperElasticPotential::ComputeElementElasticity,
             pyb::arg("x"),
-            pyb::arg("grad")    = true,
-            pyb::arg("hessian") = true,
-            pyb::arg("spd")     = true,
+            pyb::arg("grad")       = true,
+            pyb::arg("hessian")    = true,
+            pyb::arg("spd")        = true,
+            pyb::arg("projection") = pbat::fem::EHessianProjection::QuadraturePoint,
             "Compute per-element potential energy and its derivatives, projecting the hessian to a "
-            "positive definite state if spd=True.")
+            "positive definite state if spd=True. The projection is applied to each quadrature "
+            "point's hessian w.r.t. the deformation gradient, or to each element hessian, as "
+            "specified by projection. The default projection changed from per-element to "
+            "per-quadrature point, which yields different hessians. Pass "
+            "projection=HessianProjection.Element for the previous per-element behaviour.")
         .def("eval", &HyperElasticPotential::Eval)
         .def("gradient", &HyperElasticPotential::ToVector)
         .def("hessian", &HyperElasticPotential::ToMatrix)
@@ -384,14 +395,16 @@ void HyperElasticPotential::ComputeElementElasticity(
     Eigen::Ref<VectorX const> const& x,
     bool bWithGradient,
     bool bWithHessian,
-    bool bWithSpdProjection)
+    bool bWithSpdProjection,
+    pbat::fem::EHessianProjection eProjection)
 {
     Apply([&]<class HyperElasticPotentialType>(HyperElasticPotentialType* hyperElasticPotential) {
         hyperElasticPotential->template ComputeElementElasticity<Eigen::Ref<VectorX const>>(
             x,
             bWithGradient,
             bWithHessian,
-            bWithSpdProjection);
+            bWithSpdProjection,
+            eProjection);
     });
 }
 
@@ -0,0 +1,76 @@
+#include "BatchIntegrator.h"
+
+#include <pbat/sim/vbd/BatchIntegrator.h>
+#include <pbat/sim/vbd/Data.h>
+#include <pybind11/eigen.h>
+#include <pybind11/stl.h>
+
+namespace pbat {
+namespace py {
+namespace sim {
+namespace vbd {
+
+void BindBatchIntegrator(pybind11::module& m)
+{
+    namespace pyb    = pybind11;
+    using ScalarType = pbat::Scalar;
+    using pbat::sim::vbd::BatchIntegrator;
+    using pbat::sim::vbd::Data;
+    pyb::class_<BatchIntegrator>(m, "BatchIntegrator")
+        .def(
+            pyb::init<std::vector<Data> const&>(),
+            pyb::arg("scenes"),
+            "Packs constructed VBD scenes into a single flat store, such that all scenes are "
+            "stepped in 1 parallel pass per color. Scenes must share the same element type, "
+            "hyper elastic energy and solver parameters. Scenes never collide with each other.")
+        .def(
+            "step",
+            &BatchIntegrator::Step,
+            pyb::arg("dt"),
+            pyb::arg("iterations"),
+            pyb::arg("substeps") = 1,
+            pyb::arg("rho")      = ScalarType(1),
+            "Integrate all scenes 1 time step.")
+        .def_property_readonly("n_scenes", &BatchIntegrator::NumberOfScenes)
+        .def(
+            "vertices",
+            &BatchIntegrator::Vertices,
+            pyb::arg("scene"),
+            "|#nodes| indices into integrator.data's nodes of the given scene's nodes, in the "
+            "scene's user ordering")
+        .def(
+            "positions",
+            &BatchIntegrator::Positions,
+            pyb::arg("scene"),
+            "3x|#nodes| nodal positions of the given scene, in the scene's user ordering")
+        .def(
+            "velocities",
+            &BatchIntegrator::Velocities,
+            pyb::arg("scene"),
+            "3x|#nodes| nodal velocities of the given scene, in the scene's user ordering")
+        .def(
+            "set_positions",
+            &BatchIntegrator::SetPositions,
+            pyb::arg("scene"),
+            pyb::arg("x"),
+            "Sets the 3x|#nodes| nodal positions of the given scene, in the scene's user ordering")
+        .def(
+            "set_velocities",
+            &BatchIntegrator::SetVelocities,
+            pyb::arg("scene"),
+            pyb::arg("v"),
+            "Sets the 3x|#nodes| nodal velocities of the given scene, in the scene's user "
+            "ordering")
+        .def_readonly(
+            "vertex_prefix",
+            &BatchIntegrator::vertexPrefix,
+            "|#scenes+1| prefix s.t. vertices of scene s are "
+            "[vertex_prefix[s], vertex_prefix[s+1]) in integrator.data, in the scene's internal "
+            "ordering")
+        .def_readwrite("integrator", &BatchIntegrator::integrator);
+}
+
+} // namespace vbd
+} // namespace sim
+} // namespace py
+} // namespace pbat
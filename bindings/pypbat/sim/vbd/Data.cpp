@@ -14,6 +14,8 @@ void BindData(pybind11::module& m)
 {
     namespace pyb = pybind11;
     using pbat::sim::vbd::Data;
+    using pbat::sim::vbd::EElement;
+    using pbat::sim::vbd::EHyperElasticEnergy;
     using pbat::sim::vbd::EInitializationStrategy;
 
     pyb::enum_<EInitializationStrategy>(m, "InitializationStrategy")
@@ -24,6 +26,13 @@ void BindData(pybind11::module& m)
         .value("AdaptivePbat", EInitializationStrategy::AdaptivePbat)
         .export_values();
 
+    pyb::enum_<EElement>(m, "Element").value("Tetrahedron", EElement::Tetrahedron).export_values();
+
+    pyb::enum_<EHyperElasticEnergy>(m, "HyperElasticEnergy")
+        .value("SaintVenantKirchhoff", EHyperElasticEnergy::SaintVenantKirchhoff)
+        .value("StableNeoHookean", EHyperElasticEnergy::StableNeoHookean)
+        .export_values();
+
     pyb::class_<Data>(m, "Data")
         .def(pyb::init<>())
         .def(
@@ -40,6 +49,12 @@ void BindData(pybind11::module& m)
             pyb::arg("F"),
             "Sets the collision mesh as array of 1x|#collision vertices| indices V into positions "
             "X and 3x|#collision triangles| indices into X.")
+        .def(
+            "with_collision_groups",
+            &Data::WithCollisionGroups,
+            pyb::arg("G"),
+            "Sets |#nodes| collision groups G, such that only vertices and triangles of the same "
+            "group collide.")
         .def(
             "with_velocity",
             &Data::WithVelocity,
@@ -97,10 +112,62 @@ void BindData(pybind11::module& m)
             "with_hessian_determinant_zero",
             &Data::WithHessianDeterminantZeroUnder,
             pyb::arg("zero"))
+        .def(
+            "with_vertex_reordering",
+            &Data::WithVertexReordering,
+            pyb::arg("reorder") = true,
+            "Renumbers vertices in construct() such that each partition is contiguous and sorted "
+            "by Morton code, and elements by their minimum vertex index. Use perm (resp. eperm) "
+            "to map results back to user ordering, i.e. x[:,perm] (resp. T[:,eperm]).")
+        .def(
+            "with_element_derivative_cache",
+            &Data::WithElementDerivativeCache,
+            pyb::arg("cache")     = true,
+            pyb::arg("tolerance") = 0.,
+            "Caches per-element elastic energy derivatives across iterations, such that they are "
+            "only recomputed once a vertex of the element moved by more than tolerance from where "
+            "it last invalidated the cache. Vertex positions are always updated. With the default "
+            "tolerance=0, the cache is exact but saves (nearly) no evaluations until vertices come "
+            "to rest, so use a small positive tolerance to reuse derivatives in late iterations.")
+        .def(
+            "with_element",
+            &Data::WithElement,
+            pyb::arg("element"),
+            pyb::arg("order") = 1,
+            "Sets the type and polynomial order of elements in T.")
+        .def(
+            "with_hyper_elastic_energy",
+            &Data::WithHyperElasticEnergy,
+            pyb::arg("energy"),
+            "Sets the hyper elastic energy of the elements.")
+        .def(
+            "with_convergence_tolerances",
+            &Data::WithConvergenceTolerances,
+            pyb::arg("residual"),
+            pyb::arg("displacement") = 0.,
+            "Stops BCD iterations once the max vertex gradient norm is under residual and the "
+            "max vertex displacement is under displacement. Non-positive tolerances are ignored.")
+        .def(
+            "with_active_set",
+            &Data::WithActiveSet,
+            pyb::arg("residual"),
+            pyb::arg("displacement"),
+            "Only solves vertices whose gradient norm exceeds residual or whose displacement (or "
+            "1-ring vertex's displacement) exceeds displacement in BCD iterations after the "
+            "first of each substep.")
+        .def(
+            "with_spectral_radius_estimation",
+            &Data::WithSpectralRadiusEstimation,
+            pyb::arg("warmup_iterations") = 3,
+            pyb::arg("rho_max")           = 0.95,
+            "Enables Chebyshev acceleration with a spectral radius estimated from the first "
+            "warmup_iterations plain BCD iterations of each substep, falling back to plain BCD "
+            "iterations upon divergence.")
         .def("construct", &Data::Construct, pyb::arg("validate") = true)
         .def_readwrite("V", &Data::V)
         .def_readwrite("F", &Data::F)
         .def_readwrite("T", &Data::T)
+        .def_readwrite("G", &Data::G)
         .def_readwrite("x", &Data::x)
         .def_readwrite("v", &Data::v)
         .def_readwrite("aext", &Data::aext)
@@ -113,12 +180,37 @@ void BindData(pybind11::module& m)
         .def_readwrite("GVGg", &Data::GVGg)
         .def_readwrite("GVGe", &Data::GVGe)
         .def_readwrite("GVGilocal", &Data::GVGilocal)
+        .def_readwrite("FC", &Data::FC)
+        .def_readwrite("GVCp", &Data::GVCp)
+        .def_readwrite("GVCc", &Data::GVCc)
+        .def_readwrite("GVCilocal", &Data::GVCilocal)
         .def_readwrite("dbc", &Data::dbc)
         .def_readwrite("partitions", &Data::partitions)
         .def_readwrite("strategy", &Data::strategy)
         .def_readwrite("kD", &Data::kD)
         .def_readwrite("kC", &Data::kC)
-        .def_readwrite("detH_zero", &Data::detHZero);
+        .def_readwrite("detH_zero", &Data::detHZero)
+        .def_readwrite("element", &Data::eElement)
+        .def_readwrite("order", &Data::order)
+        .def_readwrite("energy", &Data::eEnergy)
+        .def_readwrite("reorder_vertices", &Data::bReorderVertices)
+        .def_readwrite("perm", &Data::perm)
+        .def_readwrite("iperm", &Data::iperm)
+        .def_readwrite("eperm", &Data::eperm)
+        .def_readwrite("eiperm", &Data::eiperm)
+        .def_readwrite("cache_element_derivatives", &Data::bCacheElementDerivatives)
+        .def_readwrite("cache_tolerance", &Data::cacheTolerance)
+        .def_readwrite("residual_tolerance", &Data::residualTolerance)
+        .def_readwrite("displacement_tolerance", &Data::displacementTolerance)
+        .def_readwrite("use_active_set", &Data::bUseActiveSet)
+        .def_readwrite("active_residual_threshold", &Data::activeResidualThreshold)
+        .def_readwrite("active_displacement_threshold", &Data::activeDisplacementThreshold)
+        .def_readwrite("active", &Data::bVertexActive)
+        .def_readwrite("estimate_spectral_radius", &Data::bEstimateSpectralRadius)
+        .def_readwrite("rho_estimate", &Data::rhoEstimate)
+        .def_readwrite("rho_max", &Data::rhoMax)
+        .def_readwrite("rho_divergence_factor", &Data::rhoDivergenceFactor)
+        .def_readwrite("divergence_iterations", &Data::chebyshevDivergenceIterations);
 }
 
 } // namespace vbd
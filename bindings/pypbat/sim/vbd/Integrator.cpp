@@ -18,6 +18,26 @@ void BindIntegrator(pybind11::module& m)
     using pbat::sim::vbd::Data;
     using pbat::sim::vbd::EInitializationStrategy;
     using pbat::sim::vbd::Integrator;
+    using pbat::sim::vbd::Stats;
+    pyb::class_<Stats>(m, "Stats")
+        .def_readonly("iterations", &Stats::iterations, "|#substeps| BCD iterations per substep")
+        .def_readonly(
+            "residuals",
+            &Stats::residuals,
+            "residuals[s][k] is the max vertex gradient norm at BCD iteration k of substep s")
+        .def_readonly(
+            "displacements",
+            &Stats::displacements,
+            "displacements[s][k] is the max vertex displacement at BCD iteration k of substep s")
+        .def_readonly(
+            "evaluations",
+            &Stats::evaluations,
+            "evaluations[s][k] is the number of quad.pt. elastic energy derivative evaluations at "
+            "BCD iteration k of substep s")
+        .def_readonly(
+            "rho",
+            &Stats::rho,
+            "|#substeps| spectral radius used by Chebyshev acceleration, or 0 if not accelerated");
     pyb::class_<Integrator>(m, "Integrator")
         .def(
             pyb::init([](Data& data) { return Integrator(std::move(data)); }),
@@ -31,7 +51,8 @@ void BindIntegrator(pybind11::module& m)
             pyb::arg("iterations"),
             pyb::arg("substeps") = 1,
             pyb::arg("rho")      = ScalarType(1),
-            "Integrate the VBD simulation 1 time step.")
+            "Integrate the VBD simulation 1 time step, running at most iterations BCD iterations "
+            "per substep.")
         .def_property(
             "x",
             [](Integrator const& self) { return self.data.x; },
@@ -59,7 +80,8 @@ void BindIntegrator(pybind11::module& m)
             [](Integrator const& self) { return self.data.detHZero; },
             [](Integrator& self, Scalar detHZero) { self.data.detHZero = detHZero; },
             "Numerical zero used in 'singular' hessian determinant check.")
-        .def_readwrite("data", &Integrator::data);
+        .def_readwrite("data", &Integrator::data)
+        .def_readonly("stats", &Integrator::stats, "Convergence telemetry of the last step");
 }
 
 } // namespace vbd
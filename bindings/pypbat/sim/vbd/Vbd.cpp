@@ -1,5 +1,6 @@
 #include "Vbd.h"
 
+#include "BatchIntegrator.h"
 #include "Data.h"
 #include "Integrator.h"
 
@@ -12,6 +13,7 @@ void Bind(pybind11::module& m)
 {
     BindData(m);
     BindIntegrator(m);
+    BindBatchIntegrator(m);
 }
 
 } // namespace vbd
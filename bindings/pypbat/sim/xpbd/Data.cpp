@@ -0,0 +1,115 @@
+#include "Data.h"
+
+#include <pbat/sim/xpbd/Data.h>
+#include <pbat/sim/xpbd/Enums.h>
+#include <pybind11/eigen.h>
+#include <pybind11/stl.h>
+
+namespace pbat {
+namespace py {
+namespace sim {
+namespace xpbd {
+
+void BindData(pybind11::module& m)
+{
+    namespace pyb = pybind11;
+    using pbat::sim::xpbd::Data;
+    using pbat::sim::xpbd::EConstraint;
+
+    pyb::enum_<EConstraint>(m, "Constraint")
+        .value("StableNeoHookean", EConstraint::StableNeoHookean)
+        .value("Collision", EConstraint::Collision)
+        .export_values();
+
+    pyb::class_<Data>(m, "Data")
+        .def(pyb::init<>())
+        .def(
+            "with_volume_mesh",
+            &Data::WithVolumeMesh,
+            pyb::arg("X"),
+            pyb::arg("T"),
+            "Sets the FEM simulation mesh as array of 3x|#nodes| positions X and 4x|#elements| "
+            "tetrahedral elements T.")
+        .def(
+            "with_surface_mesh",
+            &Data::WithSurfaceMesh,
+            pyb::arg("V"),
+            pyb::arg("F"),
+            "Sets the collision mesh as array of 1x|#collision vertices| indices V into positions "
+            "X and 3x|#collision triangles| indices into X.")
+        .def(
+            "with_bodies",
+            &Data::WithBodies,
+            pyb::arg("B"),
+            "Sets the |#nodes| array of body indices of each node. Contacts are only detected "
+            "between different bodies.")
+        .def(
+            "with_velocity",
+            &Data::WithVelocity,
+            pyb::arg("v"),
+            "Sets the 3x|#nodes| initial velocity field at FEM nodes.")
+        .def(
+            "with_acceleration",
+            &Data::WithAcceleration,
+            pyb::arg("a"),
+            "Sets the 3x|#nodes| external acceleration field at FEM nodes.")
+        .def(
+            "with_mass_inverse",
+            &Data::WithMassInverse,
+            pyb::arg("minv"),
+            "Sets the |#nodes| array of lumped nodal mass inverses.")
+        .def(
+            "with_elastic_material",
+            &Data::WithElasticMaterial,
+            pyb::arg("lame"),
+            "Sets the 2x|#elements| array of Lame coefficients.")
+        .def(
+            "with_compliance",
+            &Data::WithCompliance,
+            pyb::arg("alpha"),
+            pyb::arg("constraint"),
+            "Sets the compliance of the given constraint type, i.e. 2*|#elements| array for "
+            "Stable Neo-Hookean constraints and |#collision vertices| array for collision "
+            "constraints.")
+        .def(
+            "with_friction_coefficients",
+            &Data::WithFrictionCoefficients,
+            pyb::arg("muS"),
+            pyb::arg("muK"),
+            "Sets the static and dynamic Coulomb friction coefficients.")
+        .def(
+            "with_partitions",
+            &Data::WithPartitions,
+            pyb::arg("partitions"),
+            "Sets the independent constraint partitions for solver parallelization.")
+        .def(
+            "with_dirichlet_vertices",
+            &Data::WithDirichletConstrainedVertices,
+            pyb::arg("dbc"),
+            pyb::arg("input_sorted") = true,
+            "Sets Dirichlet constrained vertices.")
+        .def("construct", &Data::Construct, pyb::arg("validate") = true)
+        .def_readwrite("V", &Data::V)
+        .def_readwrite("F", &Data::F)
+        .def_readwrite("T", &Data::T)
+        .def_readwrite("B", &Data::B)
+        .def_readwrite("x", &Data::x)
+        .def_readwrite("v", &Data::v)
+        .def_readwrite("aext", &Data::aext)
+        .def_readwrite("minv", &Data::minv)
+        .def_readwrite("xt", &Data::xt)
+        .def_readwrite("lame", &Data::lame)
+        .def_readwrite("DmInv", &Data::DmInv)
+        .def_readwrite("gammaSNH", &Data::gammaSNH)
+        .def_readwrite("alpha", &Data::alpha)
+        .def_readwrite("lambda", &Data::lambda)
+        .def_readwrite("partitions", &Data::partitions)
+        .def_readwrite("dbc", &Data::dbc)
+        .def_readwrite("muS", &Data::muS)
+        .def_readwrite("muK", &Data::muK);
+}
+
+} // namespace xpbd
+} // namespace sim
+} // namespace py
+} // namespace pbat
@@ -1,21 +1,20 @@
 #include "Xpbd.h"
 
-#include <pbat/profiling/Profiling.h>
-#include <pybind11/eigen.h>
-#include <pybind11/stl.h>
-#include <utility>
+#include "Data.h"
+#include "Integrator.h"
 
 namespace pbat {
 namespace py {
 namespace sim {
 namespace xpbd {
 
-void Bind([[maybe_unused]] pybind11::module& m)
+void Bind(pybind11::module& m)
 {
-    namespace pyb = pybind11;
+    BindData(m);
+    BindIntegrator(m);
 }
 
 } // namespace xpbd
 } // namespace sim
 } // namespace py
-} // namespace pbat
\ No newline at end of file
+} // namespace pbat
@@ -6,6 +6,7 @@
 #include "physics/Physics.h"
 #include "math/Math.h"
 #include "geometry/Geometry.h"
+#include "graph/Graph.h"
 #include "fem/Fem.h"
 #include "common/Common.h"
 
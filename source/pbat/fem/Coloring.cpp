@@ -0,0 +1,42 @@
+#include "Coloring.h"
+
+#include "Mesh.h"
+#include "Tetrahedron.h"
+
+#include <doctest/doctest.h>
+
+TEST_CASE("[fem] Coloring")
+{
+    using namespace pbat;
+
+    // Cube tetrahedral mesh
+    MatrixX V(3, 8);
+    IndexMatrixX C(4, 5);
+    // clang-format off
+    V << 0., 1., 0., 1., 0., 1., 0., 1.,
+         0., 0., 1., 1., 0., 0., 1., 1.,
+         0., 0., 0., 0., 1., 1., 1., 1.;
+    C << 0, 3, 5, 6, 0,
+         1, 2, 4, 7, 5,
+         3, 0, 6, 5, 3,
+         5, 6, 0, 3, 6;
+    // clang-format on
+    using Mesh = fem::Mesh<fem::Tetrahedron<1>, 3>;
+    Mesh const mesh(V, C);
+    auto const nElements = mesh.E.cols();
+
+    // Act
+    auto const colors = fem::ElementColorPartitions(mesh);
+    IndexVectorX visits = IndexVectorX::Zero(nElements);
+    fem::ForEachElementByColor(nElements, colors, [&](Index e) { ++visits(e); });
+
+    // Assert
+    CHECK((visits.array() == 1).all());
+    for (auto const& partition : colors)
+    {
+        IndexVectorX nodeCounts = IndexVectorX::Zero(mesh.X.cols());
+        for (Index e : partition)
+            nodeCounts(mesh.E.col(e)).array() += 1;
+        CHECK_LE(nodeCounts.maxCoeff(), 1);
+    }
+}
@@ -0,0 +1,70 @@
+#ifndef PBAT_FEM_COLORING_H
+#define PBAT_FEM_COLORING_H
+
+#include "Concepts.h"
+#include "pbat/Aliases.h"
+#include "pbat/graph/Adjacency.h"
+#include "pbat/graph/Color.h"
+#include "pbat/profiling/Profiling.h"
+
+#include <tbb/parallel_for.h>
+#include <utility>
+#include <vector>
+
+namespace pbat {
+namespace fem {
+
+/**
+ * @brief Partitions the elements of mesh into colors, such that no 2 elements of the same color
+ * share a node.
+ *
+ * Element-wise scatters into nodal quantities are then race-free within each color.
+ *
+ * @tparam TMesh
+ * @param mesh The finite element mesh
+ * @return |#colors| partitions of element indices
+ */
+template <CMesh TMesh>
+std::vector<std::vector<Index>> ElementColorPartitions(TMesh const& mesh)
+{
+    PBAT_PROFILE_NAMED_SCOPE("pbat.fem.ElementColorPartitions");
+    auto const G   = graph::MeshDualGraph(mesh.E, static_cast<Index>(mesh.X.cols()));
+    auto const ptr = Eigen::Map<IndexVectorX const>(G.outerIndexPtr(), G.outerSize() + 1);
+    auto const adj = Eigen::Map<IndexVectorX const>(G.innerIndexPtr(), G.nonZeros());
+    IndexVectorX const C = graph::GreedyColor(ptr, adj);
+    return graph::ColorPartitions(C);
+}
+
+/**
+ * @brief Calls f(e) for every element e in [0, nElements), in parallel over the elements of each
+ * color, and serially if no colors are given.
+ *
+ * @tparam Func Callable with signature void(Index)
+ * @param nElements Number of elements
+ * @param colors Element color partitions, i.e. see ElementColorPartitions(), or empty
+ * @param f Element-wise function
+ */
+template <class Func>
+void ForEachElementByColor(
+    Index nElements,
+    std::vector<std::vector<Index>> const& colors,
+    Func&& f)
+{
+    if (colors.empty())
+    {
+        for (Index e = 0; e < nElements; ++e)
+            f(e);
+        return;
+    }
+    for (auto const& partition : colors)
+    {
+        tbb::parallel_for(std::size_t{0}, partition.size(), [&](std::size_t k) {
+            f(partition[k]);
+        });
+    }
+}
+
+} // namespace fem
+} // namespace pbat
+
+#endif // PBAT_FEM_COLORING_H
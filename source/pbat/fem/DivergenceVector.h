@@ -2,6 +2,7 @@
 #define PBAT_FEM_DIVERGENCE_VECTOR_H
 
 #include "Concepts.h"
+#include "ShapeFunctions.h"
 
 #include <exception>
 #include <fmt/core.h>
@@ -54,7 +55,8 @@ struct DivergenceVector
                                      ///< jacobian determinants at element quadrature points
     Eigen::Ref<MatrixX const>
         GNe; ///< |ElementType::kNodes|x|kDims * QuadratureRuleType::kPoints * #elements|
-             ///< matrix of element shape function gradients at quadrature points
+             ///< matrix of element shape function gradients at quadrature points, or their
+             ///< compact storage for affine elements (see EShapeFunctionGradientStorage)
     /*
      * div(F) = div(\sum F_i \phi_i) = \sum div(F_i \phi_i) = \sum \sum F_id d(\phi_i) / d(X_d)
      */
@@ -100,15 +102,13 @@ inline void DivergenceVector<TMesh, Dims, QuadratureOrder>::ComputeElementDiverg
     auto const numberOfElements = mesh.E.cols();
     divE.setZero(ElementType::kNodes, numberOfElements);
     auto const wg = common::ToEigen(QuadratureRuleType::weights);
+    ElementShapeFunctionGradients<MeshType, QuadratureOrder> const gradPhiAt(GNe, numberOfElements);
     tbb::parallel_for(Index{0}, Index{numberOfElements}, [&](Index e) {
         auto const nodes = mesh.E.col(e);
         for (auto g = 0; g < QuadratureRuleType::kPoints; ++g)
         {
-            auto constexpr kStride          = MeshType::kDims * QuadratureRuleType::kPoints;
-            auto constexpr kNodesPerElement = ElementType::kNodes;
-            auto const gradPhi =
-                GNe.block<kNodesPerElement, MeshType::kDims>(0, e * kStride + g * MeshType::kDims);
-            auto const F = Fe(Eigen::all, nodes);
+            auto const gradPhi = gradPhiAt(e, g);
+            auto const F       = Fe(Eigen::all, nodes);
             // div(F) = \sum_i \sum_d F_id d(\phi_i) / d(X_d)
             divE.col(e) =
                 (wg(g) * detJe(g, e)) * (F.array().transpose() * gradPhi.array()).rowwise().sum();
@@ -152,23 +152,7 @@ inline void DivergenceVector<TMesh, Dims, QuadratureOrder>::CheckValidState() co
             detJe.cols());
         throw std::invalid_argument(what);
     }
-    auto constexpr kExpectedGNeRows = ElementType::kNodes;
-    auto const expectedGNeCols = MeshType::kDims * QuadratureRuleType::kPoints * numberOfElements;
-    bool const bShapeFunctionGradientsHaveCorrectDimensions =
-        (GNe.rows() == kExpectedGNeRows) and (GNe.cols() == expectedGNeCols);
-    if (not bShapeFunctionGradientsHaveCorrectDimensions)
-    {
-        std::string const what = fmt::format(
-            "Expected shape function gradients at element quadrature points of dimensions "
-            "|#nodes-per-element|={} x |#mesh-dims * #quad.pts. * #elemens|={} for polynomiail "
-            "quadrature order={}, but got {}x{} instead",
-            kExpectedGNeRows,
-            expectedGNeCols,
-            QuadratureOrder,
-            GNe.rows(),
-            GNe.cols());
-        throw std::invalid_argument(what);
-    }
+    ElementShapeFunctionGradients<MeshType, QuadratureOrder>::Storage(GNe, numberOfElements);
 }
 
 } // namespace fem
@@ -1,6 +1,7 @@
 #ifndef PBAT_FEM_FEM_H
 #define PBAT_FEM_FEM_H
 
+#include "Coloring.h"
 #include "Concepts.h"
 #include "DeformationGradient.h"
 #include "DivergenceVector.h"
@@ -11,10 +12,13 @@
 #include "LaplacianMatrix.h"
 #include "Line.h"
 #include "LoadVector.h"
+#include "LumpedMassMatrix.h"
 #include "MassMatrix.h"
 #include "Mesh.h"
+#include "Prolongation.h"
 #include "QuadratureRules.h"
 #include "Quadrilateral.h"
+#include "Reorder.h"
 #include "ShapeFunctions.h"
 #include "Tetrahedron.h"
 #include "Triangle.h"
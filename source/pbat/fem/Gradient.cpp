@@ -54,6 +54,12 @@ TEST_CASE("[fem] Gradient")
         bool const bConstantFunctionHasZeroGradient = gradOnes.isZero(zero);
         CHECK(bConstantFunctionHasZeroGradient);
 
+        // Compact shape function gradients of affine elements yield the same gradient
+        MatrixX const GNeCompact = fem::CompactShapeFunctionGradients(mesh);
+        GradientType const GCompact{mesh, GNeCompact};
+        Scalar const compactError = (GCompact.ToMatrix() - G.ToMatrix()).squaredNorm();
+        CHECK_LE(compactError, zero);
+
         CSCMatrix const GM = G.ToMatrix();
         CHECK_EQ(GM.rows(), m);
         CHECK_EQ(GM.cols(), n);
@@ -40,7 +40,7 @@ struct Gradient
      * @param mesh
      * @param GNe |#element nodes|x|#dims * #quad.pts. * #elements|
                     ///< matrix of element shape function gradients at quadrature points
-     * points
+     * points, or their compact storage for affine elements (see EShapeFunctionGradientStorage)
      */
     Gradient(MeshType const& mesh, Eigen::Ref<MatrixX const> const& GNe);
 
@@ -49,6 +49,8 @@ struct Gradient
     /**
      * @brief Applies the gradient matrix as a linear operator on x, adding result to y.
      *
+     * Columns of x and elements are processed in parallel.
+     *
      * @tparam TDerivedIn
      * @tparam TDerivedOut
      * @param x
@@ -71,7 +73,8 @@ struct Gradient
     MeshType const& mesh; ///< The finite element mesh
     Eigen::Ref<MatrixX const>
         GNe; ///< |#element nodes|x|#dims * #quad.pts. * #elements|
-             ///< matrix of element shape function gradients at quadrature points
+             ///< matrix of element shape function gradients at quadrature points, or their
+             ///< compact storage for affine elements (see EShapeFunctionGradientStorage)
 };
 
 template <CMesh TMesh, int QuadratureOrder>
@@ -89,26 +92,28 @@ inline CSCMatrix Gradient<TMesh, QuadratureOrder>::ToMatrix() const
     using SparseIndex = typename CSCMatrix::StorageIndex;
     using Triplet     = Eigen::Triplet<Scalar, SparseIndex>;
 
-    std::vector<Triplet> triplets{};
-    triplets.reserve(static_cast<std::size_t>(GNe.size()));
     auto const numberOfElements                = mesh.E.cols();
     auto constexpr kNodesPerElement            = ElementType::kNodes;
     auto constexpr kQuadPts                    = QuadratureRuleType::kPoints;
     auto const numberOfElementQuadraturePoints = numberOfElements * kQuadPts;
+    std::vector<Triplet> triplets{};
+    triplets.reserve(
+        static_cast<std::size_t>(kNodesPerElement * kDims * numberOfElementQuadraturePoints));
+    ElementShapeFunctionGradients<MeshType, QuadratureOrder> const gradPhiAt(GNe, numberOfElements);
     for (auto e = 0; e < numberOfElements; ++e)
     {
         auto const nodes = mesh.E.col(e);
-        auto const Ge    = GNe.block<kNodesPerElement, kQuadPts * kDims>(0, e * kQuadPts * kDims);
-        for (auto d = 0; d < kDims; ++d)
+        for (auto g = 0; g < kQuadPts; ++g)
         {
-            for (auto g = 0; g < kQuadPts; ++g)
+            auto const gradPhi = gradPhiAt(e, g);
+            for (auto d = 0; d < kDims; ++d)
             {
                 for (auto j = 0; j < kNodesPerElement; ++j)
                 {
                     auto const ni = static_cast<SparseIndex>(
                         d * numberOfElementQuadraturePoints + e * kQuadPts + g);
                     auto const nj = static_cast<SparseIndex>(nodes(j));
-                    triplets.push_back(Triplet(ni, nj, Ge(j, g * kDims + d)));
+                    triplets.push_back(Triplet(ni, nj, gradPhi(j, d)));
                 }
             }
         }
@@ -121,25 +126,8 @@ inline CSCMatrix Gradient<TMesh, QuadratureOrder>::ToMatrix() const
 template <CMesh TMesh, int QuadratureOrder>
 inline void Gradient<TMesh, QuadratureOrder>::CheckValidState() const
 {
-    auto constexpr kQuadPts         = QuadratureRuleType::kPoints;
-    auto const numberOfElements     = mesh.E.cols();
-    auto constexpr kExpectedGNeRows = ElementType::kNodes;
-    auto const expectedGNeCols      = kDims * kQuadPts * numberOfElements;
-    bool const bShapeFunctionGradientsHaveCorrectDimensions =
-        (GNe.rows() == kExpectedGNeRows) and (GNe.cols() == expectedGNeCols);
-    if (not bShapeFunctionGradientsHaveCorrectDimensions)
-    {
-        std::string const what = fmt::format(
-            "Expected shape function gradients at element quadrature points of dimensions "
-            "|#nodes-per-element|={} x |#mesh-dims * #quad.pts. * #elemens|={} for polynomiail "
-            "quadrature order={}, but got {}x{} instead",
-            kExpectedGNeRows,
-            expectedGNeCols,
-            QuadratureOrder,
-            GNe.rows(),
-            GNe.cols());
-        throw std::invalid_argument(what);
-    }
+    auto const numberOfElements = mesh.E.cols();
+    ElementShapeFunctionGradients<MeshType, QuadratureOrder>::Storage(GNe, numberOfElements);
 }
 
 template <CMesh TMesh, int QuadratureOrder>
@@ -167,30 +155,28 @@ inline void Gradient<TMesh, QuadratureOrder>::Apply(
         throw std::invalid_argument(what);
     }
     // Compute gradient
-    auto constexpr kNodesPerElement = ElementType::kNodes;
-    auto constexpr kQuadPts         = QuadratureRuleType::kPoints;
-    auto const numberOfElements     = mesh.E.cols();
-    for (auto c = 0; c < x.cols(); ++c)
-    {
-        for (auto e = 0; e < numberOfElements; ++e)
-        {
+    auto constexpr kQuadPts     = QuadratureRuleType::kPoints;
+    auto const numberOfElements = mesh.E.cols();
+    ElementShapeFunctionGradients<MeshType, QuadratureOrder> const gradPhiAt(GNe, numberOfElements);
+    // NOTE: Each element only writes to its own quadrature points, so elements need no coloring
+    tbb::parallel_for(Index{0}, Index{x.cols()}, [&](Index c) {
+        tbb::parallel_for(Index{0}, Index{numberOfElements}, [&](Index e) {
             auto const nodes = mesh.E.col(e);
             auto const xe    = x.col(c)(nodes);
-            auto const Ge = GNe.block<kNodesPerElement, kDims * kQuadPts>(0, e * kQuadPts * kDims);
-            for (auto d = 0; d < kDims; ++d)
+            for (auto g = 0; g < kQuadPts; ++g)
             {
-                auto ye =
-                    y.col(c).segment(d * numberOfElements * kQuadPts + e * kQuadPts, kQuadPts);
-                for (auto g = 0; g < kQuadPts; ++g)
+                auto const gradPhi = gradPhiAt(e, g);
+                for (auto d = 0; d < kDims; ++d)
                 {
+                    auto const k = d * numberOfElements * kQuadPts + e * kQuadPts + g;
                     for (auto i = 0; i < nodes.size(); ++i)
                     {
-                        ye(g) += Ge(i, d + g * kDims) * xe(i);
+                        y(k, c) += gradPhi(i, d) * xe(i);
                     }
                 }
             }
-        }
-    }
+        });
+    });
 }
 
 } // namespace fem
@@ -66,6 +66,13 @@ TEST_CASE("[fem] HyperElasticPotential")
             (eigs.info() == Eigen::ComputationInfo::Success) and (minEigenValue > -zero);
         CHECK(bIsPositiveSemiDefinite);
 
+        // Compact shape function gradients of affine elements yield the same hessian
+        MatrixX const GNeCompact = fem::CompactShapeFunctionGradients(M);
+        ElasticPotentialType const UCompact(M, detJe, GNeCompact, x, Y, nu);
+        Scalar const compactError =
+            (UCompact.ToMatrix() - HMaterial).squaredNorm() / HMaterial.squaredNorm();
+        CHECK_LE(compactError, zero);
+
         // Elastic energy is invariant to translations
         Scalar constexpr t = 2.;
         U.ComputeElementElasticity(VectorX{x.array() + t});
@@ -91,5 +98,140 @@ TEST_CASE("[fem] HyperElasticPotential")
         U.Apply(k * x + x, y);
         Scalar const linearityError = (y - yExpected).norm() / yExpected.norm();
         CHECK_LE(linearityError, zero);
+
+        // Colored parallel application matches serial application, also on many columns
+        MatrixX const Xin = MatrixX::Random(x.size(), 3);
+        MatrixX Yout      = MatrixX::Zero(x.size(), 3);
+        U.PrecomputeElementColoring();
+        U.Apply(Xin, Yout);
+        Scalar const coloredApplyError = (Yout - HMaterial * Xin).norm() / (HMaterial * Xin).norm();
+        CHECK_LE(coloredApplyError, zero);
+
+        // In-place hessian assembly matches fresh assembly
+        U.PrecomputeHessianSparsity();
+        CSCMatrix HInPlace{};
+        U.ToMatrix(HInPlace);
+        U.ComputeElementElasticity(x);
+        U.ToMatrix(HInPlace);
+        Scalar const inPlaceError = (HInPlace - HMaterial).squaredNorm() / HMaterial.squaredNorm();
+        CHECK_LE(inPlaceError, zero);
+
+        // Recomputing only the elements of moved nodes matches full recomputation
+        VectorX xMoved = x;
+        std::vector<Index> const movedNodes{{0, 7}};
+        for (Index i : movedNodes)
+            xMoved.segment<kDims>(kDims * i).array() += 0.1;
+        std::vector<Index> const movedElements = U.ElementsOfNodes(movedNodes);
+        U.PrecomputeNodeElementAdjacency();
+        CHECK_EQ(U.ElementsOfNodes(movedNodes), movedElements);
+        U.ComputeElementElasticity(xMoved, movedElements);
+        U.ToMatrix(movedElements, HInPlace);
+        ElasticPotentialType const UMoved(M, detJe, GNe, xMoved, Y, nu);
+        CSCMatrix const HMoved        = UMoved.ToMatrix();
+        Scalar const incrementalError = std::abs(U.Eval() - UMoved.Eval()) / UMoved.Eval();
+        CHECK_LE(incrementalError, zero);
+        Scalar const incrementalGradientError =
+            (U.ToVector() - UMoved.ToVector()).norm() / UMoved.ToVector().norm();
+        CHECK_LE(incrementalGradientError, zero);
+        Scalar const incrementalHessianError =
+            (HInPlace - HMoved).squaredNorm() / HMoved.squaredNorm();
+        CHECK_LE(incrementalHessianError, zero);
+        U.ComputeElementElasticity(x);
+
+        // Block sparse hessian matches scalar sparse hessian
+        auto HBlock = U.ToBlockMatrix();
+        CHECK_EQ(HBlock.NumberOfNonZeroBlocks() * kDims * kDims, HMaterial.nonZeros());
+        Scalar const blockError =
+            (HBlock.ToMatrix() - HMaterial).squaredNorm() / HMaterial.squaredNorm();
+        CHECK_LE(blockError, zero);
+        U.PrecomputeHessianBlockSparsity();
+        U.ToBlockMatrix(HBlock);
+        VectorX yBlock = VectorX::Zero(x.size());
+        HBlock.Apply(x, yBlock);
+        Scalar const blockApplyError = (yBlock - HMaterial * x).norm() / (HMaterial * x).norm();
+        CHECK_LE(blockApplyError, zero);
+
+        // Packed upper triangular element hessians represent the same hessian
+        auto constexpr kDofsPerElement = ElementType::kNodes * kDims;
+        U.SetHessianStorage(fem::EHessianStorage::PackedUpper);
+        CHECK_EQ(U.He.size(), kDofsPerElement * (kDofsPerElement + 1) / 2 * M.E.cols());
+        Scalar const packedError =
+            (U.ToMatrix() - HMaterial).squaredNorm() / HMaterial.squaredNorm();
+        CHECK_LE(packedError, zero);
+        VectorX yPacked = VectorX::Zero(x.size());
+        U.Apply(x, yPacked);
+        Scalar const packedApplyError = (yPacked - HMaterial * x).norm() / (HMaterial * x).norm();
+        CHECK_LE(packedApplyError, zero);
+        U.ComputeElementElasticity(x);
+        Scalar const packedBlockError =
+            (U.ToBlockMatrix().ToMatrix() - HMaterial).squaredNorm() / HMaterial.squaredNorm();
+        CHECK_LE(packedBlockError, zero);
+        U.SetHessianStorage(fem::EHessianStorage::Full);
+        Scalar const unpackedError =
+            (U.ToMatrix() - HMaterial).squaredNorm() / HMaterial.squaredNorm();
+        CHECK_LE(unpackedError, zero);
+
+        // Quadrature point hessians w.r.t. F represent the same hessian, matrix-free
+        U.SetHessianStorage(fem::EHessianStorage::QuadraturePoint);
+        U.ComputeElementElasticity(x);
+        CHECK_EQ(U.He.size(), kDims * kDims * kDims * kDims * QuadratureType::kPoints * M.E.cols());
+        VectorX yQuadraturePoint = VectorX::Zero(x.size());
+        U.Apply(x, yQuadraturePoint);
+        Scalar const quadraturePointApplyError =
+            (yQuadraturePoint - HMaterial * x).norm() / (HMaterial * x).norm();
+        CHECK_LE(quadraturePointApplyError, zero);
+        Scalar const quadraturePointError =
+            (U.ToMatrix() - HMaterial).squaredNorm() / HMaterial.squaredNorm();
+        CHECK_LE(quadraturePointError, zero);
+        Scalar const quadraturePointBlockError =
+            (U.ToBlockMatrix().ToMatrix() - HMaterial).squaredNorm() / HMaterial.squaredNorm();
+        CHECK_LE(quadraturePointBlockError, zero);
+        CHECK_THROWS_AS(
+            U.ComputeElementElasticity(x, true, true, true, fem::EHessianProjection::Element),
+            std::invalid_argument);
+        U.SetHessianStorage(fem::EHessianStorage::Full);
+        Scalar const contractedError =
+            (U.ToMatrix() - HMaterial).squaredNorm() / HMaterial.squaredNorm();
+        CHECK_LE(contractedError, zero);
+
+        // Hessian diagonal and diagonal node blocks match the assembled hessian
+        VectorX const HDiagonal    = HMaterial.diagonal();
+        Scalar const diagonalError = (U.Diagonal() - HDiagonal).norm() / HDiagonal.norm();
+        CHECK_LE(diagonalError, zero);
+        MatrixX const HBlockDiagonal = U.BlockDiagonal();
+        MatrixX const HDense         = HMaterial;
+        Scalar blockDiagonalError{0.};
+        for (auto i = 0; i < M.X.cols(); ++i)
+            blockDiagonalError += (HBlockDiagonal.block<kDims, kDims>(0, kDims * i) -
+                                   HDense.block<kDims, kDims>(kDims * i, kDims * i))
+                                      .squaredNorm();
+        CHECK_LE(blockDiagonalError / HMaterial.squaredNorm(), zero);
+
+        // Projected hessians of (partially inverted) deformed configurations are positive
+        // semi-definite, whether projected at quadrature points or at elements
+        std::srand(0);
+        VectorX const xDeformed = x + VectorX::Random(x.size());
+        for (auto eStorage :
+             {fem::EHessianStorage::Full,
+              fem::EHessianStorage::PackedUpper,
+              fem::EHessianStorage::QuadraturePoint})
+        {
+            U.SetHessianStorage(eStorage);
+            for (auto eProjection :
+                 {fem::EHessianProjection::QuadraturePoint, fem::EHessianProjection::Element})
+            {
+                bool const bIsProjectionSupported =
+                    (eStorage != fem::EHessianStorage::QuadraturePoint) or
+                    (eProjection == fem::EHessianProjection::QuadraturePoint);
+                if (not bIsProjectionSupported)
+                    continue;
+                U.ComputeElementElasticity(xDeformed, true, true, true, eProjection);
+                CSCMatrix const HProjected = U.ToMatrix();
+                Eigen::SelfAdjointEigenSolver<CSCMatrix> projectedEigs(HProjected);
+                Scalar const minProjectedEigenValue = projectedEigs.eigenvalues().minCoeff() /
+                                                      projectedEigs.eigenvalues().maxCoeff();
+                CHECK_GT(minProjectedEigenValue, -zero);
+            }
+        }
     });
 }
@@ -1,26 +1,61 @@
 #ifndef PBA_FEM_HYPER_ELASTIC_POTENTIAL_H
 #define PBA_FEM_HYPER_ELASTIC_POTENTIAL_H
 
+#include "Coloring.h"
 #include "Concepts.h"
 #include "DeformationGradient.h"
+#include "ShapeFunctions.h"
 #include "pbat/Aliases.h"
+#include "pbat/common/Concepts.h"
 #include "pbat/common/Eigen.h"
+#include "pbat/graph/Adjacency.h"
+#include "pbat/math/linalg/BlockSparseMatrix.h"
+#include "pbat/math/linalg/BlockSparsityPattern.h"
 #include "pbat/math/linalg/SparsityPattern.h"
 #include "pbat/math/linalg/mini/Eigen.h"
 #include "pbat/math/linalg/mini/Product.h"
 #include "pbat/physics/HyperElasticity.h"
+#include "pbat/physics/SpdProjection.h"
 #include "pbat/profiling/Profiling.h"
 
-#include <Eigen/SVD>
+#include <Eigen/Eigenvalues>
+#include <algorithm>
 #include <exception>
 #include <fmt/core.h>
+#include <ranges>
 #include <span>
 #include <string>
 #include <tbb/parallel_for.h>
+#include <tbb/parallel_sort.h>
+#include <utility>
+#include <vector>
 
 namespace pbat {
 namespace fem {
 
+/**
+ * @brief Level at which hessians are projected to a positive semi-definite state
+ *
+ * ComputeElementElasticity() defaults to QuadraturePoint, whereas it used to project element
+ * hessians. Use Element to recover the previous per-element projection.
+ */
+enum class EHessianProjection {
+    Element,        ///< Eigen decomposition of each |#nodes*kDims|^2 element hessian
+    QuadraturePoint ///< Projection of each |kDims^2|^2 hessian w.r.t. F before contraction with
+                    ///< shape function gradients, using closed-form eigensystems if available
+};
+
+/**
+ * @brief Storage layout of element hessians
+ */
+enum class EHessianStorage {
+    Full,           ///< |#element dofs| x |#element dofs * #elements| dense element hessians
+    PackedUpper,    ///< |#element dofs * (#element dofs + 1) / 2| x |#elements| column-major
+                    ///< packed upper triangles of (symmetric) element hessians
+    QuadraturePoint ///< |kDims^4| x |#quad.pts. * #elements| quadrature weighted hessians w.r.t. F,
+                    ///< contracted with shape function gradients on the fly (matrix-free)
+};
+
 template <CMesh TMesh, physics::CHyperElasticEnergy THyperElasticEnergy, int QuadratureOrder>
 struct HyperElasticPotential
 {
@@ -30,6 +65,11 @@ struct HyperElasticPotential
     using ElementType        = typename TMesh::ElementType;
     using ElasticEnergyType  = THyperElasticEnergy;
     using QuadratureRuleType = typename ElementType::template QuadratureType<QuadratureOrder>;
+    using ElementHessianType       = Matrix<
+        ElementType::kNodes * THyperElasticEnergy::kDims,
+        ElementType::kNodes * THyperElasticEnergy::kDims>;
+    using BlockSparseMatrixType    = math::linalg::BlockSparseMatrix<THyperElasticEnergy::kDims>;
+    using BlockSparsityPatternType = math::linalg::BlockSparsityPattern<THyperElasticEnergy::kDims>;
     static_assert(
         MeshType::kDims == ElasticEnergyType::kDims,
         "Embedding dimensions of mesh must match dimensionality of hyper elastic energy.");
@@ -75,17 +115,142 @@ struct HyperElasticPotential
 
     void PrecomputeHessianSparsity();
 
+    /**
+     * @brief Computes the kDims x kDims block sparsity pattern of the hessian, whose blocks
+     * couple pairs of nodes.
+     * @return
+     */
+    BlockSparsityPatternType HessianBlockSparsity() const;
+
+    /**
+     * @brief Stores HessianBlockSparsity() for reusable and efficient block hessian construction
+     */
+    void PrecomputeHessianBlockSparsity();
+
+    /**
+     * @brief Partitions elements into colors, such that Apply() scatters element hessian products
+     * in parallel.
+     */
+    void PrecomputeElementColoring();
+
+    /**
+     * @brief Stores the node-element adjacency for efficient ElementsOfNodes() queries
+     */
+    void PrecomputeNodeElementAdjacency();
+
+    /**
+     * @brief Computes the elements incident to the given nodes, i.e. the elements whose elasticity
+     * changes when these nodes move.
+     *
+     * Runs in time proportional to the number of incident elements if the node-element adjacency
+     * has been precomputed (see PrecomputeNodeElementAdjacency()), and proportional to the mesh
+     * size otherwise.
+     *
+     * @tparam TNodeRange
+     * @param nodes Node indices
+     * @return Sorted distinct element indices
+     */
+    template <common::CIndexRange TNodeRange>
+    std::vector<Index> ElementsOfNodes(TNodeRange&& nodes) const;
+
+    /**
+     * @brief Computes element elastic potentials, and optionally their gradients and hessians
+     *
+     * @tparam TDerived
+     * @param x |#nodes*kDims| generalized coordinates
+     * @param bWithGradient Compute element gradients Ge
+     * @param bWithHessian Compute element hessians He
+     * @param bUseSpdProjection Project hessians to a positive semi-definite state
+     * @param eProjection Level at which hessians are projected, if bUseSpdProjection is true.
+     * The default changed from element to quadrature point projection, which yields different
+     * hessians. Pass EHessianProjection::Element for the previous per-element behaviour.
+     */
     template <class TDerived>
     void ComputeElementElasticity(
         Eigen::MatrixBase<TDerived> const& x,
-        bool bWithGradient     = true,
-        bool bWithHessian      = true,
-        bool bUseSpdProjection = true);
+        bool bWithGradient             = true,
+        bool bWithHessian              = true,
+        bool bUseSpdProjection         = true,
+        EHessianProjection eProjection = EHessianProjection::QuadraturePoint);
+
+    /**
+     * @brief Recomputes element elastic potentials, and optionally their gradients and hessians,
+     * of the given elements only, leaving other elements untouched.
+     *
+     * Together with ElementsOfNodes() and ToMatrix(elements, H), local changes to x are processed
+     * in time proportional to the change.
+     *
+     * @tparam TDerived
+     * @tparam TElementRange
+     * @param x |#nodes*kDims| generalized coordinates
+     * @param elements Distinct indices of elements to recompute
+     * @param bWithGradient Compute element gradients Ge
+     * @param bWithHessian Compute element hessians He
+     * @param bUseSpdProjection Project hessians to a positive semi-definite state
+     * @param eProjection Level at which hessians are projected, if bUseSpdProjection is true.
+     * Defaults to quadrature point projection (see EHessianProjection).
+     */
+    template <class TDerived, common::CIndexRange TElementRange>
+    void ComputeElementElasticity(
+        Eigen::MatrixBase<TDerived> const& x,
+        TElementRange&& elements,
+        bool bWithGradient             = true,
+        bool bWithHessian              = true,
+        bool bUseSpdProjection         = true,
+        EHessianProjection eProjection = EHessianProjection::QuadraturePoint);
+
+    /**
+     * @brief Changes the storage layout of element hessians He, converting existing hessians.
+     *
+     * Packed upper triangular storage nearly halves hessian memory and bandwidth. Quadrature point
+     * storage reduces hessian memory to |kDims^4| per quadrature point, independently of the
+     * element's number of nodes, at the cost of recomputing element hessians in Apply(). Element
+     * hessians cannot be converted to quadrature point hessians, so He is zeroed when switching to
+     * quadrature point storage, and must be recomputed by ComputeElementElasticity().
+     *
+     * @param eStorage Element hessian storage layout
+     */
+    void SetHessianStorage(EHessianStorage eStorage);
+
+    /**
+     * @brief Unpacks the hessian of element e, regardless of the storage layout
+     * @param e Element index
+     * @return
+     */
+    ElementHessianType ElementHessian(Index e) const;
+
+    /**
+     * @brief Unpacks all element hessians, regardless of the storage layout
+     * @return |#element dofs| x |#element dofs * #elements| dense element hessians
+     */
+    MatrixX ElementHessians() const;
+
+    /**
+     * @brief Stores the (symmetric) hessian of element e, for element-wise storage layouts
+     * @param e Element index
+     * @param he Element hessian
+     */
+    void SetElementHessian(Index e, ElementHessianType const& he);
+
+    /**
+     * @brief Coefficient (i,j) of the hessian of element e, regardless of the storage layout
+     *
+     * For quadrature point storage, the whole element hessian is computed.
+     *
+     * @param e Element index
+     * @param i Local row dof
+     * @param j Local column dof
+     * @return
+     */
+    Scalar ElementHessianCoeff(Index e, Index i, Index j) const;
 
     /**
      * @brief Applies the hessian matrix of this potential as a linear operator on x, adding result
      * to y.
      *
+     * Columns of x are processed in parallel. Elements are processed in parallel if the element
+     * coloring has been precomputed (see PrecomputeElementColoring()), and serially otherwise.
+     *
      * @tparam TDerivedIn
      * @tparam TDerivedOut
      * @param x
@@ -101,6 +266,82 @@ struct HyperElasticPotential
      */
     CSCMatrix ToMatrix() const;
 
+    /**
+     * @brief Writes this matrix-free hessian matrix representation into H, reusing its storage.
+     *
+     * If the hessian sparsity has been precomputed (see PrecomputeHessianSparsity()) and H is
+     * non-empty, H must have the hessian's sparsity pattern, e.g. H was returned by ToMatrix(), and
+     * only H's values are overwritten, in parallel. Otherwise, H is reassigned to ToMatrix().
+     *
+     * @param H Sparse compressed hessian
+     */
+    void ToMatrix(CSCMatrix& H) const;
+
+    /**
+     * @brief Overwrites only the non-zeros of H coupling nodes of the given elements, e.g. after
+     * ComputeElementElasticity(x, elements), in time proportional to the number of elements.
+     *
+     * Requires the precomputed hessian sparsity (see PrecomputeHessianSparsity()), and H must have
+     * the hessian's sparsity pattern, e.g. H was returned by ToMatrix().
+     *
+     * @tparam TElementRange
+     * @param elements Indices of elements whose hessians changed
+     * @param H Sparse compressed hessian
+     */
+    template <common::CIndexRange TElementRange>
+    void ToMatrix(TElementRange&& elements, CSCMatrix& H) const;
+
+    /**
+     * @brief Calls f(nonZeros), where nonZeros are the element hessians' coefficients in the
+     * order of the non-zeros of the hessian sparsity (see PrecomputeHessianSparsity()), regardless
+     * of the storage layout.
+     *
+     * @tparam Func Callable with signature void(CArithmeticRange)
+     * @param f Consumer of element hessian non-zeros
+     */
+    template <class Func>
+    void VisitHessianNonZeros(Func&& f) const;
+
+    /**
+     * @brief Transforms this matrix-free hessian matrix representation into block compressed
+     * sparse row format with kDims x kDims blocks.
+     * @return
+     */
+    BlockSparseMatrixType ToBlockMatrix() const;
+
+    /**
+     * @brief Writes this matrix-free hessian matrix representation into the block sparse matrix H,
+     * reusing its storage.
+     *
+     * If the hessian block sparsity has been precomputed (see PrecomputeHessianBlockSparsity()) and
+     * H is non-empty, H must have the hessian's block sparsity pattern, and only H's blocks are
+     * overwritten, in parallel. Otherwise, H is reassigned to ToBlockMatrix().
+     *
+     * @param H Block sparse hessian
+     */
+    void ToBlockMatrix(BlockSparseMatrixType& H) const;
+
+    /**
+     * @brief Computes the diagonal of the hessian, e.g. for Jacobi preconditioning.
+     *
+     * Elements are processed in parallel if the element coloring has been precomputed (see
+     * PrecomputeElementColoring()), and serially otherwise.
+     *
+     * @return |kDims * #nodes| hessian diagonal
+     */
+    VectorX Diagonal() const;
+
+    /**
+     * @brief Computes the kDims x kDims diagonal node blocks of the hessian, e.g. for block Jacobi
+     * preconditioning.
+     *
+     * Elements are processed in parallel if the element coloring has been precomputed (see
+     * PrecomputeElementColoring()), and serially otherwise.
+     *
+     * @return |kDims| x |kDims * #nodes| hessian diagonal blocks
+     */
+    MatrixX BlockDiagonal() const;
+
     /**
      * @brief Transforms this element-wise gradient representation into the global gradient.
      * @return
@@ -121,17 +362,26 @@ struct HyperElasticPotential
     MeshType const& mesh; ///< The finite element mesh
     Eigen::Ref<MatrixX const>
         GNe; ///< |ElementType::kNodes| x |MeshType::kDims * # element quadrature points *
-             ///< #elements| element shape function gradients
+             ///< #elements| element shape function gradients, or their compact storage for
+             ///< affine elements (see EShapeFunctionGradientStorage)
     Eigen::Ref<MatrixX const> detJe; ///< |# element quadrature points| x |#elements| matrix of
                                      ///< jacobian determinants at element quadrature points
 
     MatrixX mue;     ///< |#quad.pts.|x|#elements| 1st Lame coefficient
     MatrixX lambdae; ///< |#quad.pts.|x|#elements| 2nd Lame coefficient
     MatrixX He;      ///< |(ElementType::kNodes*kDims)| x |#elements *
-                     ///< (ElementType::kNodes*kDims)| element hessian matrices
+                     ///< (ElementType::kNodes*kDims)| element hessian matrices, packed upper
+                     ///< triangles of element hessians, or quadrature point hessians w.r.t. F
+                     ///< (see EHessianStorage)
     MatrixX Ge;      ///< |ElementType::kNodes*kDims| x |#elements| element gradient vectors
     VectorX Ue;      ///< |#elements| x 1 element elastic potentials
+    EHessianStorage eHessianStorage{EHessianStorage::Full}; ///< Layout of element hessians He
     math::linalg::SparsityPattern GH; ///< Directed adjacency graph of hessian
+    BlockSparsityPatternType GHB;     ///< Directed adjacency graph of hessian's node blocks
+    graph::AdjacencyMatrix<Index>
+        NE; ///< |#elements| x |#nodes| adjacency, i.e. column i lists the elements of node i
+    std::vector<std::vector<Index>>
+        colors; ///< Element color partitions, such that elements of the same color share no node
 };
 
 template <CMesh TMesh, physics::CHyperElasticEnergy THyperElasticEnergy, int QuadratureOrder>
@@ -158,7 +408,19 @@ inline HyperElasticPotential<TMesh, THyperElasticEnergy, QuadratureOrder>::Hyper
     Eigen::Ref<MatrixX const> const& GNe,
     Eigen::DenseBase<TDerivedY> const& Y,
     Eigen::DenseBase<TDerivednu> const& nu)
-    : mesh(meshIn), detJe(detJe), GNe(GNe), mue(), lambdae(), He(), Ge(), Ue(), GH()
+    : mesh(meshIn),
+      detJe(detJe),
+      GNe(GNe),
+      mue(),
+      lambdae(),
+      He(),
+      Ge(),
+      Ue(),
+      eHessianStorage(EHessianStorage::Full),
+      GH(),
+      GHB(),
+      NE(),
+      colors()
 {
     std::tie(mue, lambdae)            = physics::LameCoefficients(Y.reshaped(), nu.reshaped());
     auto const numberOfElements       = mesh.E.cols();
@@ -212,13 +474,34 @@ HyperElasticPotential<TMesh, THyperElasticEnergy, QuadratureOrder>::ComputeEleme
     Eigen::MatrixBase<TDerived> const& x,
     bool bWithGradient,
     bool bWithHessian,
-    bool bUseSpdProjection)
+    bool bUseSpdProjection,
+    EHessianProjection eProjection)
 {
     PBAT_PROFILE_NAMED_SCOPE("pbat.fem.HyperElasticPotential.ComputeElementElasticity");
+    ComputeElementElasticity(
+        x,
+        std::views::iota(Index{0}, Index{mesh.E.cols()}),
+        bWithGradient,
+        bWithHessian,
+        bUseSpdProjection,
+        eProjection);
+}
+
+template <CMesh TMesh, physics::CHyperElasticEnergy THyperElasticEnergy, int QuadratureOrder>
+template <class TDerived, common::CIndexRange TElementRange>
+inline void
+HyperElasticPotential<TMesh, THyperElasticEnergy, QuadratureOrder>::ComputeElementElasticity(
+    Eigen::MatrixBase<TDerived> const& x,
+    TElementRange&& elements,
+    bool bWithGradient,
+    bool bWithHessian,
+    bool bUseSpdProjection,
+    EHessianProjection eProjection)
+{
+    PBAT_PROFILE_NAMED_SCOPE("pbat.fem.HyperElasticPotential.ComputeElementElasticitySubset");
     // Check inputs
     CheckValidState();
-    auto const numberOfElements = mesh.E.cols();
-    auto const numberOfNodes    = mesh.X.cols();
+    auto const numberOfNodes = mesh.X.cols();
     if (x.size() != numberOfNodes * kDims)
     {
         std::string const what = fmt::format(
@@ -228,33 +511,47 @@ HyperElasticPotential<TMesh, THyperElasticEnergy, QuadratureOrder>::ComputeEleme
             x.size());
         throw std::invalid_argument(what);
     }
-
-    Ue.setZero();
-    if (bWithGradient)
-        Ge.setZero();
-    if (bWithHessian)
-        He.setZero();
+    bool const bProjectQuadraturePoints =
+        bUseSpdProjection and (eProjection == EHessianProjection::QuadraturePoint);
+    bool const bProjectElements =
+        bUseSpdProjection and (eProjection == EHessianProjection::Element);
+    bool const bStoreQuadraturePointHessians =
+        (eHessianStorage == EHessianStorage::QuadraturePoint);
+    if (bWithHessian and bProjectElements and bStoreQuadraturePointHessians)
+    {
+        throw std::invalid_argument(
+            "Element hessians cannot be projected when storing quadrature point hessians, use "
+            "EHessianProjection::QuadraturePoint instead");
+    }
 
     ElasticEnergyType Psi{};
+    // Element quantities are overwritten, such that elements outside the range are untouched
+    auto const numberOfElementsToCompute = static_cast<Index>(std::ranges::size(elements));
+    auto const eBegin                    = std::ranges::begin(elements);
+    auto const forEachElement            = [&](auto&& f) {
+        tbb::parallel_for(Index{0}, numberOfElementsToCompute, [&](Index i) {
+            f(static_cast<Index>(eBegin[i]));
+        });
+    };
+    ElementShapeFunctionGradients<MeshType, QuadratureOrder> const gradPhiAt(GNe, mesh.E.cols());
 
     // Compute element elastic energies and their derivatives
     auto constexpr kNodesPerElement = ElementType::kNodes;
     auto constexpr kDofsPerElement  = kNodesPerElement * kDims;
+    auto constexpr kStressDims      = kDims * kDims;
     auto const wg                   = common::ToEigen(QuadratureRuleType::weights);
     namespace mini                  = math::linalg::mini;
     using mini::FromEigen;
     using mini::ToEigen;
     if (not bWithGradient and not bWithHessian)
     {
-        tbb::parallel_for(Index{0}, Index{numberOfElements}, [&](Index e) {
+        forEachElement([&](Index e) {
             auto const nodes = mesh.E.col(e);
             auto const xe    = x.reshaped(kDims, numberOfNodes)(Eigen::all, nodes);
+            Ue(e)            = Scalar(0);
             for (auto g = 0; g < QuadratureRuleType::kPoints; ++g)
             {
-                auto constexpr kStride = MeshType::kDims * QuadratureRuleType::kPoints;
-                auto const gradPhi     = GNe.block<kNodesPerElement, MeshType::kDims>(
-                    0,
-                    e * kStride + g * MeshType::kDims);
+                auto const gradPhi = gradPhiAt(e, g);
                 Matrix<kDims, kDims> const F = xe * gradPhi;
                 auto vecF                    = FromEigen(F);
                 auto psiF                    = Psi.eval(vecF, mue(g, e), lambdae(g, e));
@@ -264,16 +561,15 @@ HyperElasticPotential<TMesh, THyperElasticEnergy, QuadratureOrder>::ComputeEleme
     }
     else if (bWithGradient and not bWithHessian)
     {
-        tbb::parallel_for(Index{0}, Index{numberOfElements}, [&](Index e) {
+        forEachElement([&](Index e) {
             auto const nodes = mesh.E.col(e);
             auto const xe    = x.reshaped(kDims, numberOfNodes)(Eigen::all, nodes);
             auto ge          = Ge.col(e);
+            Ue(e)            = Scalar(0);
+            ge.setZero();
             for (auto g = 0; g < QuadratureRuleType::kPoints; ++g)
             {
-                auto constexpr kStride = MeshType::kDims * QuadratureRuleType::kPoints;
-                auto const gradPhi     = GNe.block<kNodesPerElement, MeshType::kDims>(
-                    0,
-                    e * kStride + g * MeshType::kDims);
+                auto const gradPhi = gradPhiAt(e, g);
                 Matrix<kDims, kDims> const F = xe * gradPhi;
                 auto vecF                    = FromEigen(F);
                 mini::SVector<Scalar, kDims * kDims> gradPsiF;
@@ -287,69 +583,93 @@ HyperElasticPotential<TMesh, THyperElasticEnergy, QuadratureOrder>::ComputeEleme
     }
     else if (not bWithGradient and bWithHessian)
     {
-        tbb::parallel_for(Index{0}, Index{numberOfElements}, [&](Index e) {
-            auto const nodes = mesh.E.col(e);
-            auto const xe    = x.reshaped(kDims, numberOfNodes)(Eigen::all, nodes);
-            auto he          = He.block<kDofsPerElement, kDofsPerElement>(0, e * kDofsPerElement);
+        forEachElement([&](Index e) {
+            auto const nodes      = mesh.E.col(e);
+            auto const xe         = x.reshaped(kDims, numberOfNodes)(Eigen::all, nodes);
+            ElementHessianType he = ElementHessianType::Zero();
+            Ue(e)                 = Scalar(0);
             for (auto g = 0; g < QuadratureRuleType::kPoints; ++g)
             {
-                auto constexpr kStride = MeshType::kDims * QuadratureRuleType::kPoints;
-                auto const gradPhi     = GNe.block<kNodesPerElement, MeshType::kDims>(
-                    0,
-                    e * kStride + g * MeshType::kDims);
+                auto const gradPhi = gradPhiAt(e, g);
                 Matrix<kDims, kDims> const F = xe * gradPhi;
                 auto vecF                    = FromEigen(F);
                 auto psiF                    = Psi.eval(vecF, mue(g, e), lambdae(g, e));
-                auto hessPsiF                = Psi.hessian(vecF, mue(g, e), lambdae(g, e));
+                mini::SMatrix<Scalar, kStressDims, kStressDims> hessPsiF;
+                if (bProjectQuadraturePoints)
+                    ToEigen(hessPsiF) = physics::ProjectedHessian(Psi, F, mue(g, e), lambdae(g, e));
+                else
+                    hessPsiF = Psi.hessian(vecF, mue(g, e), lambdae(g, e));
                 Ue(e) += (wg(g) * detJe(g, e)) * psiF;
+                if (bStoreQuadraturePointHessians)
+                {
+                    He.col(e * QuadratureRuleType::kPoints + g) =
+                        (wg(g) * detJe(g, e)) * ToEigen(hessPsiF).reshaped();
+                    continue;
+                }
                 auto const GP = FromEigen(gradPhi);
                 auto HPsix    = HessianWrtDofs<ElementType, kDims>(hessPsiF, GP);
                 he += (wg(g) * detJe(g, e)) * ToEigen(HPsix);
             }
+            if (not bStoreQuadraturePointHessians)
+                SetElementHessian(e, he);
         });
     }
     else
     {
-        tbb::parallel_for(Index{0}, Index{numberOfElements}, [&](Index e) {
-            auto const nodes = mesh.E.col(e);
-            auto const xe    = x.reshaped(kDims, numberOfNodes)(Eigen::all, nodes);
-            auto ge          = Ge.col(e);
-            auto he          = He.block<kDofsPerElement, kDofsPerElement>(0, e * kDofsPerElement);
+        forEachElement([&](Index e) {
+            auto const nodes      = mesh.E.col(e);
+            auto const xe         = x.reshaped(kDims, numberOfNodes)(Eigen::all, nodes);
+            auto ge               = Ge.col(e);
+            ElementHessianType he = ElementHessianType::Zero();
+            Ue(e)                 = Scalar(0);
+            ge.setZero();
             for (auto g = 0; g < QuadratureRuleType::kPoints; ++g)
             {
-                auto constexpr kStride = MeshType::kDims * QuadratureRuleType::kPoints;
-                auto const gradPhi     = GNe.block<kNodesPerElement, MeshType::kDims>(
-                    0,
-                    e * kStride + g * MeshType::kDims);
+                auto const gradPhi = gradPhiAt(e, g);
                 Matrix<kDims, kDims> const F = xe * gradPhi;
                 auto vecF                    = FromEigen(F);
                 mini::SVector<Scalar, kDims * kDims> gradPsiF;
-                mini::SMatrix<Scalar, kDims * kDims, kDims * kDims> hessPsiF;
-                auto psiF =
-                    Psi.evalWithGradAndHessian(vecF, mue(g, e), lambdae(g, e), gradPsiF, hessPsiF);
+                mini::SMatrix<Scalar, kStressDims, kStressDims> hessPsiF;
+                Scalar psiF{};
+                if (bProjectQuadraturePoints)
+                {
+                    psiF = Psi.evalWithGrad(vecF, mue(g, e), lambdae(g, e), gradPsiF);
+                    ToEigen(hessPsiF) = physics::ProjectedHessian(Psi, F, mue(g, e), lambdae(g, e));
+                }
+                else
+                {
+                    psiF = Psi.evalWithGradAndHessian(
+                        vecF,
+                        mue(g, e),
+                        lambdae(g, e),
+                        gradPsiF,
+                        hessPsiF);
+                }
                 Ue(e) += (wg(g) * detJe(g, e)) * psiF;
                 auto const GP = FromEigen(gradPhi);
                 auto GPsix    = GradientWrtDofs<ElementType, kDims>(gradPsiF, GP);
-                auto HPsix    = HessianWrtDofs<ElementType, kDims>(hessPsiF, GP);
                 ge += (wg(g) * detJe(g, e)) * ToEigen(GPsix);
+                if (bStoreQuadraturePointHessians)
+                {
+                    He.col(e * QuadratureRuleType::kPoints + g) =
+                        (wg(g) * detJe(g, e)) * ToEigen(hessPsiF).reshaped();
+                    continue;
+                }
+                auto HPsix = HessianWrtDofs<ElementType, kDims>(hessPsiF, GP);
                 he += (wg(g) * detJe(g, e)) * ToEigen(HPsix);
             }
+            if (not bStoreQuadraturePointHessians)
+                SetElementHessian(e, he);
         });
     }
-    if (bWithHessian and bUseSpdProjection)
+    if (bWithHessian and bProjectElements)
     {
-        tbb::parallel_for(Index{0}, Index{numberOfElements}, [&](Index e) {
-            auto he = He.block<kDofsPerElement, kDofsPerElement>(0, e * kDofsPerElement);
-            Eigen::JacobiSVD<Matrix<kDofsPerElement, kDofsPerElement>> SVD{};
-            SVD.compute(he, Eigen::ComputeFullU | Eigen::ComputeFullV);
-            Vector<kDofsPerElement> sigma = SVD.singularValues();
-            for (auto s = sigma.size() - 1; s >= 0; --s)
-            {
-                if (sigma(s) >= 0.)
-                    break;
-                sigma(s) = -sigma(s);
-            }
-            he = SVD.matrixU() * sigma.asDiagonal() * SVD.matrixV().transpose();
+        forEachElement([&](Index e) {
+            Eigen::SelfAdjointEigenSolver<ElementHessianType> eigs(ElementHessian(e));
+            Vector<kDofsPerElement> const l = eigs.eigenvalues().cwiseMax(Scalar(0));
+            SetElementHessian(
+                e,
+                eigs.eigenvectors() * l.asDiagonal() * eigs.eigenvectors().transpose());
         });
     }
 }
@@ -376,21 +696,99 @@ inline void HyperElasticPotential<TMesh, THyperElasticEnergy, QuadratureOrder>::
         throw std::invalid_argument(what);
     }
 
-    auto constexpr kDofsPerElement = kDims * ElementType::kNodes;
-    auto const numberOfElements    = mesh.E.cols();
-    // NOTE: Outer loop could be parallelized over columns, and using graph coloring, inner loop
-    // could also be parallelized, if it's worth it.
-    for (auto c = 0; c < x.cols(); ++c)
-    {
-        for (auto e = 0; e < numberOfElements; ++e)
-        {
+    auto constexpr kNodesPerElement = ElementType::kNodes;
+    auto constexpr kDofsPerElement  = kDims * kNodesPerElement;
+    auto constexpr kStressDims      = kDims * kDims;
+    auto const numberOfElements     = mesh.E.cols();
+    ElementShapeFunctionGradients<MeshType, QuadratureOrder> const gradPhiAt(GNe, numberOfElements);
+    tbb::parallel_for(Index{0}, Index{x.cols()}, [&](Index c) {
+        ForEachElementByColor(numberOfElements, colors, [&](Index e) {
             auto const nodes = mesh.E.col(e);
-            auto const he    = He.block<kDofsPerElement, kDofsPerElement>(0, e * kDofsPerElement);
-            auto const xe    = x.col(c).reshaped(kDims, x.size() / kDims)(Eigen::all, nodes);
-            auto ye          = y.col(c).reshaped(kDims, y.size() / kDims)(Eigen::all, nodes);
-            ye.reshaped() += he * xe.reshaped();
-        }
-    }
+            auto const xe    = x.col(c).reshaped(kDims, x.rows() / kDims)(Eigen::all, nodes);
+            auto ye          = y.col(c).reshaped(kDims, y.rows() / kDims)(Eigen::all, nodes);
+            if (eHessianStorage == EHessianStorage::Full)
+            {
+                auto const he = He.block<kDofsPerElement, kDofsPerElement>(0, e * kDofsPerElement);
+                ye.reshaped() += he * xe.reshaped();
+                return;
+            }
+            if (eHessianStorage == EHessianStorage::QuadraturePoint)
+            {
+                // Contract hessians w.r.t. F with shape function gradients on the fly, i.e. the
+                // directional derivative dF = xe*gradPhi maps to stresses dP = hessPsiF*dF, which
+                // map back to nodal forces dP*gradPhi^T
+                Matrix<kDims, kNodesPerElement> yi = Matrix<kDims, kNodesPerElement>::Zero();
+                for (auto g = 0; g < QuadratureRuleType::kPoints; ++g)
+                {
+                    auto const gradPhi = gradPhiAt(e, g);
+                    auto const q = e * QuadratureRuleType::kPoints + g;
+                    Matrix<kStressDims, kStressDims> const hessPsiF =
+                        He.col(q).reshaped(kStressDims, kStressDims);
+                    Matrix<kDims, kDims> const dF = xe * gradPhi;
+                    Matrix<kDims, kDims> dP{};
+                    dP.reshaped() = hessPsiF * dF.reshaped();
+                    yi += dP * gradPhi.transpose();
+                }
+                ye += yi;
+                return;
+            }
+            // Symmetric product with the packed upper triangle of the element hessian
+            auto const he                    = He.col(e);
+            Vector<kDofsPerElement> const xi = xe.reshaped();
+            Vector<kDofsPerElement> yi       = Vector<kDofsPerElement>::Zero();
+            for (auto j = 0, k = 0; j < kDofsPerElement; ++j)
+            {
+                for (auto i = 0; i < j; ++i, ++k)
+                {
+                    yi(i) += he(k) * xi(j);
+                    yi(j) += he(k) * xi(i);
+                }
+                yi(j) += he(k++) * xi(j);
+            }
+            ye.reshaped() += yi;
+        });
+    });
+}
+
+template <CMesh TMesh, physics::CHyperElasticEnergy THyperElasticEnergy, int QuadratureOrder>
+inline void
+HyperElasticPotential<TMesh, THyperElasticEnergy, QuadratureOrder>::PrecomputeElementColoring()
+{
+    PBAT_PROFILE_NAMED_SCOPE("pbat.fem.HyperElasticPotential.PrecomputeElementColoring");
+    colors = ElementColorPartitions(mesh);
+}
+
+template <CMesh TMesh, physics::CHyperElasticEnergy THyperElasticEnergy, int QuadratureOrder>
+inline void HyperElasticPotential<TMesh, THyperElasticEnergy, QuadratureOrder>::
+    PrecomputeNodeElementAdjacency()
+{
+    PBAT_PROFILE_NAMED_SCOPE("pbat.fem.HyperElasticPotential.PrecomputeNodeElementAdjacency");
+    NE = graph::MeshAdjacencyMatrix(mesh.E, static_cast<Index>(mesh.X.cols())).transpose();
+}
+
+template <CMesh TMesh, physics::CHyperElasticEnergy THyperElasticEnergy, int QuadratureOrder>
+template <common::CIndexRange TNodeRange>
+inline std::vector<Index>
+HyperElasticPotential<TMesh, THyperElasticEnergy, QuadratureOrder>::ElementsOfNodes(
+    TNodeRange&& nodes) const
+{
+    PBAT_PROFILE_NAMED_SCOPE("pbat.fem.HyperElasticPotential.ElementsOfNodes");
+    using AdjacencyMatrixType = graph::AdjacencyMatrix<Index>;
+    auto const elementsOf     = [&](AdjacencyMatrixType const& A) {
+        std::vector<Index> elements{};
+        for (auto i : nodes)
+            for (typename AdjacencyMatrixType::InnerIterator it(A, static_cast<Index>(i)); it; ++it)
+                elements.push_back(it.row());
+        std::ranges::sort(elements);
+        auto const [first, last] = std::ranges::unique(elements);
+        elements.erase(first, last);
+        return elements;
+    };
+    if (NE.nonZeros() > 0)
+        return elementsOf(NE);
+    AdjacencyMatrixType const A =
+        graph::MeshAdjacencyMatrix(mesh.E, static_cast<Index>(mesh.X.cols())).transpose();
+    return elementsOf(A);
 }
 
 template <CMesh TMesh, physics::CHyperElasticEnergy THyperElasticEnergy, int QuadratureOrder>
@@ -430,30 +828,119 @@ HyperElasticPotential<TMesh, THyperElasticEnergy, QuadratureOrder>::PrecomputeHe
 }
 
 template <CMesh TMesh, physics::CHyperElasticEnergy THyperElasticEnergy, int QuadratureOrder>
-inline CSCMatrix
-HyperElasticPotential<TMesh, THyperElasticEnergy, QuadratureOrder>::ToMatrix() const
+inline typename HyperElasticPotential<TMesh, THyperElasticEnergy, QuadratureOrder>::
+    BlockSparsityPatternType
+    HyperElasticPotential<TMesh, THyperElasticEnergy, QuadratureOrder>::HessianBlockSparsity() const
 {
-    PBAT_PROFILE_NAMED_SCOPE("pbat.fem.HyperElasticPotential.ToMatrix");
-    if (!GH.IsEmpty())
+    PBAT_PROFILE_NAMED_SCOPE("pbat.fem.HyperElasticPotential.HessianBlockSparsity");
+    auto const numberOfElements     = mesh.E.cols();
+    auto constexpr kNodesPerElement = ElementType::kNodes;
+    std::vector<Index> blockRowIndices{};
+    std::vector<Index> blockColIndices{};
+    blockRowIndices.reserve(
+        static_cast<std::size_t>(kNodesPerElement * kNodesPerElement * numberOfElements));
+    blockColIndices.reserve(
+        static_cast<std::size_t>(kNodesPerElement * kNodesPerElement * numberOfElements));
+    // Insert non-zero blocks in the (column-major) storage order of our He matrix's blocks
+    for (auto e = 0; e < numberOfElements; ++e)
     {
-        using SpanType = std::span<Scalar const>;
-        using SizeType = typename SpanType::size_type;
-        return GH.ToMatrix(SpanType(He.data(), static_cast<SizeType>(He.size())));
+        auto const nodes = mesh.E.col(e);
+        for (auto j = 0; j < kNodesPerElement; ++j)
+        {
+            for (auto i = 0; i < kNodesPerElement; ++i)
+            {
+                blockRowIndices.push_back(nodes(i));
+                blockColIndices.push_back(nodes(j));
+            }
+        }
     }
+    auto const numberOfNodes = mesh.X.cols();
+    return BlockSparsityPatternType(numberOfNodes, numberOfNodes, blockRowIndices, blockColIndices);
+}
+
+template <CMesh TMesh, physics::CHyperElasticEnergy THyperElasticEnergy, int QuadratureOrder>
+inline void
+HyperElasticPotential<TMesh, THyperElasticEnergy, QuadratureOrder>::PrecomputeHessianBlockSparsity()
+{
+    PBAT_PROFILE_NAMED_SCOPE("pbat.fem.HyperElasticPotential.PrecomputeHessianBlockSparsity");
+    GHB = HessianBlockSparsity();
+}
+
+template <CMesh TMesh, physics::CHyperElasticEnergy THyperElasticEnergy, int QuadratureOrder>
+inline typename HyperElasticPotential<TMesh, THyperElasticEnergy, QuadratureOrder>::
+    BlockSparseMatrixType
+    HyperElasticPotential<TMesh, THyperElasticEnergy, QuadratureOrder>::ToBlockMatrix() const
+{
+    BlockSparseMatrixType H{};
+    ToBlockMatrix(H);
+    return H;
+}
+
+template <CMesh TMesh, physics::CHyperElasticEnergy THyperElasticEnergy, int QuadratureOrder>
+inline void HyperElasticPotential<TMesh, THyperElasticEnergy, QuadratureOrder>::ToBlockMatrix(
+    BlockSparseMatrixType& H) const
+{
+    PBAT_PROFILE_NAMED_SCOPE("pbat.fem.HyperElasticPotential.ToBlockMatrix");
+    auto constexpr kNodesPerElement = ElementType::kNodes;
+    auto constexpr kDofsPerElement  = kNodesPerElement * kDims;
+    // Quadrature point hessians are contracted once per element, rather than once per block
+    bool const bStoreQuadraturePointHessians =
+        (eHessianStorage == EHessianStorage::QuadraturePoint);
+    MatrixX const HeFull = bStoreQuadraturePointHessians ? ElementHessians() : MatrixX{};
+    // Non-zero block k couples local nodes (i,j) of element e, where k = (e*kNodes + j)*kNodes + i
+    auto const blockOf = [&](Index k) {
+        auto const i = k % kNodesPerElement;
+        auto const j = (k / kNodesPerElement) % kNodesPerElement;
+        auto const e = k / (kNodesPerElement * kNodesPerElement);
+        if (eHessianStorage == EHessianStorage::Full)
+            return Matrix<kDims, kDims>(
+                He.block<kDims, kDims>(kDims * i, e * kDofsPerElement + kDims * j));
+        if (bStoreQuadraturePointHessians)
+            return Matrix<kDims, kDims>(
+                HeFull.block<kDims, kDims>(kDims * i, e * kDofsPerElement + kDims * j));
+        Matrix<kDims, kDims> heij{};
+        for (auto dj = 0; dj < kDims; ++dj)
+            for (auto di = 0; di < kDims; ++di)
+                heij(di, dj) = ElementHessianCoeff(e, kDims * i + di, kDims * j + dj);
+        return heij;
+    };
+    bool const bUpdateInPlace = not GHB.IsEmpty() and H.NumberOfNonZeroBlocks() > 0;
+    if (bUpdateInPlace)
+        GHB.ToMatrix(blockOf, H);
+    else if (not GHB.IsEmpty())
+        H = GHB.ToMatrix(blockOf);
     else
+        H = HessianBlockSparsity().ToMatrix(blockOf);
+}
+
+template <CMesh TMesh, physics::CHyperElasticEnergy THyperElasticEnergy, int QuadratureOrder>
+inline CSCMatrix
+HyperElasticPotential<TMesh, THyperElasticEnergy, QuadratureOrder>::ToMatrix() const
+{
+    CSCMatrix H{};
+    ToMatrix(H);
+    return H;
+}
+
+template <CMesh TMesh, physics::CHyperElasticEnergy THyperElasticEnergy, int QuadratureOrder>
+inline void
+HyperElasticPotential<TMesh, THyperElasticEnergy, QuadratureOrder>::ToMatrix(CSCMatrix& H) const
+{
+    PBAT_PROFILE_NAMED_SCOPE("pbat.fem.HyperElasticPotential.ToMatrix");
+    auto constexpr kDofsPerElement = ElementType::kNodes * kDims;
+    auto const numberOfElements    = mesh.E.cols();
+    if (GH.IsEmpty())
     {
         // Construct hessian from triplets
         using SparseIndex = typename CSCMatrix::StorageIndex;
         using Triplet     = Eigen::Triplet<Scalar, SparseIndex>;
         std::vector<Triplet> triplets{};
-        triplets.reserve(static_cast<std::size_t>(He.size()));
-        auto const numberOfElements = mesh.E.cols();
+        triplets.reserve(
+            static_cast<std::size_t>(kDofsPerElement * kDofsPerElement * numberOfElements));
         for (auto e = 0; e < numberOfElements; ++e)
         {
-            auto const nodes     = mesh.E.col(e);
-            auto constexpr Hrows = ElementType::kNodes * kDims;
-            auto constexpr Hcols = Hrows;
-            auto const he        = He.block<Hrows, Hcols>(0, e * Hcols);
+            auto const nodes            = mesh.E.col(e);
+            ElementHessianType const he = ElementHessian(e);
             for (auto j = 0; j < ElementType::kNodes; ++j)
                 for (auto dj = 0; dj < kDims; ++dj)
                     for (auto i = 0; i < ElementType::kNodes; ++i)
@@ -465,10 +952,243 @@ HyperElasticPotential<TMesh, THyperElasticEnergy, QuadratureOrder>::ToMatrix() c
         }
 
         auto const n = InputDimensions();
-        CSCMatrix H(n, n);
+        H            = CSCMatrix(n, n);
         H.setFromTriplets(triplets.begin(), triplets.end());
-        return H;
+        return;
+    }
+    // Update H's values in place if it already has the hessian's sparsity
+    VisitHessianNonZeros([&](auto&& nonZeros) {
+        if (H.nonZeros() > 0)
+            GH.ToMatrix(nonZeros, H);
+        else
+            H = GH.ToMatrix(nonZeros);
+    });
+}
+
+template <CMesh TMesh, physics::CHyperElasticEnergy THyperElasticEnergy, int QuadratureOrder>
+template <common::CIndexRange TElementRange>
+inline void HyperElasticPotential<TMesh, THyperElasticEnergy, QuadratureOrder>::ToMatrix(
+    TElementRange&& elements,
+    CSCMatrix& H) const
+{
+    PBAT_PROFILE_NAMED_SCOPE("pbat.fem.HyperElasticPotential.ToMatrixSubset");
+    if (GH.IsEmpty())
+    {
+        throw std::invalid_argument(
+            "Patching hessian non-zeros requires the hessian sparsity, see "
+            "PrecomputeHessianSparsity()");
+    }
+    // Only the unique non-zeros that changed elements' hessians sum into need to be recomputed
+    auto constexpr kDofsPerElement = ElementType::kNodes * kDims;
+    auto constexpr kHessianSize    = kDofsPerElement * kDofsPerElement;
+    std::vector<Index> const& ku   = GH.UniqueNonZeroIndices();
+    std::vector<Index> uniqueNonZeros{};
+    uniqueNonZeros.reserve(static_cast<std::size_t>(kHessianSize) * std::ranges::size(elements));
+    for (auto e : elements)
+    {
+        auto const kBegin = static_cast<std::size_t>(kHessianSize * static_cast<Index>(e));
+        for (auto k = kBegin; k < kBegin + kHessianSize; ++k)
+            uniqueNonZeros.push_back(ku[k]);
+    }
+    tbb::parallel_sort(uniqueNonZeros.begin(), uniqueNonZeros.end());
+    auto const [first, last] = std::ranges::unique(uniqueNonZeros);
+    uniqueNonZeros.erase(first, last);
+    VisitHessianNonZeros([&](auto&& nonZeros) { GH.ToMatrix(nonZeros, uniqueNonZeros, H); });
+}
+
+template <CMesh TMesh, physics::CHyperElasticEnergy THyperElasticEnergy, int QuadratureOrder>
+template <class Func>
+inline void
+HyperElasticPotential<TMesh, THyperElasticEnergy, QuadratureOrder>::VisitHessianNonZeros(
+    Func&& f) const
+{
+    auto constexpr kDofsPerElement = ElementType::kNodes * kDims;
+    auto const numberOfElements    = mesh.E.cols();
+    using SpanType                 = std::span<Scalar const>;
+    using SizeType                 = typename SpanType::size_type;
+    if (eHessianStorage == EHessianStorage::Full)
+    {
+        f(SpanType(He.data(), static_cast<SizeType>(He.size())));
+    }
+    else if (eHessianStorage == EHessianStorage::QuadraturePoint)
+    {
+        MatrixX const HeFull = ElementHessians();
+        f(SpanType(HeFull.data(), static_cast<SizeType>(HeFull.size())));
+    }
+    else
+    {
+        // Non-zeros are indexed in full storage order, so look them up in the packed storage
+        auto constexpr kHessianSize = kDofsPerElement * kDofsPerElement;
+        f(std::views::iota(Index{0}, kHessianSize * numberOfElements) |
+          std::views::transform([this](Index k) {
+              auto const e = k / kHessianSize;
+              auto const i = (k % kHessianSize) % kDofsPerElement;
+              auto const j = (k % kHessianSize) / kDofsPerElement;
+              return ElementHessianCoeff(e, i, j);
+          }));
+    }
+}
+
+template <CMesh TMesh, physics::CHyperElasticEnergy THyperElasticEnergy, int QuadratureOrder>
+inline void HyperElasticPotential<TMesh, THyperElasticEnergy, QuadratureOrder>::SetHessianStorage(
+    EHessianStorage eStorage)
+{
+    PBAT_PROFILE_NAMED_SCOPE("pbat.fem.HyperElasticPotential.SetHessianStorage");
+    if (eStorage == eHessianStorage)
+        return;
+    auto constexpr kDofsPerElement = ElementType::kNodes * kDims;
+    auto constexpr kStressDims     = kDims * kDims;
+    auto const numberOfElements    = mesh.E.cols();
+    if (eStorage == EHessianStorage::QuadraturePoint)
+    {
+        eHessianStorage = eStorage;
+        He.setZero(kStressDims * kStressDims, QuadratureRuleType::kPoints * numberOfElements);
+        return;
+    }
+    bool const bIsFull = (eHessianStorage == EHessianStorage::Full);
+    MatrixX HeFull     = bIsFull ? std::move(He) : ElementHessians();
+    eHessianStorage    = eStorage;
+    if (eStorage == EHessianStorage::Full)
+    {
+        He = std::move(HeFull);
+        return;
+    }
+    He.resize(kDofsPerElement * (kDofsPerElement + 1) / 2, numberOfElements);
+    tbb::parallel_for(Index{0}, Index{numberOfElements}, [&](Index e) {
+        SetElementHessian(
+            e,
+            HeFull.block<kDofsPerElement, kDofsPerElement>(0, e * kDofsPerElement));
+    });
+}
+
+template <CMesh TMesh, physics::CHyperElasticEnergy THyperElasticEnergy, int QuadratureOrder>
+inline typename HyperElasticPotential<TMesh, THyperElasticEnergy, QuadratureOrder>::
+    ElementHessianType
+    HyperElasticPotential<TMesh, THyperElasticEnergy, QuadratureOrder>::ElementHessian(
+        Index e) const
+{
+    auto constexpr kNodesPerElement = ElementType::kNodes;
+    auto constexpr kDofsPerElement  = kNodesPerElement * kDims;
+    if (eHessianStorage == EHessianStorage::Full)
+        return He.block<kDofsPerElement, kDofsPerElement>(0, e * kDofsPerElement);
+    if (eHessianStorage == EHessianStorage::QuadraturePoint)
+    {
+        auto constexpr kStressDims = kDims * kDims;
+        namespace mini             = math::linalg::mini;
+        using mini::FromEigen;
+        using mini::ToEigen;
+        ElementShapeFunctionGradients<MeshType, QuadratureOrder> const gradPhiAt(
+            GNe,
+            mesh.E.cols());
+        ElementHessianType he = ElementHessianType::Zero();
+        for (auto g = 0; g < QuadratureRuleType::kPoints; ++g)
+        {
+            auto const gradPhi = gradPhiAt(e, g);
+            Matrix<kStressDims, kStressDims> const hessPsiF =
+                He.col(e * QuadratureRuleType::kPoints + g).reshaped(kStressDims, kStressDims);
+            auto HPsix =
+                HessianWrtDofs<ElementType, kDims>(FromEigen(hessPsiF), FromEigen(gradPhi));
+            he += ToEigen(HPsix);
+        }
+        return he;
     }
+    ElementHessianType he{};
+    auto const hep = He.col(e);
+    for (auto j = 0, k = 0; j < kDofsPerElement; ++j)
+        for (auto i = 0; i <= j; ++i, ++k)
+            he(i, j) = he(j, i) = hep(k);
+    return he;
+}
+
+template <CMesh TMesh, physics::CHyperElasticEnergy THyperElasticEnergy, int QuadratureOrder>
+inline MatrixX
+HyperElasticPotential<TMesh, THyperElasticEnergy, QuadratureOrder>::ElementHessians() const
+{
+    PBAT_PROFILE_NAMED_SCOPE("pbat.fem.HyperElasticPotential.ElementHessians");
+    auto constexpr kDofsPerElement = ElementType::kNodes * kDims;
+    auto const numberOfElements    = mesh.E.cols();
+    if (eHessianStorage == EHessianStorage::Full)
+        return He;
+    MatrixX HeFull(kDofsPerElement, kDofsPerElement * numberOfElements);
+    tbb::parallel_for(Index{0}, Index{numberOfElements}, [&](Index e) {
+        HeFull.block<kDofsPerElement, kDofsPerElement>(0, e * kDofsPerElement) = ElementHessian(e);
+    });
+    return HeFull;
+}
+
+template <CMesh TMesh, physics::CHyperElasticEnergy THyperElasticEnergy, int QuadratureOrder>
+inline void HyperElasticPotential<TMesh, THyperElasticEnergy, QuadratureOrder>::SetElementHessian(
+    Index e,
+    ElementHessianType const& he)
+{
+    auto constexpr kDofsPerElement = ElementType::kNodes * kDims;
+    if (eHessianStorage == EHessianStorage::QuadraturePoint)
+    {
+        throw std::invalid_argument(
+            "Element hessians cannot be stored in quadrature point hessian storage");
+    }
+    if (eHessianStorage == EHessianStorage::Full)
+    {
+        He.block<kDofsPerElement, kDofsPerElement>(0, e * kDofsPerElement) = he;
+        return;
+    }
+    auto hep = He.col(e);
+    for (auto j = 0, k = 0; j < kDofsPerElement; ++j)
+        for (auto i = 0; i <= j; ++i, ++k)
+            hep(k) = he(i, j);
+}
+
+template <CMesh TMesh, physics::CHyperElasticEnergy THyperElasticEnergy, int QuadratureOrder>
+inline Scalar HyperElasticPotential<TMesh, THyperElasticEnergy, QuadratureOrder>::
+    ElementHessianCoeff(Index e, Index i, Index j) const
+{
+    auto constexpr kDofsPerElement = ElementType::kNodes * kDims;
+    if (eHessianStorage == EHessianStorage::Full)
+        return He(i, e * kDofsPerElement + j);
+    if (eHessianStorage == EHessianStorage::QuadraturePoint)
+        return ElementHessian(e)(i, j);
+    if (i > j)
+        std::swap(i, j);
+    return He(j * (j + 1) / 2 + i, e);
+}
+
+template <CMesh TMesh, physics::CHyperElasticEnergy THyperElasticEnergy, int QuadratureOrder>
+inline VectorX HyperElasticPotential<TMesh, THyperElasticEnergy, QuadratureOrder>::Diagonal() const
+{
+    PBAT_PROFILE_NAMED_SCOPE("pbat.fem.HyperElasticPotential.Diagonal");
+    CheckValidState();
+    auto constexpr kDofsPerElement = ElementType::kNodes * kDims;
+    VectorX d                      = VectorX::Zero(InputDimensions());
+    ForEachElementByColor(mesh.E.cols(), colors, [&](Index e) {
+        auto const nodes = mesh.E.col(e);
+        // Quadrature point storage computes the whole element hessian anyways
+        Vector<kDofsPerElement> hed{};
+        if (eHessianStorage == EHessianStorage::QuadraturePoint)
+            hed = ElementHessian(e).diagonal();
+        else
+            for (auto k = 0; k < kDofsPerElement; ++k)
+                hed(k) = ElementHessianCoeff(e, k, k);
+        for (auto i = 0; i < ElementType::kNodes; ++i)
+            d.segment<kDims>(kDims * nodes(i)) += hed.template segment<kDims>(kDims * i);
+    });
+    return d;
+}
+
+template <CMesh TMesh, physics::CHyperElasticEnergy THyperElasticEnergy, int QuadratureOrder>
+inline MatrixX
+HyperElasticPotential<TMesh, THyperElasticEnergy, QuadratureOrder>::BlockDiagonal() const
+{
+    PBAT_PROFILE_NAMED_SCOPE("pbat.fem.HyperElasticPotential.BlockDiagonal");
+    CheckValidState();
+    MatrixX D = MatrixX::Zero(kDims, InputDimensions());
+    ForEachElementByColor(mesh.E.cols(), colors, [&](Index e) {
+        auto const nodes            = mesh.E.col(e);
+        ElementHessianType const he = ElementHessian(e);
+        for (auto i = 0; i < ElementType::kNodes; ++i)
+            D.block<kDims, kDims>(0, kDims * nodes(i)) +=
+                he.template block<kDims, kDims>(kDims * i, kDims * i);
+    });
+    return D;
 }
 
 template <CMesh TMesh, physics::CHyperElasticEnergy THyperElasticEnergy, int QuadratureOrder>
@@ -535,23 +1255,7 @@ HyperElasticPotential<TMesh, THyperElasticEnergy, QuadratureOrder>::CheckValidSt
             detJe.cols());
         throw std::invalid_argument(what);
     }
-    auto constexpr kExpectedGNeRows = ElementType::kNodes;
-    auto const expectedGNeCols = MeshType::kDims * QuadratureRuleType::kPoints * numberOfElements;
-    bool const bShapeFunctionGradientsHaveCorrectDimensions =
-        (GNe.rows() == kExpectedGNeRows) and (GNe.cols() == expectedGNeCols);
-    if (not bShapeFunctionGradientsHaveCorrectDimensions)
-    {
-        std::string const what = fmt::format(
-            "Expected shape function gradients at element quadrature points of dimensions "
-            "|#nodes-per-element|={} x |#mesh-dims * #quad.pts. * #elemens|={} for polynomiail "
-            "quadrature order={}, but got {}x{} instead",
-            kExpectedGNeRows,
-            expectedGNeCols,
-            QuadratureOrder,
-            GNe.rows(),
-            GNe.cols());
-        throw std::invalid_argument(what);
-    }
+    ElementShapeFunctionGradients<MeshType, QuadratureOrder>::Storage(GNe, numberOfElements);
     auto constexpr kQuadPtsPerElements = QuadratureRuleType::kPoints;
     bool const bLameCoefficientsHaveCorrectDimensions =
         (mue.rows() == kQuadPtsPerElements) and (mue.cols() == numberOfElements) and
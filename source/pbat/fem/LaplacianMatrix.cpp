@@ -73,6 +73,12 @@ TEST_CASE("[fem] LaplacianMatrix")
             Scalar const yError = (y - yFree).squaredNorm();
             CHECK_LE(yError, zero);
 
+            // Compact shape function gradients of affine elements yield the same laplacian
+            MatrixX const GNeCompact = fem::CompactShapeFunctionGradients(mesh);
+            LaplacianMatrix const compactLaplacian(mesh, detJe, GNeCompact, outDims);
+            Scalar const compactError = (compactLaplacian.ToMatrix() - L).squaredNorm();
+            CHECK_LE(compactError, zero);
+
             // Check linearity M(kx) = kM(x)
             VectorX yInputScaled  = VectorX::Zero(n);
             VectorX yOutputScaled = VectorX::Zero(n);
@@ -89,6 +95,30 @@ TEST_CASE("[fem] LaplacianMatrix")
             VectorX yconst       = VectorX::Zero(n);
             matrixFreeLaplacian.Apply(xconst, yconst);
             CHECK_LE(yconst.squaredNorm(), zero);
+
+            // Diagonal and diagonal node blocks match the assembled matrix
+            VectorX const Ldiag = L.diagonal();
+            Scalar const diagonalError =
+                (matrixFreeLaplacian.Diagonal() - Ldiag).norm() / Ldiag.norm();
+            CHECK_LE(diagonalError, zero);
+            MatrixX const LblockDiag = matrixFreeLaplacian.BlockDiagonal();
+            MatrixX const Ldense     = L;
+            for (auto i = 0; i < N; ++i)
+            {
+                Scalar const blockDiagonalError =
+                    (LblockDiag.block(0, i * outDims, outDims, outDims) -
+                     Ldense.block(i * outDims, i * outDims, outDims, outDims))
+                        .norm();
+                CHECK_LE(blockDiagonalError, zero);
+            }
+
+            // Block sparse Laplacian should match sparse Laplacian
+            if (outDims == 3)
+            {
+                auto const Lblock       = matrixFreeLaplacian.template ToBlockMatrix<3>();
+                Scalar const blockError = (Lblock.ToMatrix() - L).norm() / L.norm();
+                CHECK_LE(blockError, zero);
+            }
         }
     });
 }
\ No newline at end of file
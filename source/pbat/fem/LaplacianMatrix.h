@@ -1,12 +1,16 @@
 #ifndef PBAT_FEM_LAPLACIAN_MATRIX_H
 #define PBAT_FEM_LAPLACIAN_MATRIX_H
 
+#include "Coloring.h"
 #include "Concepts.h"
+#include "ShapeFunctions.h"
 
 #include <exception>
 #include <fmt/core.h>
 #include <pbat/Aliases.h>
 #include <pbat/common/Eigen.h>
+#include <pbat/math/linalg/BlockSparseMatrix.h>
+#include <pbat/math/linalg/BlockSparsityPattern.h>
 #include <pbat/profiling/Profiling.h>
 #include <tbb/parallel_for.h>
 
@@ -36,6 +40,9 @@ struct SymmetricLaplacianMatrix
     /**
      * @brief Applies this matrix as a linear operator on x, adding result to y.
      *
+     * Columns of x are processed in parallel. Elements are processed in parallel if the element
+     * coloring has been precomputed (see PrecomputeElementColoring()), and serially otherwise.
+     *
      * @tparam TDerivedIn
      * @tparam TDerivedOut
      * @param x
@@ -50,11 +57,40 @@ struct SymmetricLaplacianMatrix
      */
     CSCMatrix ToMatrix() const;
 
+    /**
+     * @brief Transforms this matrix-free matrix representation into block compressed sparse row
+     * format with dims x dims blocks.
+     *
+     * @tparam kBlockSize Block size, which must equal dims
+     * @return
+     */
+    template <int kBlockSize>
+    math::linalg::BlockSparseMatrix<kBlockSize> ToBlockMatrix() const;
+
+    /**
+     * @brief Computes the diagonal of this matrix, e.g. for Jacobi preconditioning.
+     * @return |dims * #nodes| diagonal
+     */
+    VectorX Diagonal() const;
+
+    /**
+     * @brief Computes the dims x dims diagonal node blocks of this matrix, e.g. for block Jacobi
+     * preconditioning.
+     * @return |dims| x |dims * #nodes| diagonal blocks
+     */
+    MatrixX BlockDiagonal() const;
+
     Index InputDimensions() const { return dims * mesh.X.cols(); }
     Index OutputDimensions() const { return InputDimensions(); }
 
     void ComputeElementLaplacians();
 
+    /**
+     * @brief Partitions elements into colors, such that Apply() scatters element laplacian
+     * products in parallel.
+     */
+    void PrecomputeElementColoring();
+
     void CheckValidState() const;
 
     MeshType const& mesh;            ///< The finite element mesh
@@ -62,11 +98,15 @@ struct SymmetricLaplacianMatrix
                                      ///< determinants at quadrature points
     Eigen::Ref<MatrixX const>
         GNe;        ///< |#element nodes|x|#dims * #quad.pts. * #elements|
-                    ///< matrix of element shape function gradients at quadrature points
+                    ///< matrix of element shape function gradients at quadrature points, or
+                    ///< their compact storage for affine elements (see
+                    ///< EShapeFunctionGradientStorage)
     MatrixX deltaE; ///< |#element nodes| x |#element nodes * #elements| matrix element
                     ///< laplacians
     int dims; ///< Dimensionality of image of FEM function space, i.e. this Laplacian matrix is
               ///< actually L \kronecker I_{dims \times dims}. Should be >= 1.
+    std::vector<std::vector<Index>>
+        colors; ///< Element color partitions, such that elements of the same color share no node
 };
 
 template <CMesh TMesh, int QuadratureOrder>
@@ -75,7 +115,7 @@ inline SymmetricLaplacianMatrix<TMesh, QuadratureOrder>::SymmetricLaplacianMatri
     Eigen::Ref<MatrixX const> const& detJe,
     Eigen::Ref<MatrixX const> const& GNe,
     int dims)
-    : mesh(mesh), detJe(detJe), GNe(GNe), deltaE(), dims(dims)
+    : mesh(mesh), detJe(detJe), GNe(GNe), deltaE(), dims(dims), colors()
 {
     ComputeElementLaplacians();
 }
@@ -114,6 +154,56 @@ inline CSCMatrix SymmetricLaplacianMatrix<TMesh, QuadratureOrder>::ToMatrix() co
     return L;
 }
 
+template <CMesh TMesh, int QuadratureOrder>
+template <int kBlockSize>
+inline math::linalg::BlockSparseMatrix<kBlockSize>
+SymmetricLaplacianMatrix<TMesh, QuadratureOrder>::ToBlockMatrix() const
+{
+    PBAT_PROFILE_NAMED_SCOPE("pbat.fem.SymmetricLaplacianMatrix.ToBlockMatrix");
+    CheckValidState();
+    if (dims != kBlockSize)
+    {
+        std::string const what = fmt::format(
+            "Expected block size equal to dims={}, but got kBlockSize={}",
+            dims,
+            kBlockSize);
+        throw std::invalid_argument(what);
+    }
+    auto const numberOfElements     = mesh.E.cols();
+    auto constexpr kNodesPerElement = ElementType::kNodes;
+    std::vector<Index> blockRowIndices{};
+    std::vector<Index> blockColIndices{};
+    blockRowIndices.reserve(static_cast<std::size_t>(deltaE.size()));
+    blockColIndices.reserve(static_cast<std::size_t>(deltaE.size()));
+    for (auto e = 0; e < numberOfElements; ++e)
+    {
+        auto const nodes = mesh.E.col(e);
+        for (auto j = 0; j < kNodesPerElement; ++j)
+        {
+            for (auto i = 0; i < kNodesPerElement; ++i)
+            {
+                blockRowIndices.push_back(nodes(i));
+                blockColIndices.push_back(nodes(j));
+            }
+        }
+    }
+    auto const numberOfNodes = mesh.X.cols();
+    math::linalg::BlockSparsityPattern<kBlockSize> const GP(
+        numberOfNodes,
+        numberOfNodes,
+        blockRowIndices,
+        blockColIndices);
+    // Non-zero block k = (e*kNodes + j)*kNodes + i is Le(i,j) I_{dims x dims}
+    return GP.ToMatrix([&](Index k) {
+        auto const i = k % kNodesPerElement;
+        auto const j = (k / kNodesPerElement) % kNodesPerElement;
+        auto const e = k / (kNodesPerElement * kNodesPerElement);
+        return (deltaE(i, e * kNodesPerElement + j) *
+                Matrix<kBlockSize, kBlockSize>::Identity())
+            .eval();
+    });
+}
+
 template <CMesh TMesh, int QuadratureOrder>
 inline void SymmetricLaplacianMatrix<TMesh, QuadratureOrder>::ComputeElementLaplacians()
 {
@@ -123,10 +213,9 @@ inline void SymmetricLaplacianMatrix<TMesh, QuadratureOrder>::ComputeElementLapl
     auto const wg                   = common::ToEigen(QuadratureRuleType::weights);
     auto constexpr kNodesPerElement = ElementType::kNodes;
     auto constexpr kQuadPts         = QuadratureRuleType::kPoints;
-    auto constexpr kDims            = MeshType::kDims;
-    auto constexpr kStride          = kDims * kQuadPts;
     auto const numberOfElements     = mesh.E.cols();
     deltaE.setZero(kNodesPerElement, kNodesPerElement * numberOfElements);
+    ElementShapeFunctionGradients<MeshType, QuadratureOrder> const gradPhiAt(GNe, numberOfElements);
     tbb::parallel_for(Index{0}, Index{numberOfElements}, [&](Index e) {
         auto Le = deltaE.block<kNodesPerElement, kNodesPerElement>(0, e * kNodesPerElement);
         for (auto g = 0; g < kQuadPts; ++g)
@@ -134,12 +223,37 @@ inline void SymmetricLaplacianMatrix<TMesh, QuadratureOrder>::ComputeElementLapl
             // Use multivariable integration by parts (i.e. Green's identity), and retain only the
             // symmetric part, i.e.
             // Lij = -\int_{\Omega} \nabla \phi_i(X) \cdot \nabla \phi_j(X) \partial \Omega.
-            auto const GP = GNe.block<kNodesPerElement, kDims>(0, e * kStride + g * kDims);
+            auto const GP = gradPhiAt(e, g);
             Le -= (wg(g) * detJe(g, e)) * (GP * GP.transpose());
         }
     });
 }
 
+template <CMesh TMesh, int QuadratureOrder>
+inline VectorX SymmetricLaplacianMatrix<TMesh, QuadratureOrder>::Diagonal() const
+{
+    PBAT_PROFILE_NAMED_SCOPE("pbat.fem.SymmetricLaplacianMatrix.Diagonal");
+    CheckValidState();
+    auto constexpr kNodesPerElement = ElementType::kNodes;
+    VectorX l                       = VectorX::Zero(mesh.X.cols());
+    ForEachElementByColor(mesh.E.cols(), colors, [&](Index e) {
+        auto const Le = deltaE.block<kNodesPerElement, kNodesPerElement>(0, e * kNodesPerElement);
+        l(mesh.E.col(e)) += Le.diagonal();
+    });
+    return l.transpose().replicate(dims, 1).reshaped();
+}
+
+template <CMesh TMesh, int QuadratureOrder>
+inline MatrixX SymmetricLaplacianMatrix<TMesh, QuadratureOrder>::BlockDiagonal() const
+{
+    PBAT_PROFILE_NAMED_SCOPE("pbat.fem.SymmetricLaplacianMatrix.BlockDiagonal");
+    VectorX const d = Diagonal();
+    MatrixX D       = MatrixX::Zero(dims, d.size());
+    for (auto i = 0; i < mesh.X.cols(); ++i)
+        D.block(0, i * dims, dims, dims).diagonal() = d.segment(i * dims, dims);
+    return D;
+}
+
 template <CMesh TMesh, int QuadratureOrder>
 inline void SymmetricLaplacianMatrix<TMesh, QuadratureOrder>::CheckValidState() const
 {
@@ -161,23 +275,7 @@ inline void SymmetricLaplacianMatrix<TMesh, QuadratureOrder>::CheckValidState()
             detJe.cols());
         throw std::invalid_argument(what);
     }
-    auto constexpr kExpectedGNeRows = ElementType::kNodes;
-    auto const expectedGNeCols = MeshType::kDims * QuadratureRuleType::kPoints * numberOfElements;
-    bool const bShapeFunctionGradientsHaveCorrectDimensions =
-        (GNe.rows() == kExpectedGNeRows) and (GNe.cols() == expectedGNeCols);
-    if (not bShapeFunctionGradientsHaveCorrectDimensions)
-    {
-        std::string const what = fmt::format(
-            "Expected shape function gradients at element quadrature points of dimensions "
-            "|#nodes-per-element|={} x |#mesh-dims * #quad.pts. * #elemens|={} for polynomiail "
-            "quadrature order={}, but got {}x{} instead",
-            kExpectedGNeRows,
-            expectedGNeCols,
-            QuadratureOrder,
-            GNe.rows(),
-            GNe.cols());
-        throw std::invalid_argument(what);
-    }
+    ElementShapeFunctionGradients<MeshType, QuadratureOrder>::Storage(GNe, numberOfElements);
     if (dims < 1)
     {
         std::string const what =
@@ -211,19 +309,24 @@ inline void SymmetricLaplacianMatrix<TMesh, QuadratureOrder>::Apply(
     }
 
     auto const numberOfElements = mesh.E.cols();
-    for (auto c = 0; c < x.cols(); ++c)
-    {
-        for (auto e = 0; e < numberOfElements; ++e)
-        {
+    tbb::parallel_for(Index{0}, Index{x.cols()}, [&](Index c) {
+        ForEachElementByColor(numberOfElements, colors, [&](Index e) {
             auto const nodes                = mesh.E.col(e);
             auto constexpr kNodesPerElement = ElementType::kNodes;
             auto const Le =
                 deltaE.block(0, e * kNodesPerElement, kNodesPerElement, kNodesPerElement);
-            auto ye       = y.col(c).reshaped(dims, y.size() / dims)(Eigen::all, nodes);
-            auto const xe = x.col(c).reshaped(dims, x.size() / dims)(Eigen::all, nodes);
+            auto ye       = y.col(c).reshaped(dims, y.rows() / dims)(Eigen::all, nodes);
+            auto const xe = x.col(c).reshaped(dims, x.rows() / dims)(Eigen::all, nodes);
             ye += xe * Le /*.transpose() technically, but Laplacian matrix is symmetric*/;
-        }
-    }
+        });
+    });
+}
+
+template <CMesh TMesh, int QuadratureOrder>
+inline void SymmetricLaplacianMatrix<TMesh, QuadratureOrder>::PrecomputeElementColoring()
+{
+    PBAT_PROFILE_NAMED_SCOPE("pbat.fem.SymmetricLaplacianMatrix.PrecomputeElementColoring");
+    colors = ElementColorPartitions(mesh);
 }
 
 } // namespace fem
@@ -0,0 +1,67 @@
+#include "LumpedMassMatrix.h"
+
+#include "Jacobian.h"
+#include "MassMatrix.h"
+#include "Mesh.h"
+#include "Tetrahedron.h"
+
+#include <doctest/doctest.h>
+#include <pbat/common/ConstexprFor.h>
+#include <pbat/math/LinearOperator.h>
+
+TEST_CASE("[fem] LumpedMassMatrix")
+{
+    using namespace pbat;
+
+    // Cube tetrahedral mesh
+    MatrixX V(3, 8);
+    IndexMatrixX C(4, 5);
+    // clang-format off
+    V << 0., 1., 0., 1., 0., 1., 0., 1.,
+         0., 0., 1., 1., 0., 0., 1., 1.,
+         0., 0., 0., 0., 1., 1., 1., 1.;
+    C << 0, 3, 5, 6, 0,
+         1, 2, 4, 7, 5,
+         3, 0, 6, 5, 3,
+         5, 6, 0, 3, 6;
+    // clang-format on
+
+    Scalar constexpr rho = 2.;
+    common::ForRange<1, 3>([&]<auto kOrder>() {
+        for (auto outDims = 1; outDims < 4; ++outDims)
+        {
+            using Element        = fem::Tetrahedron<kOrder>;
+            auto constexpr kDims = 3;
+            using Mesh           = fem::Mesh<Element, kDims>;
+            Mesh mesh(V, C);
+            auto const N          = mesh.X.cols();
+            Scalar constexpr zero = 1e-10;
+            auto const n          = N * outDims;
+
+            auto constexpr kQuadratureOrder = 2 * kOrder;
+            using LumpedMassMatrix          = fem::LumpedMassMatrix<Mesh, kQuadratureOrder>;
+            CHECK(math::CLinearOperator<LumpedMassMatrix>);
+            MatrixX const detJe = fem::DeterminantOfJacobian<kQuadratureOrder>(mesh);
+            LumpedMassMatrix lumpedMass(mesh, detJe, rho, outDims);
+
+            // Nodal masses are the row sums of the consistent mass matrix
+            CSCMatrix const M = fem::MassMatrix<Mesh, kQuadratureOrder>(mesh, detJe, rho, outDims)
+                                    .ToMatrix();
+            VectorX const mExpected = M * VectorX::Ones(n);
+            CSCMatrix const Mlumped = lumpedMass.ToMatrix();
+            CHECK_EQ(Mlumped.rows(), n);
+            CHECK_EQ(Mlumped.cols(), n);
+            CHECK_EQ(Mlumped.nonZeros(), n);
+            Scalar const massError =
+                (Mlumped.diagonal() - mExpected).norm() / mExpected.norm();
+            CHECK_LE(massError, zero);
+
+            // Check that matrix-free application matches matrix multiplication
+            MatrixX const X = MatrixX::Random(n, 3);
+            MatrixX Y       = MatrixX::Zero(n, 3);
+            lumpedMass.Apply(X, Y);
+            Scalar const applyError = (Y - Mlumped * X).norm() / (Mlumped * X).norm();
+            CHECK_LE(applyError, zero);
+        }
+    });
+}
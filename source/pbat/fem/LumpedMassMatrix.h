@@ -0,0 +1,255 @@
+#ifndef PBAT_FEM_LUMPED_MASS_MATRIX_H
+#define PBAT_FEM_LUMPED_MASS_MATRIX_H
+
+#include "Concepts.h"
+#include "ShapeFunctions.h"
+
+#include <exception>
+#include <fmt/core.h>
+#include <pbat/Aliases.h>
+#include <pbat/common/Eigen.h>
+#include <pbat/profiling/Profiling.h>
+#include <string>
+#include <tbb/enumerable_thread_specific.h>
+#include <tbb/parallel_for.h>
+
+namespace pbat {
+namespace fem {
+
+/**
+ * @brief Row-sum lumped (i.e. diagonal) mass matrix.
+ *
+ * Nodal masses are integrated directly, without forming element mass matrices. Because shape
+ * functions form a partition of unity, the mass of node i in element e is
+ * \f$ \sum_g w_g \rho_g |\det J_g| N_i(X_g) \f$, which equals the i^{th} row sum of the element
+ * mass matrix of MassMatrix.
+ *
+ * @tparam TMesh
+ * @tparam QuadratureOrder
+ */
+template <CMesh TMesh, int QuadratureOrder>
+struct LumpedMassMatrix
+{
+  public:
+    using SelfType              = LumpedMassMatrix<TMesh, QuadratureOrder>;
+    using MeshType              = TMesh;
+    using ElementType           = typename TMesh::ElementType;
+    using QuadratureRuleType    = typename ElementType::template QuadratureType<QuadratureOrder>;
+    static int constexpr kOrder = ElementType::kOrder;
+    static int constexpr kQuadratureOrder = QuadratureOrder;
+
+    /**
+     * @brief
+     * @param mesh
+     * @param detJe |#quad.pts.|x|#elements| affine element jacobian determinants at quadrature
+     * points
+     * @param rho Uniform mass density
+     * @param dims Dimensionality of image of FEM function space
+     */
+    LumpedMassMatrix(
+        MeshType const& mesh,
+        Eigen::Ref<MatrixX const> const& detJe,
+        Scalar rho = 1.,
+        int dims   = 1);
+
+    /**
+     * @brief
+     * @tparam TDerived
+     * @param mesh
+     * @param detJe |#quad.pts.|x|#elements| affine element jacobian determinants at quadrature
+     * points
+     * @param rho |#quad.pts.|x|#elements| mass density per quadrature point
+     * @param dims Dimensionality of image of FEM function space
+     */
+    template <class TDerived>
+    LumpedMassMatrix(
+        MeshType const& mesh,
+        Eigen::Ref<MatrixX const> const& detJe,
+        Eigen::DenseBase<TDerived> const& rho,
+        int dims = 1);
+
+    SelfType& operator=(SelfType const&) = delete;
+
+    /**
+     * @brief Applies this lumped mass matrix as a linear operator on x, adding result to y.
+     *
+     * Columns of x are processed in parallel, in O(#nodes * dims) time per column.
+     *
+     * @tparam TDerivedIn
+     * @tparam TDerivedOut
+     * @param x
+     * @param y
+     */
+    template <class TDerivedIn, class TDerivedOut>
+    void Apply(Eigen::MatrixBase<TDerivedIn> const& x, Eigen::DenseBase<TDerivedOut>& y) const;
+
+    /**
+     * @brief Transforms this lumped mass matrix into a diagonal sparse compressed matrix.
+     * @return
+     */
+    CSCMatrix ToMatrix() const;
+
+    Index InputDimensions() const { return dims * mesh.X.cols(); }
+    Index OutputDimensions() const { return InputDimensions(); }
+
+    /**
+     * @brief Integrates nodal masses by accumulating element contributions into thread-local
+     * nodal mass vectors, in parallel over elements.
+     *
+     * @tparam TDerived
+     * @param rho |#quad.pts.|x|#elements| piecewise constant mass density
+     */
+    template <class TDerived>
+    void ComputeNodalMasses(Eigen::DenseBase<TDerived> const& rho);
+
+    void CheckValidState() const;
+
+    MeshType const& mesh;            ///< The finite element mesh
+    Eigen::Ref<MatrixX const> detJe; ///< |# element quadrature points| x |# elements| matrix of
+                                     ///< jacobian determinants at element quadrature points
+    VectorX m; ///< |#nodes| lumped nodal masses for 1-dimensional problems. For d-dimensional
+               ///< problems, each nodal mass is repeated d times along the diagonal.
+    int dims;  ///< Dimensionality of image of FEM function space, i.e. this mass matrix is actually
+               ///< diag(m) \kronecker I_{dims \times dims}. Should be >= 1.
+};
+
+template <CMesh TMesh, int QuadratureOrder>
+inline LumpedMassMatrix<TMesh, QuadratureOrder>::LumpedMassMatrix(
+    MeshType const& mesh,
+    Eigen::Ref<MatrixX const> const& detJe,
+    Scalar rho,
+    int dims)
+    : LumpedMassMatrix<TMesh, QuadratureOrder>(
+          mesh,
+          detJe,
+          MatrixX::Constant(QuadratureRuleType::kPoints, mesh.E.cols(), rho),
+          dims)
+{
+}
+
+template <CMesh TMesh, int QuadratureOrder>
+template <class TDerived>
+inline LumpedMassMatrix<TMesh, QuadratureOrder>::LumpedMassMatrix(
+    MeshType const& mesh,
+    Eigen::Ref<MatrixX const> const& detJe,
+    Eigen::DenseBase<TDerived> const& rho,
+    int dims)
+    : mesh(mesh), detJe(detJe), m(), dims(dims)
+{
+    ComputeNodalMasses(rho);
+}
+
+template <CMesh TMesh, int QuadratureOrder>
+template <class TDerivedIn, class TDerivedOut>
+inline void LumpedMassMatrix<TMesh, QuadratureOrder>::Apply(
+    Eigen::MatrixBase<TDerivedIn> const& x,
+    Eigen::DenseBase<TDerivedOut>& y) const
+{
+    PBAT_PROFILE_NAMED_SCOPE("pbat.fem.LumpedMassMatrix.Apply");
+    CheckValidState();
+    auto const numberOfDofs = InputDimensions();
+    if (x.rows() != numberOfDofs or y.rows() != numberOfDofs or x.cols() != y.cols())
+    {
+        std::string const what = fmt::format(
+            "Expected inputs and outputs to have rows |#nodes*dims|={} and same number of "
+            "columns, but got dimensions "
+            "x,y=({},{}), ({},{})",
+            numberOfDofs,
+            x.rows(),
+            x.cols(),
+            y.rows(),
+            y.cols());
+        throw std::invalid_argument(what);
+    }
+    auto const numberOfNodes = m.size();
+    tbb::parallel_for(Index{0}, Index{y.cols()}, [&](Index c) {
+        y.col(c).reshaped(dims, numberOfNodes) +=
+            x.col(c).reshaped(dims, numberOfNodes) * m.asDiagonal();
+    });
+}
+
+template <CMesh TMesh, int QuadratureOrder>
+inline CSCMatrix LumpedMassMatrix<TMesh, QuadratureOrder>::ToMatrix() const
+{
+    PBAT_PROFILE_NAMED_SCOPE("pbat.fem.LumpedMassMatrix.ToMatrix");
+    CheckValidState();
+    CSCMatrix M(OutputDimensions(), InputDimensions());
+    M = m.transpose().replicate(dims, 1).reshaped().asDiagonal();
+    return M;
+}
+
+template <CMesh TMesh, int QuadratureOrder>
+inline void LumpedMassMatrix<TMesh, QuadratureOrder>::CheckValidState() const
+{
+    auto const numberOfElements       = mesh.E.cols();
+    auto constexpr kExpectedDetJeRows = QuadratureRuleType::kPoints;
+    auto const expectedDetJeCols      = numberOfElements;
+    bool const bDeterminantsHaveCorrectDimensions =
+        (detJe.rows() == kExpectedDetJeRows) and (detJe.cols() == expectedDetJeCols);
+    if (not bDeterminantsHaveCorrectDimensions)
+    {
+        std::string const what = fmt::format(
+            "Expected determinants at element quadrature points of dimensions #quad.pts.={} x "
+            "#elements={} for polynomial "
+            "quadrature order={}, but got {}x{} instead.",
+            kExpectedDetJeRows,
+            expectedDetJeCols,
+            QuadratureOrder,
+            detJe.rows(),
+            detJe.cols());
+        throw std::invalid_argument(what);
+    }
+    if (dims < 1)
+    {
+        std::string const what =
+            fmt::format("Expected output dimensionality >= 1, got {} instead", dims);
+        throw std::invalid_argument(what);
+    }
+}
+
+template <CMesh TMesh, int QuadratureOrder>
+template <class TDerived>
+inline void LumpedMassMatrix<TMesh, QuadratureOrder>::ComputeNodalMasses(
+    Eigen::DenseBase<TDerived> const& rho)
+{
+    PBAT_PROFILE_NAMED_SCOPE("pbat.fem.LumpedMassMatrix.ComputeNodalMasses");
+    CheckValidState();
+    auto const numberOfElements       = mesh.E.cols();
+    auto const numberOfNodes          = mesh.X.cols();
+    auto constexpr kNodesPerElement   = ElementType::kNodes;
+    auto constexpr kQuadPtsPerElement = QuadratureRuleType::kPoints;
+    bool const bRhoDimensionsAreCorrect =
+        (rho.cols() == numberOfElements) and (rho.rows() == kQuadPtsPerElement);
+    if (not bRhoDimensionsAreCorrect)
+    {
+        std::string const what = fmt::format(
+            "Expected mass density rho of dimensions {}x{}, but dimensions were "
+            "{}x{}",
+            kQuadPtsPerElement,
+            numberOfElements,
+            rho.rows(),
+            rho.cols());
+        throw std::invalid_argument(what);
+    }
+    // Precompute quadrature weighted shape functions
+    auto const N  = ShapeFunctions<ElementType, kQuadratureOrder>();
+    auto const wg = common::ToEigen(QuadratureRuleType::weights);
+    Matrix<kNodesPerElement, kQuadPtsPerElement> const wN = N * wg.asDiagonal();
+    // Accumulate element nodal masses into thread-local nodal masses, then sum them
+    tbb::enumerable_thread_specific<VectorX> mt([numberOfNodes]() {
+        return VectorX::Zero(numberOfNodes).eval();
+    });
+    tbb::parallel_for(Index{0}, Index{numberOfElements}, [&](Index e) {
+        auto const rhoDetJ = (rho.col(e).array() * detJe.col(e).array()).matrix();
+        VectorX& ml        = mt.local();
+        ml(mesh.E.col(e)) += wN * rhoDetJ;
+    });
+    m.setZero(numberOfNodes);
+    for (VectorX const& ml : mt)
+        m += ml;
+}
+
+} // namespace fem
+} // namespace pbat
+
+#endif // PBAT_FEM_LUMPED_MASS_MATRIX_H
@@ -76,6 +76,38 @@ TEST_CASE("[fem] MassMatrix")
                 (yInputScaled - yOutputScaled).norm() / yOutputScaled.norm();
             CHECK_LE(yLinearityError, zero);
 
+            // Check that colored parallel application matches matrix multiplication
+            MatrixX const X = MatrixX::Random(n, 3);
+            MatrixX Y       = MatrixX::Zero(n, 3);
+            matrixFreeMass.PrecomputeElementColoring();
+            matrixFreeMass.Apply(X, Y);
+            Scalar const coloredError = (Y - M * X).norm() / (M * X).norm();
+            CHECK_LE(coloredError, zero);
+
+            // Diagonal and diagonal node blocks match the assembled matrix
+            VectorX const Mdiag = M.diagonal();
+            Scalar const diagonalError =
+                (matrixFreeMass.Diagonal() - Mdiag).norm() / Mdiag.norm();
+            CHECK_LE(diagonalError, zero);
+            MatrixX const MblockDiag = matrixFreeMass.BlockDiagonal();
+            MatrixX const Mdense     = M;
+            for (auto i = 0; i < N; ++i)
+            {
+                Scalar const blockDiagonalError =
+                    (MblockDiag.block(0, i * outDims, outDims, outDims) -
+                     Mdense.block(i * outDims, i * outDims, outDims, outDims))
+                        .norm();
+                CHECK_LE(blockDiagonalError, zero);
+            }
+
+            // Check that block sparse mass matrix matches sparse mass matrix
+            if (outDims == 3)
+            {
+                auto const Mblock       = matrixFreeMass.template ToBlockMatrix<3>();
+                Scalar const blockError = (Mblock.ToMatrix() - M).norm() / M.norm();
+                CHECK_LE(blockError, zero);
+            }
+
             // TODO: We should probably check that the mass matrices actually have the
             // right values... But this is probably best done in a separate test.
         }
@@ -1,6 +1,7 @@
 #ifndef PBAT_FEM_MASS_MATRIX_H
 #define PBAT_FEM_MASS_MATRIX_H
 
+#include "Coloring.h"
 #include "Concepts.h"
 #include "ShapeFunctions.h"
 
@@ -9,6 +10,8 @@
 #include <fmt/core.h>
 #include <pbat/Aliases.h>
 #include <pbat/common/Eigen.h>
+#include <pbat/math/linalg/BlockSparseMatrix.h>
+#include <pbat/math/linalg/BlockSparsityPattern.h>
 #include <pbat/profiling/Profiling.h>
 #include <tbb/parallel_for.h>
 
@@ -59,6 +62,9 @@ struct MassMatrix
     /**
      * @brief Applies this mass matrix as a linear operator on x, adding result to y.
      *
+     * Columns of x are processed in parallel. Elements are processed in parallel if the element
+     * coloring has been precomputed (see PrecomputeElementColoring()), and serially otherwise.
+     *
      * @tparam TDerivedIn
      * @tparam TDerivedOut
      * @param x
@@ -73,6 +79,29 @@ struct MassMatrix
      */
     CSCMatrix ToMatrix() const;
 
+    /**
+     * @brief Transforms this matrix-free mass matrix representation into block compressed sparse
+     * row format with dims x dims blocks.
+     *
+     * @tparam kBlockSize Block size, which must equal dims
+     * @return
+     */
+    template <int kBlockSize>
+    math::linalg::BlockSparseMatrix<kBlockSize> ToBlockMatrix() const;
+
+    /**
+     * @brief Computes the diagonal of this mass matrix, e.g. for Jacobi preconditioning.
+     * @return |dims * #nodes| diagonal
+     */
+    VectorX Diagonal() const;
+
+    /**
+     * @brief Computes the dims x dims diagonal node blocks of this mass matrix, e.g. for block
+     * Jacobi preconditioning.
+     * @return |dims| x |dims * #nodes| diagonal blocks
+     */
+    MatrixX BlockDiagonal() const;
+
     Index InputDimensions() const { return dims * mesh.X.cols(); }
     Index OutputDimensions() const { return InputDimensions(); }
 
@@ -84,6 +113,12 @@ struct MassMatrix
     template <class TDerived>
     void ComputeElementMassMatrices(Eigen::DenseBase<TDerived> const& rho);
 
+    /**
+     * @brief Partitions elements into colors, such that Apply() scatters element mass matrix
+     * products in parallel.
+     */
+    void PrecomputeElementColoring();
+
     void CheckValidState() const;
 
     MeshType const& mesh;            ///< The finite element mesh
@@ -94,6 +129,8 @@ struct MassMatrix
                 ///< should be Kroneckered with the d-dimensional identity matrix.
     int dims; ///< Dimensionality of image of FEM function space, i.e. this mass matrix is actually
               ///< M \kronecker I_{dims \times dims}. Should be >= 1.
+    std::vector<std::vector<Index>>
+        colors; ///< Element color partitions, such that elements of the same color share no node
 };
 
 template <CMesh TMesh, int QuadratureOrder>
@@ -117,7 +154,7 @@ inline MassMatrix<TMesh, QuadratureOrder>::MassMatrix(
     Eigen::Ref<MatrixX const> const& detJe,
     Eigen::DenseBase<TDerived> const& rho,
     int dims)
-    : mesh(mesh), detJe(detJe), Me(), dims(dims)
+    : mesh(mesh), detJe(detJe), Me(), dims(dims), colors()
 {
     ComputeElementMassMatrices(rho);
 }
@@ -146,19 +183,23 @@ inline void MassMatrix<TMesh, QuadratureOrder>::Apply(
     }
 
     auto const numberOfElements = mesh.E.cols();
-    // NOTE: Could parallelize over columns, if there are many.
-    for (auto c = 0; c < y.cols(); ++c)
-    {
-        for (auto e = 0; e < numberOfElements; ++e)
-        {
+    tbb::parallel_for(Index{0}, Index{y.cols()}, [&](Index c) {
+        ForEachElementByColor(numberOfElements, colors, [&](Index e) {
             auto const nodes = mesh.E.col(e).array();
             auto const me =
                 Me.block<ElementType::kNodes, ElementType::kNodes>(0, e * ElementType::kNodes);
-            auto ye       = y.col(c).reshaped(dims, y.size() / dims)(Eigen::all, nodes);
-            auto const xe = x.col(c).reshaped(dims, x.size() / dims)(Eigen::all, nodes);
+            auto ye       = y.col(c).reshaped(dims, y.rows() / dims)(Eigen::all, nodes);
+            auto const xe = x.col(c).reshaped(dims, x.rows() / dims)(Eigen::all, nodes);
             ye += xe * me /*.transpose() technically, but mass matrix is symmetric*/;
-        }
-    }
+        });
+    });
+}
+
+template <CMesh TMesh, int QuadratureOrder>
+inline void MassMatrix<TMesh, QuadratureOrder>::PrecomputeElementColoring()
+{
+    PBAT_PROFILE_NAMED_SCOPE("pbat.fem.MassMatrix.PrecomputeElementColoring");
+    colors = ElementColorPartitions(mesh);
 }
 
 template <CMesh TMesh, int QuadratureOrder>
@@ -196,6 +237,81 @@ inline CSCMatrix MassMatrix<TMesh, QuadratureOrder>::ToMatrix() const
     return Mmat;
 }
 
+template <CMesh TMesh, int QuadratureOrder>
+template <int kBlockSize>
+inline math::linalg::BlockSparseMatrix<kBlockSize>
+MassMatrix<TMesh, QuadratureOrder>::ToBlockMatrix() const
+{
+    PBAT_PROFILE_NAMED_SCOPE("pbat.fem.MassMatrix.ToBlockMatrix");
+    CheckValidState();
+    if (dims != kBlockSize)
+    {
+        std::string const what = fmt::format(
+            "Expected block size equal to dims={}, but got kBlockSize={}",
+            dims,
+            kBlockSize);
+        throw std::invalid_argument(what);
+    }
+    auto const numberOfElements     = mesh.E.cols();
+    auto constexpr kNodesPerElement = ElementType::kNodes;
+    std::vector<Index> blockRowIndices{};
+    std::vector<Index> blockColIndices{};
+    blockRowIndices.reserve(static_cast<std::size_t>(Me.size()));
+    blockColIndices.reserve(static_cast<std::size_t>(Me.size()));
+    for (auto e = 0; e < numberOfElements; ++e)
+    {
+        auto const nodes = mesh.E.col(e);
+        for (auto j = 0; j < kNodesPerElement; ++j)
+        {
+            for (auto i = 0; i < kNodesPerElement; ++i)
+            {
+                blockRowIndices.push_back(nodes(i));
+                blockColIndices.push_back(nodes(j));
+            }
+        }
+    }
+    auto const numberOfNodes = mesh.X.cols();
+    math::linalg::BlockSparsityPattern<kBlockSize> const GP(
+        numberOfNodes,
+        numberOfNodes,
+        blockRowIndices,
+        blockColIndices);
+    // Non-zero block k = (e*kNodes + j)*kNodes + i is me(i,j) I_{dims x dims}
+    return GP.ToMatrix([&](Index k) {
+        auto const i = k % kNodesPerElement;
+        auto const j = (k / kNodesPerElement) % kNodesPerElement;
+        auto const e = k / (kNodesPerElement * kNodesPerElement);
+        return (Me(i, e * kNodesPerElement + j) *
+                Matrix<kBlockSize, kBlockSize>::Identity())
+            .eval();
+    });
+}
+
+template <CMesh TMesh, int QuadratureOrder>
+inline VectorX MassMatrix<TMesh, QuadratureOrder>::Diagonal() const
+{
+    PBAT_PROFILE_NAMED_SCOPE("pbat.fem.MassMatrix.Diagonal");
+    CheckValidState();
+    auto constexpr kNodesPerElement = ElementType::kNodes;
+    VectorX m                       = VectorX::Zero(mesh.X.cols());
+    ForEachElementByColor(mesh.E.cols(), colors, [&](Index e) {
+        auto const me = Me.block<kNodesPerElement, kNodesPerElement>(0, e * kNodesPerElement);
+        m(mesh.E.col(e)) += me.diagonal();
+    });
+    return m.transpose().replicate(dims, 1).reshaped();
+}
+
+template <CMesh TMesh, int QuadratureOrder>
+inline MatrixX MassMatrix<TMesh, QuadratureOrder>::BlockDiagonal() const
+{
+    PBAT_PROFILE_NAMED_SCOPE("pbat.fem.MassMatrix.BlockDiagonal");
+    VectorX const d = Diagonal();
+    MatrixX D       = MatrixX::Zero(dims, d.size());
+    for (auto i = 0; i < mesh.X.cols(); ++i)
+        D.block(0, i * dims, dims, dims).diagonal() = d.segment(i * dims, dims);
+    return D;
+}
+
 template <CMesh TMesh, int QuadratureOrder>
 inline void MassMatrix<TMesh, QuadratureOrder>::CheckValidState() const
 {
@@ -3,8 +3,15 @@
 #include "Hexahedron.h"
 #include "Tetrahedron.h"
 
+#include <algorithm>
 #include <doctest/doctest.h>
+#include <map>
+#include <numeric>
 #include <pbat/common/ConstexprFor.h>
+#include <pbat/math/Rational.h>
+#include <ranges>
+#include <utility>
+#include <vector>
 
 TEST_CASE("[fem] Mesh")
 {
@@ -162,3 +169,87 @@ TEST_CASE("[fem] Mesh quadrature points")
         });
     });
 }
+
+TEST_CASE("[fem] Mesh nodes match serial first-visit construction")
+{
+    using namespace pbat;
+
+    // Serial reference construction, creating mesh nodes on first visit in cell order
+    auto const referenceMesh = [&]<class ElementType>(
+                                   MatrixX const& V,
+                                   IndexMatrixX const& C) -> std::pair<MatrixX, IndexMatrixX> {
+        using AffineElementType         = typename ElementType::AffineBaseType;
+        auto constexpr kVerticesPerCell = AffineElementType::kNodes;
+        std::map<fem::NodalKey<ElementType>, Index> nodeMap{};
+        std::vector<Vector<3>> nodes{};
+        IndexMatrixX E(ElementType::kNodes, C.cols());
+        auto const nodalCoordinates = common::ToEigen(ElementType::Coordinates)
+                                          .reshaped(ElementType::kDims, ElementType::kNodes)
+                                          .template cast<math::Rational>() /
+                                      ElementType::kOrder;
+        for (auto c = 0; c < C.cols(); ++c)
+        {
+            IndexVector<kVerticesPerCell> const cellVertices = C.col(c);
+            Matrix<3, kVerticesPerCell> const Xc             = V(Eigen::all, cellVertices);
+            IndexVector<kVerticesPerCell> sortOrder{};
+            std::iota(sortOrder.begin(), sortOrder.end(), 0);
+            std::ranges::sort(sortOrder, [&](Index i, Index j) {
+                return cellVertices[i] < cellVertices[j];
+            });
+            for (auto i = 0; i < nodalCoordinates.cols(); ++i)
+            {
+                auto const N = AffineElementType::N(nodalCoordinates.col(i));
+                fem::NodalKey<ElementType> const key{cellVertices, sortOrder, N};
+                auto it = nodeMap.find(key);
+                if (it == nodeMap.end())
+                {
+                    it = nodeMap.insert({key, static_cast<Index>(nodes.size())}).first;
+                    nodes.push_back(Xc * N.template cast<Scalar>());
+                }
+                E(i, c) = it->second;
+            }
+        }
+        return {common::ToEigen(nodes), E};
+    };
+
+    // Row of 3 unit cubes, with vertex labels in reverse grid order
+    auto constexpr kCubes = 3;
+    MatrixX V(3, 4 * (kCubes + 1));
+    for (auto z = 0; z < 2; ++z)
+        for (auto y = 0; y < 2; ++y)
+            for (auto x = 0; x <= kCubes; ++x)
+                V.col(V.cols() - 1 - (x + (kCubes + 1) * (y + 2 * z))) =
+                    Vector<3>{Scalar(x), Scalar(y), Scalar(z)};
+    auto const vertexOf = [&](Index cube, Index l) {
+        auto const x = l % 2, y = (l / 2) % 2, z = l / 4;
+        return V.cols() - 1 - (cube + x + (kCubes + 1) * (y + 2 * z));
+    };
+    IndexMatrixX cubeTets(4, 5);
+    // clang-format off
+    cubeTets << 0, 3, 5, 6, 0,
+                1, 2, 4, 7, 5,
+                3, 0, 6, 5, 3,
+                5, 6, 0, 3, 6;
+    // clang-format on
+    IndexMatrixX Ctet(4, 5 * kCubes);
+    IndexMatrixX Chex(8, kCubes);
+    for (auto cube = 0; cube < kCubes; ++cube)
+    {
+        for (auto t = 0; t < 5; ++t)
+            for (auto v = 0; v < 4; ++v)
+                Ctet(v, 5 * cube + t) = vertexOf(cube, cubeTets(v, t));
+        for (auto l = 0; l < 8; ++l)
+            Chex(l, cube) = vertexOf(cube, l);
+    }
+
+    auto const checkMatchesReference = [&]<class ElementType>(IndexMatrixX const& C) {
+        fem::Mesh<ElementType, 3> const mesh(V, C);
+        auto const [Xexpected, Eexpected] = referenceMesh.template operator()<ElementType>(V, C);
+        CHECK(mesh.E == Eexpected);
+        CHECK(mesh.X == Xexpected);
+    };
+    common::ForRange<2, 4>([&]<auto kOrder>() {
+        checkMatchesReference.template operator()<fem::Tetrahedron<kOrder>>(Ctet);
+        checkMatchesReference.template operator()<fem::Hexahedron<kOrder>>(Chex);
+    });
+}
@@ -5,14 +5,18 @@
 #include "Jacobian.h"
 
 #include <algorithm>
+#include <array>
 #include <exception>
-#include <map>
 #include <numeric>
 #include <pbat/Aliases.h>
 #include <pbat/common/Eigen.h>
 #include <pbat/math/Rational.h>
 #include <pbat/profiling/Profiling.h>
 #include <ranges>
+#include <tbb/parallel_for.h>
+#include <tbb/parallel_sort.h>
+#include <utility>
+#include <vector>
 
 namespace pbat {
 namespace fem {
@@ -152,58 +156,99 @@ Mesh<TElement, Dims>::Mesh(
         assert(C.rows() == kVerticesPerCell);
         assert(V.rows() == kDims);
 
-        using NodeMap = std::map<NodalKey<ElementType>, Index>;
+        auto const numberOfCells     = C.cols();
+        auto constexpr kNodesPerCell = ElementType::kNodes;
+        auto const numberOfCellNodes = static_cast<std::size_t>(kNodesPerCell * numberOfCells);
 
-        auto const numberOfCells    = C.cols();
-        auto const numberOfVertices = V.cols();
-
-        NodeMap nodeMap{};
-        std::vector<Vector<kDims>> nodes{};
-        nodes.reserve(static_cast<std::size_t>(numberOfVertices));
-
-        // Construct mesh topology, i.e. assign mesh nodes to elements,
-        // ensuring that adjacent elements share their common nodes.
-        E.resize(ElementType::kNodes, numberOfCells);
-        for (auto c = 0; c < numberOfCells; ++c)
+        // Use exact rational arithmetic to evaluate affine element shape functions at the nodes to
+        // get their exact affine coordinates, and rebase them onto the common denominator
+        // kOrder^{kDims} to obtain integer affine weights in [0, kWeightBase)
+        auto constexpr kDenominator = []() {
+            Index denominator{1};
+            for (auto d = 0; d < ElementType::kDims; ++d)
+                denominator *= kOrder;
+            return denominator;
+        }();
+        auto constexpr kWeightBase  = kDenominator + 1;
+        auto const nodalCoordinates = common::ToEigen(ElementType::Coordinates)
+                                          .reshaped(ElementType::kDims, kNodesPerCell)
+                                          .template cast<math::Rational>() /
+                                      ElementType::kOrder;
+        Matrix<kVerticesPerCell, kNodesPerCell> N{};
+        IndexMatrix<kVerticesPerCell, kNodesPerCell> W{};
+        for (auto i = 0; i < kNodesPerCell; ++i)
         {
-            IndexVector<kVerticesPerCell> const cellVertices = C.col(c);
-            Matrix<kDims, kVerticesPerCell> const Xc         = V(Eigen::all, cellVertices);
+            auto const Ni = AffineElementType::N(nodalCoordinates.col(i));
+            N.col(i)      = Ni.template cast<Scalar>();
+            for (auto v = 0; v < kVerticesPerCell; ++v)
+            {
+                math::Rational w = Ni(v);
+                [[maybe_unused]] bool const bIsRebased = w.Rebase(kDenominator);
+                assert(bIsRebased);
+                W(v, i) = static_cast<Index>(w.a);
+            }
+        }
 
+        // Each cell node emits a canonical integer key, i.e. the cell vertices with non-zero affine
+        // weight in ascending order, each combined with its weight, padded with -1. Cell nodes
+        // with equal keys represent the same mesh node.
+        using NodalKeyType = std::array<Index, kVerticesPerCell>;
+        std::vector<std::pair<NodalKeyType, Index>> keys(numberOfCellNodes);
+        tbb::parallel_for(Index{0}, Index{numberOfCells}, [&](Index c) {
+            IndexVector<kVerticesPerCell> const cellVertices = C.col(c);
             // Sort based on cell vertex index
             IndexVector<kVerticesPerCell> sortOrder{};
             std::iota(sortOrder.begin(), sortOrder.end(), 0);
             std::ranges::sort(sortOrder, [&](Index i, Index j) {
                 return cellVertices[i] < cellVertices[j];
             });
-            // Loop over nodes of element and create the node on first visit
-            auto const nodalCoordinates = common::ToEigen(ElementType::Coordinates)
-                                              .reshaped(ElementType::kDims, ElementType::kNodes)
-                                              .template cast<math::Rational>() /
-                                          ElementType::kOrder;
-            for (auto i = 0; i < nodalCoordinates.cols(); ++i)
+            for (auto i = 0; i < kNodesPerCell; ++i)
             {
-                // Use exact rational arithmetic to evaluate affine element shape functions at the
-                // node to get its exact affine coordinates
-                auto const Xi = nodalCoordinates.col(i);
-                auto const N  = AffineElementType::N(Xi);
-                NodalKey<ElementType> const key{cellVertices, sortOrder, N};
-                auto it                        = nodeMap.find(key);
-                bool const bNodeAlreadyCreated = it != nodeMap.end();
-                if (!bNodeAlreadyCreated)
-                {
-                    auto const nodeIdx     = static_cast<Index>(nodes.size());
-                    Vector<kDims> const xi = Xc * N.template cast<Scalar>();
-                    nodes.push_back(xi);
-                    bool bInserted{};
-                    std::tie(it, bInserted) = nodeMap.insert({key, nodeIdx});
-                    assert(bInserted);
-                }
-                Index const node = it->second;
-                E(i, c)          = node;
+                auto const k    = c * kNodesPerCell + i;
+                auto& [key, ck] = keys[static_cast<std::size_t>(k)];
+                key.fill(Index{-1});
+                auto size = 0;
+                for (Index o : sortOrder)
+                    if (W(o, i) != 0)
+                        key[static_cast<std::size_t>(size++)] =
+                            cellVertices[o] * kWeightBase + W(o, i);
+                ck = k;
             }
+        });
+        // Group equal keys, ordering each group by cell node index
+        tbb::parallel_sort(keys.begin(), keys.end());
+        // Each cell node maps to the first cell node of its group, i.e. the node's first visit
+        std::vector<Index> firstVisit(numberOfCellNodes);
+        for (auto j = 0ULL; j < keys.size(); ++j)
+        {
+            bool const bIsFirstOfGroup = (j == 0) or (keys[j].first != keys[j - 1].first);
+            auto const k               = static_cast<std::size_t>(keys[j].second);
+            firstVisit[k] = bIsFirstOfGroup ?
+                                keys[j].second :
+                                firstVisit[static_cast<std::size_t>(keys[j - 1].second)];
         }
-        // Collect node positions
-        X = common::ToEigen(nodes);
+        // Number nodes in order of first visit, as if cells were traversed serially
+        std::vector<Index> nodeOfFirstVisit(numberOfCellNodes, Index{-1});
+        Index numberOfNodes{0};
+        for (auto k = 0ULL; k < numberOfCellNodes; ++k)
+            if (firstVisit[k] == static_cast<Index>(k))
+                nodeOfFirstVisit[k] = numberOfNodes++;
+
+        // Construct mesh topology, i.e. assign mesh nodes to elements, ensuring that adjacent
+        // elements share their common nodes, and compute node positions from their first visit.
+        E.resize(kNodesPerCell, numberOfCells);
+        X.resize(kDims, numberOfNodes);
+        tbb::parallel_for(Index{0}, Index{numberOfCells}, [&](Index c) {
+            Matrix<kDims, kVerticesPerCell> const Xc = V(Eigen::all, C.col(c));
+            for (auto i = 0; i < kNodesPerCell; ++i)
+            {
+                auto const k  = static_cast<std::size_t>(c * kNodesPerCell + i);
+                auto const fk = static_cast<std::size_t>(firstVisit[k]);
+                E(i, c)       = nodeOfFirstVisit[fk];
+                if (fk == k)
+                    X.col(E(i, c)) = Xc * N.col(i);
+            }
+        });
     }
 }
 
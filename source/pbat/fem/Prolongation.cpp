@@ -0,0 +1,111 @@
+#include "Prolongation.h"
+
+#include "Jacobian.h"
+#include "LaplacianMatrix.h"
+#include "MassMatrix.h"
+#include "Mesh.h"
+#include "ShapeFunctions.h"
+#include "Tetrahedron.h"
+
+#include <doctest/doctest.h>
+#include <pbat/math/linalg/ConjugateGradient.h>
+#include <pbat/math/linalg/Multigrid.h>
+
+namespace pbat {
+namespace test {
+
+struct SparseMatrixOperator
+{
+    template <class TDerivedIn, class TDerivedOut>
+    void Apply(Eigen::MatrixBase<TDerivedIn> const& x, Eigen::DenseBase<TDerivedOut>& y) const
+    {
+        y += A * x;
+    }
+
+    CSCMatrix ToMatrix() const { return A; }
+    Index OutputDimensions() const { return A.rows(); }
+    Index InputDimensions() const { return A.cols(); }
+
+    CSCMatrix A;
+};
+
+} // namespace test
+} // namespace pbat
+
+TEST_CASE("[fem] Prolongation")
+{
+    using namespace pbat;
+
+    // Cube tetrahedral mesh
+    MatrixX V(3, 8);
+    IndexMatrixX C(4, 5);
+    // clang-format off
+    V << 0., 1., 0., 1., 0., 1., 0., 1.,
+         0., 0., 1., 1., 0., 0., 1., 1.,
+         0., 0., 0., 0., 1., 1., 1., 1.;
+    C << 0, 3, 5, 6, 0,
+         1, 2, 4, 7, 5,
+         3, 0, 6, 5, 3,
+         5, 6, 0, 3, 6;
+    // clang-format on
+
+    // Linear coarse level and quadratic fine level on the same cube, i.e. nested levels
+    auto constexpr kDims = 3;
+    using CoarseMesh     = fem::Mesh<fem::Tetrahedron<1>, kDims>;
+    using FineMesh       = fem::Mesh<fem::Tetrahedron<2>, kDims>;
+    CoarseMesh const coarse(V, C);
+    FineMesh const fine(V, C);
+    Scalar constexpr zero = 1e-10;
+
+    for (auto dims = 1; dims < 4; ++dims)
+    {
+        CSCMatrix const P = fem::ProlongationMatrix(coarse, fine, dims);
+        CHECK_EQ(P.rows(), dims * fine.X.cols());
+        CHECK_EQ(P.cols(), dims * coarse.X.cols());
+        // Shape functions are a partition of unity
+        VectorX const rowSums = P * VectorX::Ones(P.cols());
+        CHECK_LE((rowSums - VectorX::Ones(P.rows())).norm(), zero);
+    }
+
+    // Linear functions are reproduced exactly on nested levels
+    CSCMatrix const P          = fem::ProlongationMatrix(coarse, fine, kDims);
+    VectorX const Xfine        = P * coarse.X.reshaped();
+    Scalar const transferError = (Xfine - fine.X.reshaped()).norm() / fine.X.norm();
+    CHECK_LE(transferError, zero);
+
+    // Evaluating at the coarse nodes themselves yields the identity
+    IndexVectorX E(coarse.X.cols());
+    for (auto e = 0; e < coarse.E.cols(); ++e)
+        E(coarse.E.col(e)).setConstant(e);
+    CSCMatrix const I = fem::ProlongationMatrix(coarse, E, coarse.X);
+    CSCMatrix Iexpected(coarse.X.cols(), coarse.X.cols());
+    Iexpected.setIdentity();
+    CHECK_LE((I - Iexpected).norm(), zero);
+    CHECK_THROWS_AS(
+        fem::ProlongationMatrix(coarse, E.head(E.size() - 1), coarse.X),
+        std::invalid_argument);
+
+    // Two-level p-multigrid preconditioning of the fine level's reaction-diffusion operator
+    auto constexpr kMassQuadratureOrder      = 4;
+    auto constexpr kLaplacianQuadratureOrder = 2;
+    MatrixX const detJeM = fem::DeterminantOfJacobian<kMassQuadratureOrder>(fine);
+    MatrixX const detJeL = fem::DeterminantOfJacobian<kLaplacianQuadratureOrder>(fine);
+    MatrixX const GNeL   = fem::ShapeFunctionGradients<kLaplacianQuadratureOrder>(fine);
+    CSCMatrix const M =
+        fem::MassMatrix<FineMesh, kMassQuadratureOrder>(fine, detJeM, 1., 1).ToMatrix();
+    CSCMatrix const L =
+        fem::SymmetricLaplacianMatrix<FineMesh, kLaplacianQuadratureOrder>(fine, detJeL, GNeL, 1)
+            .ToMatrix();
+    test::SparseMatrixOperator const A{M - L};
+    CSCMatrix const P1 = fem::ProlongationMatrix(coarse, fine);
+    math::linalg::Multigrid mg(A.A, {P1});
+    CHECK_EQ(mg.NumberOfLevels(), 2);
+    VectorX const b            = VectorX::Ones(A.A.rows());
+    Scalar constexpr tolerance = 1e-10;
+    VectorX x                  = VectorX::Zero(b.size());
+    CHECK(mg.Solve(b, x, 50, tolerance));
+    x.setZero();
+    math::linalg::ConjugateGradient cg(100, tolerance);
+    CHECK(cg.Solve(A, mg, b, x));
+    CHECK_LE((b - A.A * x).norm() / b.norm(), 10 * tolerance);
+}
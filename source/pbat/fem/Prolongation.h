@@ -0,0 +1,117 @@
+#ifndef PBAT_FEM_PROLONGATION_H
+#define PBAT_FEM_PROLONGATION_H
+
+#include "Concepts.h"
+#include "Jacobian.h"
+
+#include <exception>
+#include <fmt/core.h>
+#include <pbat/Aliases.h>
+#include <pbat/geometry/TetrahedralAabbHierarchy.h>
+#include <pbat/profiling/Profiling.h>
+#include <string>
+#include <tbb/parallel_for.h>
+#include <vector>
+
+namespace pbat {
+namespace fem {
+
+/**
+ * @brief Computes the matrix P which interpolates finite element functions on mesh at the points
+ * X, i.e. u(X) = P u for nodal coefficients u.
+ *
+ * When X are the nodes of a finer mesh, P is the multigrid prolongation from mesh to the finer
+ * mesh, and P^T the corresponding restriction. Points outside of their element, i.e. of
+ * non-nested meshes, are extrapolated from that element.
+ *
+ * @tparam TMesh
+ * @tparam TDerivedE
+ * @tparam TDerivedX
+ * @param mesh The finite element mesh, i.e. the coarse level
+ * @param E |X.cols()| indices of the elements of mesh in which to evaluate each point
+ * @param X |TMesh::kDims| x |#points| evaluation points, i.e. the fine level nodes
+ * @param dims Dimensionality of the interpolated functions, i.e. each of the dims coefficients of
+ * a node is interpolated independently
+ * @return |dims * #points| x |dims * #nodes| prolongation matrix
+ */
+template <CMesh TMesh, class TDerivedE, class TDerivedX>
+CSCMatrix ProlongationMatrix(
+    TMesh const& mesh,
+    Eigen::DenseBase<TDerivedE> const& E,
+    Eigen::MatrixBase<TDerivedX> const& X,
+    int dims = 1)
+{
+    PBAT_PROFILE_NAMED_SCOPE("pbat.fem.ProlongationMatrix");
+    using ElementType     = typename TMesh::ElementType;
+    auto constexpr kNodes = ElementType::kNodes;
+    auto const nPoints    = X.cols();
+    if (E.size() != nPoints or X.rows() != TMesh::kDims)
+    {
+        std::string const what = fmt::format(
+            "Expected {} x |#points| evaluation points X and |#points| elements E, but got "
+            "X={}x{} and E.size()={}",
+            TMesh::kDims,
+            X.rows(),
+            X.cols(),
+            E.size());
+        throw std::invalid_argument(what);
+    }
+    if (dims < 1)
+    {
+        std::string const what = fmt::format("Expected dims >= 1, but got {}", dims);
+        throw std::invalid_argument(what);
+    }
+    MatrixX const Xi = ReferencePositions(mesh, E, X);
+    std::vector<Eigen::Triplet<Scalar, Index>> triplets(
+        static_cast<std::size_t>(nPoints * kNodes * dims));
+    tbb::parallel_for(Index{0}, Index{nPoints}, [&](Index k) {
+        auto const nodes        = mesh.E.col(E(k));
+        Vector<kNodes> const Nk = ElementType::N(Xi.col(k));
+        for (auto i = 0; i < kNodes; ++i)
+        {
+            for (auto d = 0; d < dims; ++d)
+            {
+                auto const t = static_cast<std::size_t>((k * kNodes + i) * dims + d);
+                triplets[t]  = {dims * k + d, dims * nodes(i) + d, Nk(i)};
+            }
+        }
+    });
+    CSCMatrix P(dims * nPoints, dims * mesh.X.cols());
+    P.setFromTriplets(triplets.begin(), triplets.end());
+    return P;
+}
+
+/**
+ * @brief Computes the multigrid prolongation from the tetrahedral mesh coarse to the nodes of the
+ * mesh fine, which need not be nested in coarse.
+ *
+ * Each fine node is interpolated in its nearest coarse element, found in parallel using a bounding
+ * volume hierarchy over the coarse elements.
+ *
+ * @tparam TCoarseMesh
+ * @tparam TFineMesh
+ * @param coarse Coarse tetrahedral mesh
+ * @param fine Fine mesh
+ * @param dims Dimensionality of the interpolated functions
+ * @return |dims * #fine nodes| x |dims * #coarse nodes| prolongation matrix
+ */
+template <CMesh TCoarseMesh, CMesh TFineMesh>
+CSCMatrix ProlongationMatrix(TCoarseMesh const& coarse, TFineMesh const& fine, int dims = 1)
+{
+    PBAT_PROFILE_NAMED_SCOPE("pbat.fem.ProlongationMatrix");
+    using CoarseElementType = typename TCoarseMesh::ElementType;
+    static_assert(
+        TCoarseMesh::kDims == 3 and TFineMesh::kDims == 3 and CoarseElementType::kDims == 3 and
+            CoarseElementType::Vertices.size() == 4,
+        "Point location of fine nodes is only supported in coarse tetrahedral meshes in 3D");
+    IndexMatrixX const C = coarse.E(CoarseElementType::Vertices, Eigen::all);
+    geometry::TetrahedralAabbHierarchy const bvh(coarse.X, C);
+    auto const [e, d] = bvh.NearestPrimitivesToPoints(fine.X, true);
+    auto const E      = Eigen::Map<IndexVectorX const>(e.data(), static_cast<Index>(e.size()));
+    return ProlongationMatrix(coarse, E, fine.X, dims);
+}
+
+} // namespace fem
+} // namespace pbat
+
+#endif // PBAT_FEM_PROLONGATION_H
@@ -0,0 +1,100 @@
+#include "Reorder.h"
+
+#include "Jacobian.h"
+#include "MassMatrix.h"
+#include "Mesh.h"
+#include "ShapeFunctions.h"
+#include "Tetrahedron.h"
+
+#include <algorithm>
+#include <doctest/doctest.h>
+#include <exception>
+
+TEST_CASE("[fem] Reorder")
+{
+    using namespace pbat;
+
+    // Grid of 4x3x2 cubes, each split into 5 tetrahedra, with scrambled vertex labels
+    auto constexpr nx = 5, ny = 4, nz = 3;
+    auto constexpr nVertices = nx * ny * nz;
+    auto const label         = [](Index i) { return (7 * i) % nVertices; };
+    MatrixX V(3, nVertices);
+    for (auto z = 0; z < nz; ++z)
+        for (auto y = 0; y < ny; ++y)
+            for (auto x = 0; x < nx; ++x)
+                V.col(label(x + nx * (y + ny * z))) = Vector<3>{Scalar(x), Scalar(y), Scalar(z)};
+    IndexMatrixX cubeTets(4, 5);
+    // clang-format off
+    cubeTets << 0, 3, 5, 6, 0,
+                1, 2, 4, 7, 5,
+                3, 0, 6, 5, 3,
+                5, 6, 0, 3, 6;
+    // clang-format on
+    IndexMatrixX C(4, 5 * (nx - 1) * (ny - 1) * (nz - 1));
+    Index c{0};
+    for (auto z = 0; z + 1 < nz; ++z)
+        for (auto y = 0; y + 1 < ny; ++y)
+            for (auto x = 0; x + 1 < nx; ++x)
+                for (auto t = 0; t < 5; ++t, ++c)
+                    for (auto v = 0; v < 4; ++v)
+                    {
+                        auto const l = cubeTets(v, t);
+                        C(v, c)      = label(x + l % 2 + nx * (y + (l / 2) % 2 + ny * (z + l / 4)));
+                    }
+
+    using Mesh = fem::Mesh<fem::Tetrahedron<1>, 3>;
+    Mesh const mesh(V, C);
+    auto const bandwidth = [](Mesh const& M) {
+        Index b{0};
+        for (auto e = 0; e < M.E.cols(); ++e)
+            b = std::max(b, M.E.col(e).maxCoeff() - M.E.col(e).minCoeff());
+        return b;
+    };
+
+    // Act
+    Mesh reordered(V, C);
+    fem::MeshOrdering const ordering = fem::Reorder(reordered);
+
+    // Assert
+    auto const nNodes    = mesh.X.cols();
+    auto const nElements = mesh.E.cols();
+    IndexVectorX nodes   = ordering.nodes;
+    IndexVectorX elems   = ordering.elements;
+    std::sort(nodes.begin(), nodes.end());
+    std::sort(elems.begin(), elems.end());
+    CHECK(nodes == IndexVectorX::LinSpaced(nNodes, Index(0), nNodes - 1));
+    CHECK(elems == IndexVectorX::LinSpaced(nElements, Index(0), nElements - 1));
+    CHECK((ordering.InverseNodes()(ordering.nodes).array() ==
+           IndexVectorX::LinSpaced(nNodes, Index(0), nNodes - 1).array())
+              .all());
+    // Reordered elements have the same geometry
+    for (auto e = 0; e < nElements; ++e)
+    {
+        MatrixX const Xe         = reordered.X(Eigen::all, reordered.E.col(e));
+        MatrixX const XeExpected = mesh.X(Eigen::all, mesh.E.col(ordering.elements(e)));
+        CHECK(Xe == XeExpected);
+    }
+    CHECK_LT(bandwidth(reordered), bandwidth(mesh));
+    // Mass matrix of reordered mesh is the permuted mass matrix
+    auto constexpr kQuadratureOrder = 2;
+    MatrixX const detJe     = fem::DeterminantOfJacobian<kQuadratureOrder>(mesh);
+    MatrixX const detJeR    = fem::DeterminantOfJacobian<kQuadratureOrder>(reordered);
+    MatrixX const detJeP    = fem::ReorderElementColumns(detJe, ordering.elements);
+    Scalar constexpr zero   = 1e-10;
+    Scalar const detJeError = (detJeP - detJeR).norm() / detJeR.norm();
+    CHECK_LE(detJeError, zero);
+    MatrixX const M  = fem::MassMatrix<Mesh, kQuadratureOrder>(mesh, detJe).ToMatrix();
+    MatrixX const MR = fem::MassMatrix<Mesh, kQuadratureOrder>(reordered, detJeR).ToMatrix();
+    MatrixX const MP = M(ordering.nodes, ordering.nodes);
+    Scalar const massError = (MP - MR).norm() / MR.norm();
+    CHECK_LE(massError, zero);
+    // Shape function gradients follow the element ordering
+    MatrixX const GNe      = fem::ShapeFunctionGradients<1>(mesh);
+    MatrixX const GNeR     = fem::ShapeFunctionGradients<1>(reordered);
+    MatrixX const GNeP     = fem::ReorderElementColumns(GNe, ordering.elements);
+    Scalar const gradError = (GNeP - GNeR).norm() / GNeR.norm();
+    CHECK_LE(gradError, zero);
+    CHECK_THROWS_AS(
+        fem::ReorderElementColumns(GNe, ordering.elements.head(nElements - 1)),
+        std::invalid_argument);
+}
@@ -0,0 +1,215 @@
+#ifndef PBAT_FEM_REORDER_H
+#define PBAT_FEM_REORDER_H
+
+#include "Concepts.h"
+
+#include <algorithm>
+#include <array>
+#include <exception>
+#include <fmt/core.h>
+#include <limits>
+#include <numeric>
+#include <pbat/Aliases.h>
+#include <pbat/geometry/Morton.h>
+#include <pbat/graph/Adjacency.h>
+#include <pbat/graph/Ordering.h>
+#include <pbat/profiling/Profiling.h>
+#include <string>
+#include <tbb/parallel_for.h>
+#include <vector>
+
+namespace pbat {
+namespace fem {
+
+enum class ENodeOrdering {
+    None,               ///< Keep the input node order
+    ReverseCuthillMcKee ///< Reverse Cuthill-McKee order of the mesh's node graph, i.e. reduces the
+                        ///< bandwidth of FEM operators and the fill of their factorizations
+};
+
+enum class EElementOrdering {
+    None,  ///< Keep the input element order
+    Morton ///< Morton order of element centroids, i.e. spatially close elements are stored close
+           ///< in memory
+};
+
+/**
+ * @brief Node and element permutations of a reordered mesh.
+ *
+ * Orderings map new indices to old indices, i.e. user fields are permuted as
+ * fieldNew = fieldOld(Eigen::all, nodes), and inverse orderings map old indices to new indices.
+ */
+struct MeshOrdering
+{
+    IndexVectorX nodes;    ///< |#nodes| ordering, i.e. nodes(i) is the old index of new node i
+    IndexVectorX elements; ///< |#elements| ordering, i.e. elements(e) is the old index of new
+                           ///< element e
+
+    /**
+     * @brief
+     * @return |#nodes| inverse ordering, i.e. the new index of each old node
+     */
+    IndexVectorX InverseNodes() const { return Inverse(nodes); }
+    /**
+     * @brief
+     * @return |#elements| inverse ordering, i.e. the new index of each old element
+     */
+    IndexVectorX InverseElements() const { return Inverse(elements); }
+
+    static IndexVectorX Inverse(IndexVectorX const& p)
+    {
+        IndexVectorX ip(p.size());
+        ip(p) = IndexVectorX::LinSpaced(p.size(), Index{0}, p.size() - 1);
+        return ip;
+    }
+};
+
+/**
+ * @brief Computes node and element orderings of mesh
+ *
+ * @tparam TMesh
+ * @param mesh The finite element mesh
+ * @param eNodeOrdering Node ordering strategy
+ * @param eElementOrdering Element ordering strategy, applied to element centroids
+ * @return
+ */
+template <CMesh TMesh>
+MeshOrdering ComputeMeshOrdering(
+    TMesh const& mesh,
+    ENodeOrdering eNodeOrdering       = ENodeOrdering::ReverseCuthillMcKee,
+    EElementOrdering eElementOrdering = EElementOrdering::Morton)
+{
+    PBAT_PROFILE_NAMED_SCOPE("pbat.fem.ComputeMeshOrdering");
+    using ElementType           = typename TMesh::ElementType;
+    auto const numberOfNodes    = static_cast<Index>(mesh.X.cols());
+    auto const numberOfElements = static_cast<Index>(mesh.E.cols());
+    MeshOrdering ordering{};
+    switch (eNodeOrdering)
+    {
+        case ENodeOrdering::ReverseCuthillMcKee: {
+            auto const G   = graph::MeshPrimalGraph(mesh.E, numberOfNodes);
+            auto const ptr = Eigen::Map<IndexVectorX const>(G.outerIndexPtr(), G.outerSize() + 1);
+            auto const adj = Eigen::Map<IndexVectorX const>(G.innerIndexPtr(), G.nonZeros());
+            ordering.nodes = graph::ReverseCuthillMcKee(ptr, adj);
+            break;
+        }
+        default:
+            ordering.nodes = IndexVectorX::LinSpaced(numberOfNodes, Index{0}, numberOfNodes - 1);
+            break;
+    }
+    ordering.elements.resize(numberOfElements);
+    std::iota(ordering.elements.begin(), ordering.elements.end(), Index{0});
+    if (eElementOrdering == EElementOrdering::Morton and numberOfElements > 0)
+    {
+        // Compute Morton codes of element centroids in the mesh's normalized bounding box
+        auto constexpr kDims       = TMesh::kDims;
+        auto constexpr kVertices   = ElementType::Vertices.size();
+        Vector<kDims> const xmin   = mesh.X.rowwise().minCoeff();
+        Vector<kDims> const xmax   = mesh.X.rowwise().maxCoeff();
+        Vector<kDims> const extent = (xmax - xmin).cwiseMax(std::numeric_limits<Scalar>::min());
+        std::vector<geometry::MortonCodeType> morton(static_cast<std::size_t>(numberOfElements));
+        tbb::parallel_for(Index{0}, numberOfElements, [&](Index e) {
+            auto const vertices = mesh.E.col(e)(ElementType::Vertices);
+            Vector<kDims> const xe =
+                (mesh.X(Eigen::all, vertices).rowwise().sum() / static_cast<Scalar>(kVertices) -
+                 xmin)
+                    .cwiseQuotient(extent);
+            std::array<float, 3> xm{0.f, 0.f, 0.f};
+            for (auto d = 0; d < kDims; ++d)
+                xm[static_cast<std::size_t>(d)] = static_cast<float>(xe(d));
+            morton[static_cast<std::size_t>(e)] = geometry::Morton3D(xm);
+        });
+        std::stable_sort(ordering.elements.begin(), ordering.elements.end(), [&](Index i, Index j) {
+            return morton[static_cast<std::size_t>(i)] < morton[static_cast<std::size_t>(j)];
+        });
+    }
+    return ordering;
+}
+
+/**
+ * @brief Renumbers the nodes and elements of mesh by the given ordering
+ *
+ * @tparam TMesh
+ * @param mesh The finite element mesh
+ * @param ordering Node and element orderings of mesh
+ */
+template <CMesh TMesh>
+void ApplyMeshOrdering(TMesh& mesh, MeshOrdering const& ordering)
+{
+    PBAT_PROFILE_NAMED_SCOPE("pbat.fem.ApplyMeshOrdering");
+    bool const bHasMatchingDimensions = (ordering.nodes.size() == mesh.X.cols()) and
+                                        (ordering.elements.size() == mesh.E.cols());
+    if (not bHasMatchingDimensions)
+    {
+        std::string const what = fmt::format(
+            "Expected orderings of |#nodes|={} nodes and |#elements|={} elements, but got {} and "
+            "{}",
+            mesh.X.cols(),
+            mesh.E.cols(),
+            ordering.nodes.size(),
+            ordering.elements.size());
+        throw std::invalid_argument(what);
+    }
+    IndexVectorX const newNodes = ordering.InverseNodes();
+    auto const Renumber         = [&](Index i) { return newNodes(i); };
+    mesh.X                      = mesh.X(Eigen::all, ordering.nodes).eval();
+    mesh.E                      = mesh.E(Eigen::all, ordering.elements).unaryExpr(Renumber).eval();
+}
+
+/**
+ * @brief Computes node and element orderings of mesh and renumbers mesh accordingly
+ *
+ * @tparam TMesh
+ * @param mesh The finite element mesh
+ * @param eNodeOrdering Node ordering strategy
+ * @param eElementOrdering Element ordering strategy
+ * @return The applied orderings, i.e. to map user fields onto the reordered mesh
+ */
+template <CMesh TMesh>
+MeshOrdering Reorder(
+    TMesh& mesh,
+    ENodeOrdering eNodeOrdering       = ENodeOrdering::ReverseCuthillMcKee,
+    EElementOrdering eElementOrdering = EElementOrdering::Morton)
+{
+    PBAT_PROFILE_NAMED_SCOPE("pbat.fem.Reorder");
+    MeshOrdering ordering = ComputeMeshOrdering(mesh, eNodeOrdering, eElementOrdering);
+    ApplyMeshOrdering(mesh, ordering);
+    return ordering;
+}
+
+/**
+ * @brief Permutes per-element column blocks of A, i.e. element quantities such as jacobian
+ * determinants detJe or shape function gradients GNe, by the element ordering.
+ *
+ * @tparam TDerived
+ * @param A Matrix whose columns are |#elements| contiguous blocks of equal size
+ * @param elements |#elements| element ordering, i.e. see MeshOrdering::elements
+ * @return
+ */
+template <class TDerived>
+MatrixX ReorderElementColumns(
+    Eigen::MatrixBase<TDerived> const& A,
+    Eigen::Ref<IndexVectorX const> const& elements)
+{
+    PBAT_PROFILE_NAMED_SCOPE("pbat.fem.ReorderElementColumns");
+    auto const numberOfElements = elements.size();
+    if (numberOfElements == 0 or A.cols() % numberOfElements != 0)
+    {
+        std::string const what = fmt::format(
+            "Expected number of columns to be a positive multiple of |#elements|={}, but got {}",
+            numberOfElements,
+            A.cols());
+        throw std::invalid_argument(what);
+    }
+    auto const blockSize = A.cols() / numberOfElements;
+    MatrixX Ap(A.rows(), A.cols());
+    tbb::parallel_for(Index{0}, Index{numberOfElements}, [&](Index e) {
+        Ap.middleCols(e * blockSize, blockSize) = A.middleCols(elements(e) * blockSize, blockSize);
+    });
+    return Ap;
+}
+
+} // namespace fem
+} // namespace pbat
+
+#endif // PBAT_FEM_REORDER_H
@@ -176,5 +176,27 @@ TEST_CASE("[fem] ShapeFunctionGradientsAt")
         Scalar const GNeError     = (GNe - GNeExpected).squaredNorm();
         Scalar constexpr zero     = 1e-15;
         CHECK_LE(GNeError, zero);
+
+        // Compact gradients of affine elements match gradients at quadrature points
+        MatrixX const GNeCompact = fem::CompactShapeFunctionGradients(mesh);
+        CHECK_EQ(GNeCompact.cols(), kDims * numberOfElements);
+        using GradientsType = fem::ElementShapeFunctionGradients<MeshType, kQuadratureOrder>;
+        auto const eStorage = GradientsType::Storage(GNeCompact, numberOfElements);
+        // With a single quadrature point, linear elements' layouts coincide
+        if constexpr (kQuadPts > 1)
+            CHECK_NE(eStorage, fem::EShapeFunctionGradientStorage::QuadraturePoint);
+        GradientsType const gradPhiAt(GNeCompact, numberOfElements);
+        GradientsType const gradPhiExpectedAt(GNeExpected, numberOfElements);
+        for (auto e = 0; e < numberOfElements; ++e)
+        {
+            for (auto g = 0; g < kQuadPts; ++g)
+            {
+                Scalar const compactError = (gradPhiAt(e, g) - gradPhiExpectedAt(e, g)).norm();
+                CHECK_LE(compactError, 1e-10);
+            }
+        }
+        CHECK_THROWS_AS(
+            GradientsType::Storage(GNeCompact, numberOfElements + 1),
+            std::invalid_argument);
     });
 }
\ No newline at end of file
@@ -12,6 +12,7 @@
 #include <pbat/profiling/Profiling.h>
 #include <string>
 #include <tbb/parallel_for.h>
+#include <type_traits>
 
 namespace pbat {
 namespace fem {
@@ -271,6 +272,197 @@ MatrixX ShapeFunctionGradients(TMesh const& mesh)
     return GNe;
 }
 
+/**
+ * @brief Storage layout of shape function gradients at element quadrature points
+ */
+enum class EShapeFunctionGradientStorage {
+    QuadraturePoint, ///< |#element nodes| x |MeshType::kDims * #quad.pts. * #elements| gradients at
+                     ///< each element quadrature point, i.e. see ShapeFunctionGradients()
+    Element,         ///< |#element nodes| x |MeshType::kDims * #elements| constant gradients of
+                     ///< linear simplices, i.e. see CompactShapeFunctionGradients()
+    InverseJacobian  ///< |ElementType::kDims| x |MeshType::kDims * #elements| (pseudo-)inverse
+                     ///< jacobians of affine elements, i.e. see CompactShapeFunctionGradients()
+};
+
+/**
+ * @brief Computes a compact representation of nodal shape function gradients of simplex meshes,
+ * whose elements are affine maps of the reference element.
+ *
+ * Linear elements have constant shape function gradients, which are stored once per element.
+ * Higher order elements store one (pseudo-)inverse jacobian J^+ per element instead, such that
+ * gradients at reference point Xi are ElementType::GradN(Xi) * J^+. Either way, memory is reduced
+ * by (at least) a factor |#quad.pts.| w.r.t. ShapeFunctionGradients().
+ *
+ * @tparam TMesh
+ * @param mesh
+ * @return |#element nodes| x |MeshType::kDims * #elements| element shape function gradients for
+ * linear elements, and |ElementType::kDims| x |MeshType::kDims * #elements| element inverse
+ * jacobians otherwise (see EShapeFunctionGradientStorage)
+ */
+template <CMesh TMesh>
+MatrixX CompactShapeFunctionGradients(TMesh const& mesh)
+{
+    PBAT_PROFILE_NAMED_SCOPE("pbat.fem.CompactShapeFunctionGradients");
+    using MeshType          = TMesh;
+    using ElementType       = typename MeshType::ElementType;
+    using AffineElementType = typename ElementType::AffineBaseType;
+    static_assert(
+        AffineElementType::bHasConstantJacobian,
+        "Compact shape function gradients require elements with constant jacobians");
+    auto constexpr kDims            = MeshType::kDims;
+    auto constexpr kRefDims         = ElementType::kDims;
+    auto constexpr kNodesPerElement = ElementType::kNodes;
+    bool constexpr bIsElementLinear = std::is_same_v<ElementType, AffineElementType>;
+    auto const numberOfElements     = mesh.E.cols();
+    // Jacobians are constant, so any reference point will do
+    Vector<kRefDims> const Xi = Vector<kRefDims>::Zero();
+    MatrixX GNe(bIsElementLinear ? kNodesPerElement : kRefDims, kDims * numberOfElements);
+    tbb::parallel_for(Index{0}, Index{numberOfElements}, [&](Index e) {
+        auto const vertices                                = mesh.E.col(e)(ElementType::Vertices);
+        Matrix<kDims, AffineElementType::kNodes> const Ve = mesh.X(Eigen::all, vertices);
+        if constexpr (bIsElementLinear)
+        {
+            GNe.block<kNodesPerElement, kDims>(0, e * kDims) =
+                ShapeFunctionGradients<ElementType>(Xi, Ve);
+        }
+        else
+        {
+            // See ShapeFunctionGradients(Xi, X) for the derivation of J^+
+            Matrix<kDims, kRefDims> const J = Ve * AffineElementType::GradN(Xi);
+            if constexpr (kRefDims == kDims)
+            {
+                GNe.block<kRefDims, kDims>(0, e * kDims) =
+                    J.fullPivLu().solve(Matrix<kDims, kDims>::Identity());
+            }
+            else
+            {
+                Matrix<kRefDims, kRefDims> const JTJ     = J.transpose() * J;
+                GNe.block<kRefDims, kDims>(0, e * kDims) = JTJ.ldlt().solve(J.transpose());
+            }
+        }
+    });
+    return GNe;
+}
+
+/**
+ * @brief Shape function gradients at element quadrature points, read from any storage layout (see
+ * EShapeFunctionGradientStorage), which is deduced from the dimensions of the stored gradients.
+ *
+ * @tparam TMesh
+ * @tparam QuadratureOrder
+ */
+template <CMesh TMesh, int QuadratureOrder>
+class ElementShapeFunctionGradients
+{
+  public:
+    using MeshType           = TMesh;
+    using ElementType        = typename MeshType::ElementType;
+    using AffineElementType  = typename ElementType::AffineBaseType;
+    using QuadratureRuleType = typename ElementType::template QuadratureType<QuadratureOrder>;
+
+    static int constexpr kDims            = MeshType::kDims;
+    static int constexpr kRefDims         = ElementType::kDims;
+    static int constexpr kNodesPerElement = ElementType::kNodes;
+    static int constexpr kQuadPts         = QuadratureRuleType::kPoints;
+
+    /**
+     * @brief
+     * @param GNe Shape function gradients in any storage layout
+     * @param nElements Number of mesh elements
+     */
+    ElementShapeFunctionGradients(Eigen::Ref<MatrixX const> const& GNe, Index nElements);
+
+    /**
+     * @brief Shape function gradients of element e at its quadrature point g
+     * @param e Element index
+     * @param g Quadrature point index
+     * @return |#element nodes| x |MeshType::kDims| shape function gradients
+     */
+    Matrix<kNodesPerElement, kDims> operator()(Index e, Index g) const;
+
+    /**
+     * @brief Deduces the storage layout of shape function gradients GNe
+     * @param GNe Shape function gradients
+     * @param nElements Number of mesh elements
+     * @return
+     * @throw std::invalid_argument if GNe's dimensions do not match any valid storage layout
+     */
+    static EShapeFunctionGradientStorage
+    Storage(Eigen::Ref<MatrixX const> const& GNe, Index nElements);
+
+  private:
+    Eigen::Ref<MatrixX const> mGNe;         ///< Stored shape function gradients
+    EShapeFunctionGradientStorage mStorage; ///< Storage layout of mGNe
+    Matrix<kNodesPerElement, kRefDims * kQuadPts>
+        mGNg; ///< Reference shape function gradients at quadrature points
+};
+
+template <CMesh TMesh, int QuadratureOrder>
+inline ElementShapeFunctionGradients<TMesh, QuadratureOrder>::ElementShapeFunctionGradients(
+    Eigen::Ref<MatrixX const> const& GNe,
+    Index nElements)
+    : mGNe(GNe), mStorage(Storage(GNe, nElements)), mGNg()
+{
+    if (mStorage != EShapeFunctionGradientStorage::InverseJacobian)
+        return;
+    auto const Xg = common::ToEigen(QuadratureRuleType::points)
+                        .reshaped(QuadratureRuleType::kDims + 1, kQuadPts)
+                        .template bottomRows<kRefDims>();
+    for (auto g = 0; g < kQuadPts; ++g)
+        mGNg.template block<kNodesPerElement, kRefDims>(0, g * kRefDims) =
+            ElementType::GradN(Xg.col(g));
+}
+
+template <CMesh TMesh, int QuadratureOrder>
+inline Matrix<
+    ElementShapeFunctionGradients<TMesh, QuadratureOrder>::kNodesPerElement,
+    ElementShapeFunctionGradients<TMesh, QuadratureOrder>::kDims>
+ElementShapeFunctionGradients<TMesh, QuadratureOrder>::operator()(Index e, Index g) const
+{
+    switch (mStorage)
+    {
+        case EShapeFunctionGradientStorage::Element:
+            return mGNe.template block<kNodesPerElement, kDims>(0, e * kDims);
+        case EShapeFunctionGradientStorage::InverseJacobian:
+            return mGNg.template block<kNodesPerElement, kRefDims>(0, g * kRefDims) *
+                   mGNe.template block<kRefDims, kDims>(0, e * kDims);
+        default:
+            return mGNe.template block<kNodesPerElement, kDims>(
+                0,
+                e * kDims * kQuadPts + g * kDims);
+    }
+}
+
+template <CMesh TMesh, int QuadratureOrder>
+inline EShapeFunctionGradientStorage
+ElementShapeFunctionGradients<TMesh, QuadratureOrder>::Storage(
+    Eigen::Ref<MatrixX const> const& GNe,
+    Index nElements)
+{
+    bool constexpr bHasConstantJacobian = AffineElementType::bHasConstantJacobian;
+    bool constexpr bIsElementLinear     = std::is_same_v<ElementType, AffineElementType>;
+    bool const bHasElementColumns       = GNe.cols() == kDims * nElements;
+    if (GNe.rows() == kNodesPerElement and GNe.cols() == kDims * kQuadPts * nElements)
+        return EShapeFunctionGradientStorage::QuadraturePoint;
+    if (bHasConstantJacobian and bIsElementLinear and GNe.rows() == kNodesPerElement and
+        bHasElementColumns)
+        return EShapeFunctionGradientStorage::Element;
+    if (bHasConstantJacobian and not bIsElementLinear and GNe.rows() == kRefDims and
+        bHasElementColumns)
+        return EShapeFunctionGradientStorage::InverseJacobian;
+    std::string const what = fmt::format(
+        "Expected shape function gradients at element quadrature points of dimensions "
+        "|#nodes-per-element|={} x |#mesh-dims * #quad.pts. * #elemens|={} for polynomiail "
+        "quadrature order={}, or compact shape function gradients of affine elements, but got "
+        "{}x{} instead",
+        kNodesPerElement,
+        kDims * kQuadPts * nElements,
+        QuadratureOrder,
+        GNe.rows(),
+        GNe.cols());
+    throw std::invalid_argument(what);
+}
+
 /**
  * @brief Computes nodal shape function gradients at reference points Xi.
  * @tparam TDerivedE
@@ -78,8 +78,10 @@ class BoundingVolumeHierarchy
 
     /**
      * @brief Update the bounding volumes of this BVH
+     * @param bParallelize Update bounding volumes in parallel, e.g. false if this BVH is small
+     * and updated within a parallel region over many BVHs
      */
-    void Update();
+    void Update(bool bParallelize = true);
 
     // Static virtual functions (CRTP)
     PrimitiveType Primitive(Index p) const
@@ -145,13 +147,23 @@ BoundingVolumeHierarchy<TDerived, TBoundingVolume, TPrimitive, Dims>::Primitives
 }
 
 template <class TDerived, class TBoundingVolume, class TPrimitive, int Dims>
-inline void BoundingVolumeHierarchy<TDerived, TBoundingVolume, TPrimitive, Dims>::Update()
+inline void
+BoundingVolumeHierarchy<TDerived, TBoundingVolume, TPrimitive, Dims>::Update(bool bParallelize)
 {
-    auto const& nodes = mKdTree.Nodes();
-    tbb::parallel_for(std::size_t{0ULL}, nodes.size(), [&](std::size_t bvIdx) {
+    auto const& nodes       = mKdTree.Nodes();
+    auto const UpdateVolume = [&](std::size_t bvIdx) {
         KdTreeNode const& node  = nodes[bvIdx];
         mBoundingVolumes[bvIdx] = BoundingVolumeOf(mKdTree.PointsInNode(node));
-    });
+    };
+    if (bParallelize)
+    {
+        tbb::parallel_for(std::size_t{0ULL}, nodes.size(), UpdateVolume);
+    }
+    else
+    {
+        for (std::size_t bvIdx = 0ULL; bvIdx < nodes.size(); ++bvIdx)
+            UpdateVolume(bvIdx);
+    }
 }
 
 template <class TDerived, class TBoundingVolume, class TPrimitive, int Dims>
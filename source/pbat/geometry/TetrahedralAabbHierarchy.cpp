@@ -46,10 +46,10 @@ TetrahedralAabbHierarchy::PrimitiveLocation(PrimitiveType const& primitive) cons
     return V(Eigen::all, primitive).rowwise().mean();
 }
 
-void TetrahedralAabbHierarchy::Update()
+void TetrahedralAabbHierarchy::Update(bool bParallelize)
 {
     PBAT_PROFILE_NAMED_SCOPE("pbat.geometry.TetrahedralAabbHierarchy.Update");
-    BaseType::Update();
+    BaseType::Update(bParallelize);
 }
 
 IndexMatrixX TetrahedralAabbHierarchy::OverlappingPrimitives(
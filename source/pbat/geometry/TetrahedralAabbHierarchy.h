@@ -41,7 +41,7 @@ class TetrahedralAabbHierarchy : public BoundingVolumeHierarchy<
     template <class RPrimitiveIndices>
     BoundingVolumeType BoundingVolumeOf(RPrimitiveIndices&& pinds) const;
 
-    PBAT_API void Update();
+    PBAT_API void Update(bool bParallelize = true);
 
     PBAT_API IndexMatrixX
     OverlappingPrimitives(TetrahedralAabbHierarchy const& bvh, std::size_t reserve = 1000ULL) const;
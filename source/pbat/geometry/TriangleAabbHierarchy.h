@@ -52,7 +52,7 @@ class TriangleAabbHierarchy<3> : public BoundingVolumeHierarchy<
     template <class RPrimitiveIndices>
     BoundingVolumeType BoundingVolumeOf(RPrimitiveIndices&& pinds) const;
 
-    void Update();
+    void Update(bool bParallelize = true);
 
     IndexMatrixX OverlappingPrimitives(SelfType const& bvh, std::size_t reserve = 1000ULL) const;
 
@@ -116,10 +116,10 @@ TriangleAabbHierarchy<3>::PrimitiveLocation(PrimitiveType const& primitive) cons
     return V(Eigen::all, primitive).rowwise().mean();
 }
 
-inline void TriangleAabbHierarchy<3>::Update()
+inline void TriangleAabbHierarchy<3>::Update(bool bParallelize)
 {
     PBAT_PROFILE_NAMED_SCOPE("pbat.geometry.TriangleAabbHierarchy3D.Update");
-    BaseType::Update();
+    BaseType::Update(bParallelize);
 }
 
 inline IndexMatrixX
@@ -279,7 +279,7 @@ class TriangleAabbHierarchy<2> : public BoundingVolumeHierarchy<
     template <class RPrimitiveIndices>
     BoundingVolumeType BoundingVolumeOf(RPrimitiveIndices&& pinds) const;
 
-    void Update();
+    void Update(bool bParallelize = true);
 
     IndexMatrixX OverlappingPrimitives(SelfType const& bvh, std::size_t reserve = 1000ULL) const;
 
@@ -343,10 +343,10 @@ TriangleAabbHierarchy<2>::PrimitiveLocation(PrimitiveType const& primitive) cons
     return V(Eigen::all, primitive).rowwise().mean();
 }
 
-inline void TriangleAabbHierarchy<2>::Update()
+inline void TriangleAabbHierarchy<2>::Update(bool bParallelize)
 {
     PBAT_PROFILE_NAMED_SCOPE("pbat.geometry.TriangleAabbHierarchy2D.Update");
-    BaseType::Update();
+    BaseType::Update(bParallelize);
 }
 
 inline IndexMatrixX
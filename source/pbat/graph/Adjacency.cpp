@@ -0,0 +1,38 @@
+#include "Adjacency.h"
+
+#include <doctest/doctest.h>
+
+TEST_CASE("[graph] Adjacency")
+{
+    using namespace pbat;
+    // Arrange
+    // 2 tetrahedra sharing the face (1,2,3)
+    IndexMatrixX E(4, 2);
+    E.col(0) << 0, 1, 2, 3;
+    E.col(1) << 1, 2, 3, 4;
+    Index const nNodes = 5;
+    // Act
+    auto const A = graph::MeshAdjacencyMatrix(E, nNodes);
+    auto const G = graph::MeshPrimalGraph(E);
+    auto const D = graph::MeshDualGraph(E, nNodes);
+    // Assert
+    CHECK_EQ(A.rows(), nNodes);
+    CHECK_EQ(A.cols(), E.cols());
+    CHECK_EQ(A.nonZeros(), E.size());
+    for (auto e = 0; e < E.cols(); ++e)
+        for (auto ilocal = 0; ilocal < E.rows(); ++ilocal)
+            CHECK_EQ(A.coeff(E(ilocal, e), e), ilocal);
+    CHECK_EQ(G.rows(), nNodes);
+    CHECK_EQ(G.cols(), nNodes);
+    IndexMatrixX const Gexpected = (IndexMatrixX(5, 5) << 0, 1, 1, 1, 0, // 0
+                                    1, 0, 2, 2, 1,                        // 1
+                                    1, 2, 0, 2, 1,                        // 2
+                                    1, 2, 2, 0, 1,                        // 3
+                                    0, 1, 1, 1, 0)                        // 4
+                                       .finished();
+    CHECK(IndexMatrixX(G) == Gexpected);
+    CHECK_EQ(D.rows(), E.cols());
+    CHECK_EQ(D.nonZeros(), 2);
+    CHECK_EQ(D.coeff(0, 1), 3);
+    CHECK_EQ(D.coeff(1, 0), 3);
+}
@@ -0,0 +1,106 @@
+#ifndef PBAT_GRAPH_ADJACENCY_H
+#define PBAT_GRAPH_ADJACENCY_H
+
+#include "pbat/Aliases.h"
+#include "pbat/profiling/Profiling.h"
+
+#include <vector>
+
+namespace pbat {
+namespace graph {
+
+template <class TIndex = Index>
+using AdjacencyMatrix = Eigen::SparseMatrix<TIndex, Eigen::ColMajor, TIndex>;
+
+/**
+ * @brief Computes the |#nodes|x|#elements| node-element adjacency matrix A of the mesh E, i.e.
+ * the column e of A lists the nodes of element e, and A(i,e) is the local index of node i in e.
+ *
+ * NOTE: Local index 0 is stored explicitly, i.e. use the sparsity pattern of A, not its values, to
+ * test for adjacency.
+ *
+ * @tparam TDerivedE
+ * @tparam TIndex
+ * @param E |#nodes per element|x|#elements| array of element nodes
+ * @param nNodes Number of nodes in the mesh. If nNodes < 0, it is deduced from E.
+ * @return
+ */
+template <class TDerivedE, class TIndex = typename TDerivedE::Scalar>
+AdjacencyMatrix<TIndex>
+MeshAdjacencyMatrix(Eigen::DenseBase<TDerivedE> const& E, TIndex nNodes = -1)
+{
+    PBAT_PROFILE_NAMED_SCOPE("pbat.graph.MeshAdjacencyMatrix");
+    if (nNodes < TIndex(0))
+        nNodes = E.size() > 0 ? static_cast<TIndex>(E.maxCoeff()) + TIndex(1) : TIndex(0);
+    using TripletType = Eigen::Triplet<TIndex, TIndex>;
+    std::vector<TripletType> Aie{};
+    Aie.reserve(static_cast<std::size_t>(E.size()));
+    for (auto e = 0; e < E.cols(); ++e)
+        for (auto ilocal = 0; ilocal < E.rows(); ++ilocal)
+            Aie.push_back(TripletType{
+                static_cast<TIndex>(E(ilocal, e)),
+                static_cast<TIndex>(e),
+                static_cast<TIndex>(ilocal)});
+    AdjacencyMatrix<TIndex> A(nNodes, static_cast<TIndex>(E.cols()));
+    A.setFromTriplets(Aie.begin(), Aie.end());
+    return A;
+}
+
+/**
+ * @brief Computes the |#nodes|x|#nodes| adjacency matrix G of the primal graph of the mesh E, i.e.
+ * nodes i != j are adjacent if they share an element, and G(i,j) counts their shared elements.
+ *
+ * @tparam TDerivedE
+ * @tparam TIndex
+ * @param E |#nodes per element|x|#elements| array of element nodes
+ * @param nNodes Number of nodes in the mesh. If nNodes < 0, it is deduced from E.
+ * @return
+ */
+template <class TDerivedE, class TIndex = typename TDerivedE::Scalar>
+AdjacencyMatrix<TIndex> MeshPrimalGraph(Eigen::DenseBase<TDerivedE> const& E, TIndex nNodes = -1)
+{
+    PBAT_PROFILE_NAMED_SCOPE("pbat.graph.MeshPrimalGraph");
+    if (nNodes < TIndex(0))
+        nNodes = E.size() > 0 ? static_cast<TIndex>(E.maxCoeff()) + TIndex(1) : TIndex(0);
+    using TripletType = Eigen::Triplet<TIndex, TIndex>;
+    std::vector<TripletType> Gij{};
+    Gij.reserve(static_cast<std::size_t>(E.cols() * E.rows() * (E.rows() - 1)));
+    for (auto e = 0; e < E.cols(); ++e)
+        for (auto jlocal = 0; jlocal < E.rows(); ++jlocal)
+            for (auto ilocal = 0; ilocal < E.rows(); ++ilocal)
+                if (ilocal != jlocal)
+                    Gij.push_back(TripletType{
+                        static_cast<TIndex>(E(ilocal, e)),
+                        static_cast<TIndex>(E(jlocal, e)),
+                        TIndex(1)});
+    AdjacencyMatrix<TIndex> G(nNodes, nNodes);
+    G.setFromTriplets(Gij.begin(), Gij.end());
+    return G;
+}
+
+/**
+ * @brief Computes the |#elements|x|#elements| adjacency matrix G of the dual graph of the mesh E,
+ * i.e. elements e != f are adjacent if they share a node, and G(e,f) counts their shared nodes.
+ *
+ * @tparam TDerivedE
+ * @tparam TIndex
+ * @param E |#nodes per element|x|#elements| array of element nodes
+ * @param nNodes Number of nodes in the mesh. If nNodes < 0, it is deduced from E.
+ * @return
+ */
+template <class TDerivedE, class TIndex = typename TDerivedE::Scalar>
+AdjacencyMatrix<TIndex> MeshDualGraph(Eigen::DenseBase<TDerivedE> const& E, TIndex nNodes = -1)
+{
+    PBAT_PROFILE_NAMED_SCOPE("pbat.graph.MeshDualGraph");
+    AdjacencyMatrix<TIndex> A = MeshAdjacencyMatrix(E, nNodes);
+    // Count shared nodes, rather than multiply local indices
+    A.coeffs().setOnes();
+    AdjacencyMatrix<TIndex> G = A.transpose() * A;
+    G.prune([](TIndex row, TIndex col, TIndex) { return row != col; });
+    return G;
+}
+
+} // namespace graph
+} // namespace pbat
+
+#endif // PBAT_GRAPH_ADJACENCY_H
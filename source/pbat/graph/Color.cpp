@@ -0,0 +1,47 @@
+#include "Color.h"
+
+#include "Adjacency.h"
+
+#include <doctest/doctest.h>
+
+TEST_CASE("[graph] Color")
+{
+    using namespace pbat;
+    // Arrange
+    // Cube tetrahedral mesh
+    IndexMatrixX T(4, 5);
+    // clang-format off
+    T << 0, 3, 5, 6, 0,
+         1, 2, 4, 7, 5,
+         3, 0, 6, 5, 3,
+         5, 6, 0, 3, 6;
+    // clang-format on
+    Index const nVertices = 8;
+    auto const G          = graph::MeshPrimalGraph(T, nVertices);
+    auto const ptr        = Eigen::Map<IndexVectorX const>(G.outerIndexPtr(), G.outerSize() + 1);
+    auto const adj        = Eigen::Map<IndexVectorX const>(G.innerIndexPtr(), G.nonZeros());
+    for (auto eStrategy :
+         {graph::EGreedyColorSelectionStrategy::LeastUsed,
+          graph::EGreedyColorSelectionStrategy::FirstAvailable})
+    {
+        // Act
+        IndexVectorX const C  = graph::GreedyColor(ptr, adj, eStrategy);
+        auto const partitions = graph::ColorPartitions(C);
+        // Assert
+        REQUIRE_EQ(C.size(), nVertices);
+        CHECK_GE(C.minCoeff(), 0);
+        Index const maxDegree = (ptr.tail(nVertices) - ptr.head(nVertices)).maxCoeff();
+        CHECK_LE(C.maxCoeff(), maxDegree);
+        for (auto v = 0; v < nVertices; ++v)
+            for (auto a = ptr(v); a < ptr(v + 1); ++a)
+                CHECK_NE(C(v), C(adj(a)));
+        Index nPartitionedVertices{0};
+        for (auto c = 0ULL; c < partitions.size(); ++c)
+        {
+            for (Index v : partitions[c])
+                CHECK_EQ(C(v), static_cast<Index>(c));
+            nPartitionedVertices += static_cast<Index>(partitions[c].size());
+        }
+        CHECK_EQ(nPartitionedVertices, nVertices);
+    }
+}
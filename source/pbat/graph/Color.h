@@ -0,0 +1,181 @@
+#ifndef PBAT_GRAPH_COLOR_H
+#define PBAT_GRAPH_COLOR_H
+
+#include "pbat/Aliases.h"
+#include "pbat/profiling/Profiling.h"
+
+#include <algorithm>
+#include <atomic>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <tbb/enumerable_thread_specific.h>
+#include <tbb/parallel_for.h>
+#include <vector>
+
+namespace pbat {
+namespace graph {
+
+enum class EGreedyColorSelectionStrategy {
+    LeastUsed,     ///< Pick the admissible color with the fewest vertices, i.e. balance colors
+    FirstAvailable ///< Pick the smallest admissible color
+};
+
+/**
+ * @brief Colors the vertices of the undirected graph (ptr,adj) in compressed sparse format such
+ * that no 2 adjacent vertices share a color.
+ *
+ * Uses parallel speculative greedy coloring, i.e. all uncolored vertices are tentatively colored
+ * concurrently, then vertices whose color conflicts with a smaller adjacent vertex are recolored
+ * in the next round. Each round colors at least the smallest remaining vertex, and in practice
+ * only few rounds are required on mesh graphs.
+ *
+ * @tparam TDerivedP
+ * @tparam TDerivedAdj
+ * @tparam TIndex
+ * @param ptr |#vertices+1| offsets into adj, such that vertex v's neighbours are
+ * adj[ptr[v]:ptr[v+1]]
+ * @param adj Adjacency list of the symmetric graph. Self-loops are ignored.
+ * @param eSelectionStrategy Color selection strategy
+ * @return |#vertices| vertex colors in [0, max(C)]
+ */
+template <class TDerivedP, class TDerivedAdj, class TIndex = typename TDerivedP::Scalar>
+Eigen::Vector<TIndex, Eigen::Dynamic> GreedyColor(
+    Eigen::DenseBase<TDerivedP> const& ptr,
+    Eigen::DenseBase<TDerivedAdj> const& adj,
+    EGreedyColorSelectionStrategy eSelectionStrategy = EGreedyColorSelectionStrategy::LeastUsed)
+{
+    PBAT_PROFILE_NAMED_SCOPE("pbat.graph.GreedyColor");
+    auto const nVertices = static_cast<TIndex>(ptr.size()) - TIndex(1);
+    if (nVertices < TIndex(0))
+    {
+        std::string const what = "Expected |#vertices+1| offsets ptr, but got ptr.size()=0";
+        throw std::invalid_argument(what);
+    }
+    Eigen::Vector<TIndex, Eigen::Dynamic> C(nVertices);
+    C.setConstant(TIndex(-1));
+    if (nVertices == TIndex(0))
+        return C;
+    // Greedy coloring never uses more than maxDegree+1 colors
+    TIndex maxDegree{0};
+    for (TIndex v = 0; v < nVertices; ++v)
+        maxDegree = std::max(maxDegree, static_cast<TIndex>(ptr(v + 1) - ptr(v)));
+    auto const nMaxColors = static_cast<std::size_t>(maxDegree) + 1;
+    std::vector<TIndex> counts(nMaxColors, TIndex(0));
+    TIndex nColors{0};
+    // Forbidden colors are marked by stamping them with the current vertex, so that thread-local
+    // buffers never need to be cleared.
+    struct Forbidden
+    {
+        std::vector<TIndex> stamps;
+        TIndex stamp{0};
+    };
+    tbb::enumerable_thread_specific<Forbidden> forbidden([nMaxColors]() {
+        return Forbidden{std::vector<TIndex>(nMaxColors, TIndex(-1)), TIndex(0)};
+    });
+    std::vector<TIndex> U(static_cast<std::size_t>(nVertices));
+    std::iota(U.begin(), U.end(), TIndex(0));
+    std::vector<char> bConflict{};
+    while (not U.empty())
+    {
+        // Speculatively color all uncolored vertices
+        tbb::parallel_for(std::size_t{0}, U.size(), [&](std::size_t k) {
+            TIndex const v  = U[k];
+            Forbidden& f    = forbidden.local();
+            TIndex const fv = ++f.stamp;
+            for (auto a = ptr(v); a < ptr(v + 1); ++a)
+            {
+                auto const u = static_cast<TIndex>(adj(a));
+                if (u == v)
+                    continue;
+                TIndex const cu = std::atomic_ref<TIndex>(C(u)).load(std::memory_order_relaxed);
+                if (cu >= TIndex(0))
+                    f.stamps[static_cast<std::size_t>(cu)] = fv;
+            }
+            TIndex const nColorsUsed =
+                std::atomic_ref<TIndex>(nColors).load(std::memory_order_relaxed);
+            TIndex c{-1};
+            if (eSelectionStrategy == EGreedyColorSelectionStrategy::LeastUsed)
+            {
+                TIndex cmin{std::numeric_limits<TIndex>::max()};
+                for (TIndex cc = 0; cc < nColorsUsed; ++cc)
+                {
+                    if (f.stamps[static_cast<std::size_t>(cc)] == fv)
+                        continue;
+                    auto const ci      = static_cast<std::size_t>(cc);
+                    TIndex const count = std::atomic_ref<TIndex>(counts[ci]).load(
+                        std::memory_order_relaxed);
+                    if (count < cmin)
+                    {
+                        cmin = count;
+                        c    = cc;
+                    }
+                }
+            }
+            if (c < TIndex(0))
+            {
+                c = TIndex(0);
+                while (f.stamps[static_cast<std::size_t>(c)] == fv)
+                    ++c;
+            }
+            std::atomic_ref<TIndex>(counts[static_cast<std::size_t>(c)])
+                .fetch_add(TIndex(1), std::memory_order_relaxed);
+            std::atomic_ref<TIndex> nColorsRef(nColors);
+            TIndex nColorsExpected = nColorsRef.load(std::memory_order_relaxed);
+            while (nColorsExpected < c + TIndex(1) and
+                   not nColorsRef.compare_exchange_weak(nColorsExpected, c + TIndex(1)))
+                ;
+            std::atomic_ref<TIndex>(C(v)).store(c, std::memory_order_relaxed);
+        });
+        // Detect conflicts. The smaller vertex of a conflicting edge keeps its color.
+        bConflict.assign(U.size(), char{0});
+        tbb::parallel_for(std::size_t{0}, U.size(), [&](std::size_t k) {
+            TIndex const v = U[k];
+            for (auto a = ptr(v); a < ptr(v + 1); ++a)
+            {
+                auto const u = static_cast<TIndex>(adj(a));
+                if (u < v and C(u) == C(v))
+                {
+                    bConflict[k] = char{1};
+                    break;
+                }
+            }
+        });
+        std::size_t nConflicts{0};
+        for (std::size_t k = 0; k < U.size(); ++k)
+        {
+            if (not bConflict[k])
+                continue;
+            TIndex const v = U[k];
+            --counts[static_cast<std::size_t>(C(v))];
+            U[nConflicts++] = v;
+        }
+        U.resize(nConflicts);
+    }
+    return C;
+}
+
+/**
+ * @brief Groups vertices by color
+ *
+ * @tparam TDerivedC
+ * @param C |#vertices| vertex colors
+ * @return |#colors| partitions, such that partitions[c] lists the vertices of color c in
+ * ascending order. Unused colors yield empty partitions.
+ */
+template <class TDerivedC>
+std::vector<std::vector<Index>> ColorPartitions(Eigen::DenseBase<TDerivedC> const& C)
+{
+    PBAT_PROFILE_NAMED_SCOPE("pbat.graph.ColorPartitions");
+    auto const nColors = C.size() > 0 ? static_cast<std::size_t>(C.maxCoeff()) + 1 : 0;
+    std::vector<std::vector<Index>> partitions(nColors);
+    for (auto v = 0; v < C.size(); ++v)
+        partitions[static_cast<std::size_t>(C(v))].push_back(static_cast<Index>(v));
+    return partitions;
+}
+
+} // namespace graph
+} // namespace pbat
+
+#endif // PBAT_GRAPH_COLOR_H
@@ -0,0 +1,8 @@
+#ifndef PBAT_GRAPH_GRAPH_H
+#define PBAT_GRAPH_GRAPH_H
+
+#include "Adjacency.h"
+#include "Color.h"
+#include "Ordering.h"
+
+#endif // PBAT_GRAPH_GRAPH_H
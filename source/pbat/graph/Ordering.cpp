@@ -0,0 +1,41 @@
+#include "Ordering.h"
+
+#include "Adjacency.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <doctest/doctest.h>
+
+TEST_CASE("[graph] Ordering")
+{
+    using namespace pbat;
+    // Arrange
+    // Path graph 0 - 4 - 1 - 3 - 2 - 5, i.e. with scrambled vertex labels
+    IndexMatrixX E(2, 5);
+    // clang-format off
+    E << 0, 4, 1, 3, 2,
+         4, 1, 3, 2, 5;
+    // clang-format on
+    Index const nVertices = 6;
+    auto const G          = graph::MeshPrimalGraph(E, nVertices);
+    auto const ptr        = Eigen::Map<IndexVectorX const>(G.outerIndexPtr(), G.outerSize() + 1);
+    auto const adj        = Eigen::Map<IndexVectorX const>(G.innerIndexPtr(), G.nonZeros());
+    // Act
+    IndexVectorX const p = graph::ReverseCuthillMcKee(ptr, adj);
+    // Assert
+    REQUIRE_EQ(p.size(), nVertices);
+    IndexVectorX ip = IndexVectorX::Constant(nVertices, Index(-1));
+    ip(p)           = IndexVectorX::LinSpaced(nVertices, Index(0), nVertices - 1);
+    CHECK_GE(ip.minCoeff(), 0);
+    // Path graph has unit bandwidth when ordered from one of its ends
+    for (auto e = 0; e < E.cols(); ++e)
+        CHECK_EQ(std::abs(ip(E(0, e)) - ip(E(1, e))), 1);
+    // Disconnected graphs order all their components
+    IndexMatrixX const E2 = (IndexMatrixX(2, 2) << 0, 2, 1, 3).finished();
+    auto const G2         = graph::MeshPrimalGraph(E2, Index(5));
+    auto const ptr2       = Eigen::Map<IndexVectorX const>(G2.outerIndexPtr(), 6);
+    auto const adj2       = Eigen::Map<IndexVectorX const>(G2.innerIndexPtr(), G2.nonZeros());
+    IndexVectorX p2       = graph::ReverseCuthillMcKee(ptr2, adj2);
+    std::sort(p2.begin(), p2.end());
+    CHECK(p2 == IndexVectorX::LinSpaced(5, Index(0), Index(4)));
+}
@@ -0,0 +1,127 @@
+#ifndef PBAT_GRAPH_ORDERING_H
+#define PBAT_GRAPH_ORDERING_H
+
+#include "pbat/Aliases.h"
+#include "pbat/profiling/Profiling.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <exception>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace pbat {
+namespace graph {
+
+/**
+ * @brief Computes the reverse Cuthill-McKee ordering of the undirected graph (ptr,adj) in
+ * compressed sparse format, which reduces the bandwidth of the graph's adjacency matrix.
+ *
+ * Each connected component is traversed in breadth-first order from a pseudo-peripheral vertex,
+ * visiting the neighbours of each vertex by increasing degree, and the resulting order is
+ * reversed.
+ *
+ * @tparam TDerivedP
+ * @tparam TDerivedAdj
+ * @tparam TIndex
+ * @param ptr |#vertices+1| offsets into adj, such that vertex v's neighbours are
+ * adj[ptr[v]:ptr[v+1]]
+ * @param adj Adjacency list of the symmetric graph. Self-loops are ignored.
+ * @return |#vertices| ordering p, such that p[i] is the (old) vertex placed at position i
+ */
+template <class TDerivedP, class TDerivedAdj, class TIndex = typename TDerivedP::Scalar>
+Eigen::Vector<TIndex, Eigen::Dynamic> ReverseCuthillMcKee(
+    Eigen::DenseBase<TDerivedP> const& ptr,
+    Eigen::DenseBase<TDerivedAdj> const& adj)
+{
+    PBAT_PROFILE_NAMED_SCOPE("pbat.graph.ReverseCuthillMcKee");
+    auto const nVertices = static_cast<TIndex>(ptr.size()) - TIndex(1);
+    if (nVertices < TIndex(0))
+    {
+        std::string const what = "Expected |#vertices+1| offsets ptr, but got ptr.size()=0";
+        throw std::invalid_argument(what);
+    }
+    auto const degree = [&](TIndex v) { return static_cast<TIndex>(ptr(v + 1) - ptr(v)); };
+    // Visit stamps avoid clearing the visited flags between breadth-first searches
+    std::vector<TIndex> visited(static_cast<std::size_t>(nVertices), TIndex(-1));
+    TIndex stamp{0};
+    std::vector<TIndex> neighbours{};
+    struct LevelStructure
+    {
+        std::vector<TIndex> order; ///< Vertices in breadth-first order
+        std::size_t lastLevel{0};  ///< Offset of the last level in order
+        TIndex nLevels{0};         ///< Number of levels, i.e. eccentricity of the root + 1
+    };
+    auto const bfs = [&](TIndex root, LevelStructure& L) {
+        ++stamp;
+        L.order.clear();
+        L.nLevels                               = TIndex(0);
+        visited[static_cast<std::size_t>(root)] = stamp;
+        L.order.push_back(root);
+        std::size_t levelBegin{0};
+        std::size_t levelEnd{1};
+        while (levelBegin < levelEnd)
+        {
+            L.lastLevel = levelBegin;
+            ++L.nLevels;
+            for (auto k = levelBegin; k < levelEnd; ++k)
+            {
+                TIndex const v = L.order[k];
+                neighbours.clear();
+                for (auto a = ptr(v); a < ptr(v + 1); ++a)
+                {
+                    auto const u = static_cast<TIndex>(adj(a));
+                    if (visited[static_cast<std::size_t>(u)] == stamp)
+                        continue;
+                    visited[static_cast<std::size_t>(u)] = stamp;
+                    neighbours.push_back(u);
+                }
+                std::stable_sort(neighbours.begin(), neighbours.end(), [&](TIndex i, TIndex j) {
+                    return degree(i) < degree(j);
+                });
+                L.order.insert(L.order.end(), neighbours.begin(), neighbours.end());
+            }
+            levelBegin = levelEnd;
+            levelEnd   = L.order.size();
+        }
+    };
+    std::vector<TIndex> order{};
+    order.reserve(static_cast<std::size_t>(nVertices));
+    std::vector<bool> bOrdered(static_cast<std::size_t>(nVertices), false);
+    LevelStructure L{};
+    LevelStructure Lcandidate{};
+    for (TIndex r = 0; r < nVertices; ++r)
+    {
+        if (bOrdered[static_cast<std::size_t>(r)])
+            continue;
+        // Find a pseudo-peripheral root by repeatedly restarting from a minimum degree vertex of
+        // the last level, until the number of levels stops growing
+        bfs(r, L);
+        bool bHasMoreLevels{true};
+        while (bHasMoreLevels)
+        {
+            auto const lastLevelBegin =
+                L.order.begin() + static_cast<std::ptrdiff_t>(L.lastLevel);
+            TIndex const candidate =
+                *std::min_element(lastLevelBegin, L.order.end(), [&](TIndex i, TIndex j) {
+                    return degree(i) < degree(j);
+                });
+            bfs(candidate, Lcandidate);
+            bHasMoreLevels = Lcandidate.nLevels > L.nLevels;
+            if (bHasMoreLevels)
+                std::swap(L, Lcandidate);
+        }
+        for (TIndex v : L.order)
+            bOrdered[static_cast<std::size_t>(v)] = true;
+        order.insert(order.end(), L.order.begin(), L.order.end());
+    }
+    Eigen::Vector<TIndex, Eigen::Dynamic> p(nVertices);
+    std::reverse_copy(order.begin(), order.end(), p.begin());
+    return p;
+}
+
+} // namespace graph
+} // namespace pbat
+
+#endif // PBAT_GRAPH_ORDERING_H
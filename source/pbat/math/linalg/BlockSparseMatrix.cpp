@@ -0,0 +1,46 @@
+#include "BlockSparseMatrix.h"
+
+#include <doctest/doctest.h>
+#include <pbat/math/LinearOperator.h>
+
+TEST_CASE("[math][linalg] BlockSparseMatrix")
+{
+    using namespace pbat;
+    using BlockSparseMatrixType = math::linalg::BlockSparseMatrix<3>;
+    CHECK(math::CLinearOperator<BlockSparseMatrixType>);
+
+    // Arrange
+    // 3x4 block matrix with blocks at (0,0), (0,3), (1,1) and (2,0)
+    Index constexpr nBlockRows = 3;
+    Index constexpr nBlockCols = 4;
+    BlockSparseMatrixType::IndexVectorType ptr(nBlockRows + 1);
+    BlockSparseMatrixType::IndexVectorType ind(4);
+    ptr << 0, 2, 3, 4;
+    ind << 0, 3, 1, 0;
+    BlockSparseMatrixType A(nBlockRows, nBlockCols, ptr, ind);
+    std::srand(0);
+    A.B.setRandom();
+    MatrixX Aexpected = MatrixX::Zero(3 * nBlockRows, 3 * nBlockCols);
+    Aexpected.block<3, 3>(0, 0) = A.Block(0);
+    Aexpected.block<3, 3>(0, 9) = A.Block(1);
+    Aexpected.block<3, 3>(3, 3) = A.Block(2);
+    Aexpected.block<3, 3>(6, 0) = A.Block(3);
+
+    // Act
+    CSCMatrix const Acsc = A.ToMatrix();
+    MatrixX const X      = MatrixX::Random(3 * nBlockCols, 2);
+    MatrixX Y            = MatrixX::Ones(3 * nBlockRows, 2);
+    A.Apply(X, Y);
+
+    // Assert
+    Scalar constexpr zero = 1e-15;
+    CHECK_EQ(Acsc.rows(), A.OutputDimensions());
+    CHECK_EQ(Acsc.cols(), A.InputDimensions());
+    Scalar const conversionError = (MatrixX(Acsc) - Aexpected).norm() / Aexpected.norm();
+    CHECK_LE(conversionError, zero);
+    MatrixX const Yexpected    = MatrixX::Ones(3 * nBlockRows, 2) + Aexpected * X;
+    Scalar const applyError    = (Y - Yexpected).norm() / Yexpected.norm();
+    CHECK_LE(applyError, zero);
+    VectorX y = VectorX::Zero(3 * nBlockRows);
+    CHECK_THROWS_AS(A.Apply(VectorX::Zero(3 * nBlockRows), y), std::invalid_argument);
+}
@@ -0,0 +1,178 @@
+#ifndef PBAT_MATH_LINALG_BLOCK_SPARSE_MATRIX_H
+#define PBAT_MATH_LINALG_BLOCK_SPARSE_MATRIX_H
+
+#include <exception>
+#include <fmt/core.h>
+#include <pbat/Aliases.h>
+#include <pbat/profiling/Profiling.h>
+#include <string>
+#include <tbb/parallel_for.h>
+#include <utility>
+
+namespace pbat {
+namespace math {
+namespace linalg {
+
+/**
+ * @brief Block compressed sparse row (BSR) matrix of dense kBlockSize x kBlockSize blocks.
+ *
+ * Stores a single column index per non-zero block, rather than one row index per non-zero
+ * coefficient as in CSCMatrix, using CSCMatrix's (32-bit) storage index type.
+ *
+ * @tparam BlockSize Number of rows (and columns) of each block
+ */
+template <int BlockSize>
+struct BlockSparseMatrix
+{
+    static int constexpr kBlockSize = BlockSize;
+    using BlockType                 = Matrix<kBlockSize, kBlockSize>;
+    using StorageIndex              = typename CSCMatrix::StorageIndex;
+    using IndexVectorType           = Eigen::Vector<StorageIndex, Eigen::Dynamic>;
+
+    BlockSparseMatrix() = default;
+
+    /**
+     * @brief Constructs a block sparse matrix with zero blocks at the given block sparsity.
+     *
+     * @param nBlockRows Number of block rows
+     * @param nBlockCols Number of block columns
+     * @param ptr |nBlockRows+1| offsets into ind
+     * @param ind |#non-zero blocks| block column indices, such that block row i has blocks
+     * ind[ptr[i]:ptr[i+1]], in ascending order
+     */
+    BlockSparseMatrix(
+        Index nBlockRows,
+        Index nBlockCols,
+        IndexVectorType ptr,
+        IndexVectorType ind);
+
+    /**
+     * @brief Applies this matrix as a linear operator on x, adding result to y, in parallel over
+     * block rows.
+     *
+     * @tparam TDerivedIn
+     * @tparam TDerivedOut
+     * @param x
+     * @param y
+     */
+    template <class TDerivedIn, class TDerivedOut>
+    void Apply(Eigen::MatrixBase<TDerivedIn> const& x, Eigen::DenseBase<TDerivedOut>& y) const;
+
+    /**
+     * @brief Converts this block sparse matrix to sparse compressed column format, e.g. for
+     * factorization.
+     * @return
+     */
+    CSCMatrix ToMatrix() const;
+
+    Index InputDimensions() const { return kBlockSize * nBlockCols; }
+    Index OutputDimensions() const { return kBlockSize * nBlockRows; }
+    Index NumberOfNonZeroBlocks() const { return ind.size(); }
+
+    auto Block(Index b) { return B.template block<kBlockSize, kBlockSize>(0, b * kBlockSize); }
+    auto Block(Index b) const
+    {
+        return B.template block<kBlockSize, kBlockSize>(0, b * kBlockSize);
+    }
+
+    Index nBlockRows{0}; ///< Number of block rows
+    Index nBlockCols{0}; ///< Number of block columns
+    IndexVectorType ptr; ///< |nBlockRows+1| offsets into ind
+    IndexVectorType ind; ///< |#non-zero blocks| block column indices
+    MatrixX B;           ///< |kBlockSize| x |kBlockSize * #non-zero blocks| non-zero blocks
+};
+
+template <int BlockSize>
+inline BlockSparseMatrix<BlockSize>::BlockSparseMatrix(
+    Index nBlockRowsIn,
+    Index nBlockColsIn,
+    IndexVectorType ptrIn,
+    IndexVectorType indIn)
+    : nBlockRows(nBlockRowsIn),
+      nBlockCols(nBlockColsIn),
+      ptr(std::move(ptrIn)),
+      ind(std::move(indIn)),
+      B()
+{
+    if (ptr.size() != nBlockRows + 1)
+    {
+        std::string const what = fmt::format(
+            "Expected |#block rows + 1|={} block row offsets, but got {}",
+            nBlockRows + 1,
+            ptr.size());
+        throw std::invalid_argument(what);
+    }
+    B.setZero(kBlockSize, kBlockSize * ind.size());
+}
+
+template <int BlockSize>
+template <class TDerivedIn, class TDerivedOut>
+inline void BlockSparseMatrix<BlockSize>::Apply(
+    Eigen::MatrixBase<TDerivedIn> const& x,
+    Eigen::DenseBase<TDerivedOut>& y) const
+{
+    PBAT_PROFILE_NAMED_SCOPE("pbat.math.linalg.BlockSparseMatrix.Apply");
+    if (x.rows() != InputDimensions() or y.rows() != OutputDimensions() or x.cols() != y.cols())
+    {
+        std::string const what = fmt::format(
+            "Expected input to have rows={} and output to have rows={}, and same number of "
+            "columns, but got dimensions x,y=({},{}), ({},{})",
+            InputDimensions(),
+            OutputDimensions(),
+            x.rows(),
+            x.cols(),
+            y.rows(),
+            y.cols());
+        throw std::invalid_argument(what);
+    }
+    // Each block row only writes to its own rows of y, so block rows need no synchronization
+    tbb::parallel_for(Index{0}, nBlockRows, [&](Index i) {
+        for (auto c = 0; c < x.cols(); ++c)
+        {
+            Vector<kBlockSize> yi = Vector<kBlockSize>::Zero();
+            for (auto b = ptr(i); b < ptr(i + 1); ++b)
+                yi += Block(b) * x.col(c).template segment<kBlockSize>(kBlockSize * ind(b));
+            y.col(c).template segment<kBlockSize>(kBlockSize * i) += yi;
+        }
+    });
+}
+
+template <int BlockSize>
+inline CSCMatrix BlockSparseMatrix<BlockSize>::ToMatrix() const
+{
+    PBAT_PROFILE_NAMED_SCOPE("pbat.math.linalg.BlockSparseMatrix.ToMatrix");
+    using SparseIndex   = StorageIndex;
+    using CSRMatrixType = Eigen::SparseMatrix<Scalar, Eigen::RowMajor, SparseIndex>;
+    CSRMatrixType A(OutputDimensions(), InputDimensions());
+    A.resizeNonZeros(kBlockSize * kBlockSize * NumberOfNonZeroBlocks());
+    SparseIndex* const outerIndices = A.outerIndexPtr();
+    SparseIndex* const innerIndices = A.innerIndexPtr();
+    Scalar* const values            = A.valuePtr();
+    // Row di of block row i stores its |kBlockSize * #blocks in row i| non-zeros contiguously
+    tbb::parallel_for(Index{0}, nBlockRows, [&](Index i) {
+        auto const nBlocksInRow = ptr(i + 1) - ptr(i);
+        for (auto di = 0; di < kBlockSize; ++di)
+        {
+            auto const r     = kBlockSize * i + di;
+            auto const begin = kBlockSize * kBlockSize * ptr(i) + di * kBlockSize * nBlocksInRow;
+            outerIndices[r]  = static_cast<SparseIndex>(begin);
+            for (auto b = ptr(i); b < ptr(i + 1); ++b)
+            {
+                for (auto dj = 0; dj < kBlockSize; ++dj)
+                {
+                    auto const k    = begin + kBlockSize * (b - ptr(i)) + dj;
+                    innerIndices[k] = static_cast<SparseIndex>(kBlockSize * ind(b) + dj);
+                    values[k]       = B(di, kBlockSize * b + dj);
+                }
+            }
+        }
+    });
+    outerIndices[OutputDimensions()] = static_cast<SparseIndex>(A.data().size());
+    return CSCMatrix(A);
+}
+
+} // namespace linalg
+} // namespace math
+} // namespace pbat
+
+#endif // PBAT_MATH_LINALG_BLOCK_SPARSE_MATRIX_H
@@ -0,0 +1,50 @@
+#include "BlockSparsityPattern.h"
+
+#include <doctest/doctest.h>
+#include <vector>
+
+TEST_CASE("[math][linalg] BlockSparsityPattern")
+{
+    using namespace pbat;
+
+    // Arrange
+    // Duplicate blocks at (1,0), (0,2) and (2,2), and a unique block at (2,1)
+    Index constexpr nBlockRows = 3;
+    Index constexpr nBlockCols = 3;
+    std::vector<Index> blockRowIndices{{1, 0, 2, 1, 0, 2, 0}};
+    std::vector<Index> blockColIndices{{0, 2, 2, 0, 2, 1, 2}};
+    auto const nBlocks = static_cast<Index>(blockRowIndices.size());
+    std::srand(0);
+    MatrixX const blocks = MatrixX::Random(2, 2 * nBlocks);
+    auto const blockOf   = [&](Index k) {
+        return blocks.block<2, 2>(0, 2 * k);
+    };
+    MatrixX Aexpected = MatrixX::Zero(2 * nBlockRows, 2 * nBlockCols);
+    for (auto k = 0; k < nBlocks; ++k)
+    {
+        auto const kk = static_cast<std::size_t>(k);
+        Aexpected.block<2, 2>(2 * blockRowIndices[kk], 2 * blockColIndices[kk]) += blockOf(k);
+    }
+
+    // Act
+    math::linalg::BlockSparsityPattern<2> const GP(
+        nBlockRows,
+        nBlockCols,
+        blockRowIndices,
+        blockColIndices);
+    auto A = GP.ToMatrix(blockOf);
+
+    // Assert
+    CHECK_FALSE(GP.IsEmpty());
+    CHECK_EQ(A.NumberOfNonZeroBlocks(), 4);
+    Scalar constexpr zero = 1e-15;
+    Scalar const error    = (MatrixX(A.ToMatrix()) - Aexpected).norm() / Aexpected.norm();
+    CHECK_LE(error, zero);
+    // In-place block updates reuse A's block pattern
+    GP.ToMatrix([&](Index k) { return 2. * blockOf(k); }, A);
+    Scalar const inPlaceError =
+        (MatrixX(A.ToMatrix()) - 2. * Aexpected).norm() / Aexpected.norm();
+    CHECK_LE(inPlaceError, zero);
+    math::linalg::BlockSparseMatrix<2> Awrong{};
+    CHECK_THROWS_AS(GP.ToMatrix(blockOf, Awrong), std::invalid_argument);
+}
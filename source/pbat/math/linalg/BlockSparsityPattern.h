@@ -0,0 +1,190 @@
+#ifndef PBAT_MATH_LINALG_BLOCK_SPARSITY_PATTERN_H
+#define PBAT_MATH_LINALG_BLOCK_SPARSITY_PATTERN_H
+
+#include "BlockSparseMatrix.h"
+#include "SparsityPattern.h"
+
+#include <exception>
+#include <fmt/core.h>
+#include <pbat/Aliases.h>
+#include <pbat/common/Concepts.h>
+#include <pbat/profiling/Profiling.h>
+#include <string>
+#include <tbb/parallel_for.h>
+#include <utility>
+#include <vector>
+
+namespace pbat {
+namespace math {
+namespace linalg {
+
+/**
+ * @brief Sparsity pattern of a BlockSparseMatrix assembled from (duplicate) non-zero blocks, i.e.
+ * the block analogue of SparsityPattern.
+ *
+ * @tparam BlockSize Number of rows (and columns) of each block
+ */
+template <int BlockSize>
+class BlockSparsityPattern
+{
+  public:
+    static int constexpr kBlockSize = BlockSize;
+    using BlockSparseMatrixType     = BlockSparseMatrix<kBlockSize>;
+
+    BlockSparsityPattern() = default;
+
+    template <
+        common::CContiguousIndexRange TRowIndexRange,
+        common::CContiguousIndexRange TColIndexRange>
+    BlockSparsityPattern(
+        Index nBlockRows,
+        Index nBlockCols,
+        TRowIndexRange&& blockRowIndices,
+        TColIndexRange&& blockColIndices);
+
+    /**
+     * @brief Computes the block sparsity of (duplicate) non-zero blocks at (blockRowIndices[k],
+     * blockColIndices[k])
+     *
+     * @tparam TRowIndexRange
+     * @tparam TColIndexRange
+     * @param nBlockRows Number of block rows
+     * @param nBlockCols Number of block columns
+     * @param blockRowIndices Block row index of each non-zero block
+     * @param blockColIndices Block column index of each non-zero block
+     */
+    template <
+        common::CContiguousIndexRange TRowIndexRange,
+        common::CContiguousIndexRange TColIndexRange>
+    void Compute(
+        Index nBlockRows,
+        Index nBlockCols,
+        TRowIndexRange&& blockRowIndices,
+        TColIndexRange&& blockColIndices);
+
+    /**
+     * @brief Assembles the block sparse matrix whose blocks are the sums of duplicate non-zero
+     * blocks.
+     *
+     * @tparam TBlockFunc Callable with signature Matrix<kBlockSize,kBlockSize>(Index)
+     * @param blocks Returns the k^{th} non-zero block, in the order of the indices passed to
+     * Compute
+     * @return
+     */
+    template <class TBlockFunc>
+    BlockSparseMatrixType ToMatrix(TBlockFunc&& blocks) const;
+
+    /**
+     * @brief Overwrites the blocks of Ain, which must have this block sparsity pattern, with the
+     * sums of duplicate non-zero blocks, in parallel.
+     *
+     * @tparam TBlockFunc Callable with signature Matrix<kBlockSize,kBlockSize>(Index)
+     * @param blocks Returns the k^{th} non-zero block, in the order of the indices passed to
+     * Compute
+     * @param Ain Block sparse matrix with this block sparsity pattern
+     */
+    template <class TBlockFunc>
+    void ToMatrix(TBlockFunc&& blocks, BlockSparseMatrixType& Ain) const;
+
+    bool IsEmpty() const { return GP.IsEmpty(); }
+
+  private:
+    SparsityPattern GP; ///< Sparsity pattern of the transposed block matrix, i.e. its compressed
+                        ///< columns are the block rows of the block matrix
+};
+
+template <int BlockSize>
+template <
+    common::CContiguousIndexRange TRowIndexRange,
+    common::CContiguousIndexRange TColIndexRange>
+inline BlockSparsityPattern<BlockSize>::BlockSparsityPattern(
+    Index nBlockRows,
+    Index nBlockCols,
+    TRowIndexRange&& blockRowIndices,
+    TColIndexRange&& blockColIndices)
+{
+    Compute(
+        nBlockRows,
+        nBlockCols,
+        std::forward<TRowIndexRange>(blockRowIndices),
+        std::forward<TColIndexRange>(blockColIndices));
+}
+
+template <int BlockSize>
+template <
+    common::CContiguousIndexRange TRowIndexRange,
+    common::CContiguousIndexRange TColIndexRange>
+inline void BlockSparsityPattern<BlockSize>::Compute(
+    Index nBlockRows,
+    Index nBlockCols,
+    TRowIndexRange&& blockRowIndices,
+    TColIndexRange&& blockColIndices)
+{
+    PBAT_PROFILE_NAMED_SCOPE("pbat.math.linalg.BlockSparsityPattern.Compute");
+    GP.Compute(
+        nBlockCols,
+        nBlockRows,
+        std::forward<TColIndexRange>(blockColIndices),
+        std::forward<TRowIndexRange>(blockRowIndices));
+}
+
+template <int BlockSize>
+template <class TBlockFunc>
+inline typename BlockSparsityPattern<BlockSize>::BlockSparseMatrixType
+BlockSparsityPattern<BlockSize>::ToMatrix(TBlockFunc&& blocks) const
+{
+    PBAT_PROFILE_NAMED_SCOPE("pbat.math.linalg.BlockSparsityPattern.ToMatrix");
+    CSCMatrix const& AT   = GP.Pattern();
+    auto const nBlockRows = AT.outerSize();
+    using IndexVectorType = typename BlockSparseMatrixType::IndexVectorType;
+    BlockSparseMatrixType A(
+        nBlockRows,
+        AT.innerSize(),
+        Eigen::Map<IndexVectorType const>(AT.outerIndexPtr(), nBlockRows + 1),
+        Eigen::Map<IndexVectorType const>(AT.innerIndexPtr(), AT.nonZeros()));
+    ToMatrix(std::forward<TBlockFunc>(blocks), A);
+    return A;
+}
+
+template <int BlockSize>
+template <class TBlockFunc>
+inline void
+BlockSparsityPattern<BlockSize>::ToMatrix(TBlockFunc&& blocks, BlockSparseMatrixType& Ain) const
+{
+    PBAT_PROFILE_NAMED_SCOPE("pbat.math.linalg.BlockSparsityPattern.ToMatrixInPlace");
+    CSCMatrix const& AT        = GP.Pattern();
+    bool const bHasSamePattern = (Ain.nBlockRows == AT.outerSize()) and
+                                 (Ain.nBlockCols == AT.innerSize()) and
+                                 (Ain.NumberOfNonZeroBlocks() == AT.nonZeros()) and
+                                 (Ain.B.cols() == kBlockSize * AT.nonZeros());
+    if (not bHasSamePattern)
+    {
+        std::string const what = fmt::format(
+            "Expected {}x{} block matrix with {} non-zero blocks, but got {}x{} block matrix "
+            "with {} non-zero blocks",
+            AT.outerSize(),
+            AT.innerSize(),
+            AT.nonZeros(),
+            Ain.nBlockRows,
+            Ain.nBlockCols,
+            Ain.NumberOfNonZeroBlocks());
+        throw std::invalid_argument(what);
+    }
+    std::vector<Index> const& up = GP.UniqueNonZeroOffsets();
+    std::vector<Index> const& uk = GP.DuplicateNonZeroIndices();
+    auto const nUnique           = static_cast<Index>(up.size()) - 1;
+    tbb::parallel_for(Index{0}, nUnique, [&](Index u) {
+        auto const kBegin = static_cast<std::size_t>(up[static_cast<std::size_t>(u)]);
+        auto const kEnd   = static_cast<std::size_t>(up[static_cast<std::size_t>(u + 1)]);
+        Matrix<kBlockSize, kBlockSize> block = Matrix<kBlockSize, kBlockSize>::Zero();
+        for (auto k = kBegin; k < kEnd; ++k)
+            block += blocks(uk[k]);
+        Ain.Block(u) = block;
+    });
+}
+
+} // namespace linalg
+} // namespace math
+} // namespace pbat
+
+#endif // PBAT_MATH_LINALG_BLOCK_SPARSITY_PATTERN_H
@@ -0,0 +1,89 @@
+#include "ConjugateGradient.h"
+
+#include <Eigen/SparseCholesky>
+#include <doctest/doctest.h>
+
+namespace pbat {
+namespace test {
+
+struct SparseOperator
+{
+    template <class TDerivedIn, class TDerivedOut>
+    void Apply(Eigen::MatrixBase<TDerivedIn> const& x, Eigen::DenseBase<TDerivedOut>& y) const
+    {
+        y += A * x;
+    }
+
+    CSCMatrix ToMatrix() const { return A; }
+    Index OutputDimensions() const { return A.rows(); }
+    Index InputDimensions() const { return A.cols(); }
+
+    CSCMatrix A;
+};
+
+} // namespace test
+} // namespace pbat
+
+TEST_CASE("[math][linalg] ConjugateGradient")
+{
+    using namespace pbat;
+    using math::linalg::BlockJacobiPreconditioner;
+    using math::linalg::ConjugateGradient;
+    using math::linalg::JacobiPreconditioner;
+    CHECK(math::CLinearOperator<test::SparseOperator>);
+    CHECK(math::linalg::CPreconditioner<math::linalg::IdentityPreconditioner>);
+    CHECK(math::linalg::CPreconditioner<JacobiPreconditioner>);
+    CHECK(math::linalg::CPreconditioner<BlockJacobiPreconditioner<3>>);
+
+    // Badly scaled symmetric positive definite system A = S (R^T R + nI) S
+    auto constexpr n = 30;
+    MatrixX const R  = MatrixX::Random(n, n);
+    VectorX const s  = VectorX::LinSpaced(n, 1., 1e3);
+    MatrixX const Adense =
+        s.asDiagonal() * (R.transpose() * R + n * MatrixX::Identity(n, n)) * s.asDiagonal();
+    test::SparseOperator const A{Adense.sparseView()};
+    VectorX const b = VectorX::Random(n);
+    Eigen::SimplicialLDLT<CSCMatrix> LDLT(A.A);
+    VectorX const xExpected    = LDLT.solve(b);
+    Scalar constexpr zero      = 1e-6;
+    Scalar constexpr tolerance = 1e-10;
+
+    ConjugateGradient cg(10 * n, tolerance);
+    VectorX x = VectorX::Zero(n);
+    CHECK(cg.Solve(A, b, x));
+    CHECK_LE(cg.RelativeResidual(), tolerance);
+    Index const unpreconditionedIterations = cg.Iterations();
+    CHECK_LE((x - xExpected).norm() / xExpected.norm(), zero);
+
+    x.setZero();
+    JacobiPreconditioner const jacobi(Adense.diagonal());
+    CHECK(cg.Solve(A, jacobi, b, x));
+    CHECK_LE((x - xExpected).norm() / xExpected.norm(), zero);
+    CHECK_LT(cg.Iterations(), unpreconditionedIterations);
+
+    x.setZero();
+    MatrixX D(3, n);
+    for (auto i = 0; i < n; i += 3)
+        D.block<3, 3>(0, i) = Adense.block<3, 3>(i, i);
+    BlockJacobiPreconditioner<3> const blockJacobi(D);
+    CHECK(cg.Solve(A, blockJacobi, b, x));
+    CHECK_LE((x - xExpected).norm() / xExpected.norm(), zero);
+
+    // Warm starting from the solution should not iterate
+    x = xExpected;
+    CHECK(cg.Solve(A, jacobi, b, x));
+    CHECK_EQ(cg.Iterations(), 0);
+
+    // Zero right-hand side has the trivial solution
+    CHECK(cg.Solve(A, jacobi, VectorX::Zero(n), x));
+    CHECK_EQ(x.squaredNorm(), 0.);
+
+    // Invalid preconditioners and dimensions
+    CHECK_THROWS_AS(JacobiPreconditioner(VectorX::Zero(n)), std::invalid_argument);
+    CHECK_THROWS_AS(BlockJacobiPreconditioner<3>(MatrixX::Identity(3, 4)), std::invalid_argument);
+    MatrixX Dsingular = D;
+    Dsingular.block<3, 3>(0, 3).setZero();
+    CHECK_THROWS_AS(BlockJacobiPreconditioner<3>{Dsingular}, std::invalid_argument);
+    VectorX y = VectorX::Zero(n + 1);
+    CHECK_THROWS_AS(cg.Solve(A, b, y), std::invalid_argument);
+}
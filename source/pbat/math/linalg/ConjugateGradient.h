@@ -0,0 +1,201 @@
+#ifndef PBAT_MATH_LINALG_CONJUGATE_GRADIENT_H
+#define PBAT_MATH_LINALG_CONJUGATE_GRADIENT_H
+
+#include "Preconditioners.h"
+
+#include <cmath>
+#include <exception>
+#include <fmt/core.h>
+#include <pbat/Aliases.h>
+#include <pbat/math/LinearOperator.h>
+#include <pbat/profiling/Profiling.h>
+#include <string>
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#include <tbb/parallel_reduce.h>
+
+namespace pbat {
+namespace math {
+namespace linalg {
+
+/**
+ * @brief Matrix-free preconditioned conjugate gradient solver for symmetric positive definite
+ * linear operators.
+ *
+ * Only requires applying the linear operator and its preconditioner, and uses parallel BLAS-1
+ * kernels. Work vectors are kept across solves to avoid reallocation.
+ */
+class ConjugateGradient
+{
+  public:
+    /**
+     * @brief
+     * @param maxIterations Maximum number of iterations
+     * @param tolerance Relative residual tolerance, i.e. iterations stop once |b - Ax| <=
+     * tolerance * |b|
+     */
+    ConjugateGradient(Index maxIterations = 1000, Scalar tolerance = 1e-8);
+
+    /**
+     * @brief Solves Ax = b, starting from the initial guess x, i.e. warm starts are supported by
+     * passing the previous solution.
+     *
+     * @tparam TLinearOperator
+     * @tparam TPreconditioner
+     * @param A Symmetric positive definite linear operator
+     * @param M Symmetric positive definite preconditioner
+     * @param b |A.OutputDimensions()| right-hand side
+     * @param x |A.InputDimensions()| initial guess, overwritten by the solution
+     * @return True if the relative residual tolerance was reached
+     */
+    template <CLinearOperator TLinearOperator, CPreconditioner TPreconditioner>
+    bool Solve(
+        TLinearOperator const& A,
+        TPreconditioner const& M,
+        Eigen::Ref<VectorX const> const& b,
+        Eigen::Ref<VectorX> x);
+
+    /**
+     * @brief Solves Ax = b without preconditioning, starting from the initial guess x
+     *
+     * @tparam TLinearOperator
+     * @param A Symmetric positive definite linear operator
+     * @param b |A.OutputDimensions()| right-hand side
+     * @param x |A.InputDimensions()| initial guess, overwritten by the solution
+     * @return True if the relative residual tolerance was reached
+     */
+    template <CLinearOperator TLinearOperator>
+    bool Solve(TLinearOperator const& A, Eigen::Ref<VectorX const> const& b, Eigen::Ref<VectorX> x)
+    {
+        return Solve(A, IdentityPreconditioner{}, b, x);
+    }
+
+    /**
+     * @brief
+     * @return Number of iterations of the last solve
+     */
+    Index Iterations() const { return mIterations; }
+    /**
+     * @brief
+     * @return Relative residual |b - Ax| / |b| of the last solve
+     */
+    Scalar RelativeResidual() const { return mRelativeResidual; }
+
+    Index maxIterations; ///< Maximum number of iterations
+    Scalar tolerance;    ///< Relative residual tolerance
+
+  private:
+    static Index constexpr kGrainSize = 4096; ///< Minimum number of coefficients per BLAS-1 task
+
+    static Scalar Dot(VectorX const& a, VectorX const& b);
+    /**
+     * @brief Computes y = alpha*x + beta*y
+     */
+    static void Axpby(Scalar alpha, VectorX const& x, Scalar beta, Eigen::Ref<VectorX> y);
+
+    Index mIterations{0};         ///< Number of iterations of the last solve
+    Scalar mRelativeResidual{0.}; ///< Relative residual of the last solve
+    VectorX r;                    ///< Residual
+    VectorX z;                    ///< Preconditioned residual
+    VectorX p;                    ///< Search direction
+    VectorX Ap;                   ///< Linear operator applied to search direction
+};
+
+inline ConjugateGradient::ConjugateGradient(Index maxIterationsIn, Scalar toleranceIn)
+    : maxIterations(maxIterationsIn), tolerance(toleranceIn), r(), z(), p(), Ap()
+{
+}
+
+template <CLinearOperator TLinearOperator, CPreconditioner TPreconditioner>
+inline bool ConjugateGradient::Solve(
+    TLinearOperator const& A,
+    TPreconditioner const& M,
+    Eigen::Ref<VectorX const> const& b,
+    Eigen::Ref<VectorX> x)
+{
+    PBAT_PROFILE_NAMED_SCOPE("pbat.math.linalg.ConjugateGradient.Solve");
+    auto const n = A.InputDimensions();
+    if (A.OutputDimensions() != n or b.size() != n or x.size() != n)
+    {
+        std::string const what = fmt::format(
+            "Expected square linear operator, right-hand side and solution of matching "
+            "dimensions, but got A={}x{}, b={}, x={}",
+            A.OutputDimensions(),
+            A.InputDimensions(),
+            b.size(),
+            x.size());
+        throw std::invalid_argument(what);
+    }
+    mIterations       = 0;
+    mRelativeResidual = Scalar(0);
+    r                 = b;
+
+    Scalar const bNorm = std::sqrt(Dot(r, r));
+    if (bNorm == Scalar(0))
+    {
+        x.setZero();
+        return true;
+    }
+    // r = b - Ax, since A.Apply adds to its output
+    p = -x;
+    A.Apply(p, r);
+    z.resize(n);
+    M.Solve(r, z);
+    p = z;
+    Ap.resize(n);
+    Scalar rz              = Dot(r, z);
+    Scalar rr              = Dot(r, r);
+    Scalar const threshold = tolerance * bNorm;
+    while (std::sqrt(rr) > threshold and mIterations < maxIterations)
+    {
+        Ap.setZero();
+        A.Apply(p, Ap);
+        Scalar const pAp = Dot(p, Ap);
+        // Non-positive curvature means A (or M) is not positive definite
+        if (pAp <= Scalar(0))
+            break;
+        Scalar const alpha = rz / pAp;
+        Axpby(alpha, p, Scalar(1), x);
+        Axpby(-alpha, Ap, Scalar(1), r);
+        M.Solve(r, z);
+        Scalar const rzNext = Dot(r, z);
+        Scalar const beta   = rzNext / rz;
+        Axpby(Scalar(1), z, beta, p);
+        rz = rzNext;
+        rr = Dot(r, r);
+        ++mIterations;
+    }
+    mRelativeResidual = std::sqrt(rr) / bNorm;
+    return mRelativeResidual <= tolerance;
+}
+
+inline Scalar ConjugateGradient::Dot(VectorX const& a, VectorX const& b)
+{
+    // Deterministic reduction makes solves reproducible across runs
+    return tbb::parallel_deterministic_reduce(
+        tbb::blocked_range<Index>(Index{0}, Index{a.size()}, kGrainSize),
+        Scalar(0),
+        [&](tbb::blocked_range<Index> const& range, Scalar sum) {
+            auto const n = range.end() - range.begin();
+            return sum + a.segment(range.begin(), n).dot(b.segment(range.begin(), n));
+        },
+        [](Scalar lhs, Scalar rhs) { return lhs + rhs; });
+}
+
+inline void
+ConjugateGradient::Axpby(Scalar alpha, VectorX const& x, Scalar beta, Eigen::Ref<VectorX> y)
+{
+    tbb::parallel_for(
+        tbb::blocked_range<Index>(Index{0}, Index{x.size()}, kGrainSize),
+        [&](tbb::blocked_range<Index> const& range) {
+            auto const n = range.end() - range.begin();
+            y.segment(range.begin(), n) =
+                alpha * x.segment(range.begin(), n) + beta * y.segment(range.begin(), n);
+        });
+}
+
+} // namespace linalg
+} // namespace math
+} // namespace pbat
+
+#endif // PBAT_MATH_LINALG_CONJUGATE_GRADIENT_H
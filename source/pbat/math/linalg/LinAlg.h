@@ -1,7 +1,12 @@
 #ifndef PBAT_MATH_LINALG_LINALG_H
 #define PBAT_MATH_LINALG_LINALG_H
 
+#include "BlockSparseMatrix.h"
+#include "BlockSparsityPattern.h"
 #include "Cholmod.h"
+#include "ConjugateGradient.h"
+#include "Multigrid.h"
+#include "Preconditioners.h"
 #include "SparsityPattern.h"
 #include "mini/Mini.h"
 
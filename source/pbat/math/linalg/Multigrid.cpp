@@ -0,0 +1,387 @@
+#include "Multigrid.h"
+
+#include "ConjugateGradient.h"
+
+#include <algorithm>
+#include <cmath>
+#include <doctest/doctest.h>
+#include <exception>
+#include <fmt/core.h>
+#include <pbat/graph/Color.h>
+#include <string>
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+
+namespace pbat {
+namespace math {
+namespace linalg {
+
+Multigrid::Multigrid(
+    CSCMatrix const& A,
+    std::vector<CSCMatrix> const& P,
+    EMultigridSmoother eSmootherIn,
+    int smoothingIterationsIn)
+    : eSmoother(eSmootherIn),
+      smoothingIterations(smoothingIterationsIn),
+      mLevels(P.size() + 1),
+      mCoarseSolver()
+{
+    PBAT_PROFILE_NAMED_SCOPE("pbat.math.linalg.Multigrid.Construct");
+    if (A.rows() != A.cols())
+    {
+        std::string const what =
+            fmt::format("Expected square operator A, but got {}x{}", A.rows(), A.cols());
+        throw std::invalid_argument(what);
+    }
+    mLevels.front().A = A;
+    for (std::size_t l = 0; l < P.size(); ++l)
+    {
+        Level& L = mLevels[l];
+        if (P[l].rows() != L.A.rows())
+        {
+            std::string const what = fmt::format(
+                "Expected prolongation P[{}] with {} rows, but got {}x{}",
+                l,
+                L.A.rows(),
+                P[l].rows(),
+                P[l].cols());
+            throw std::invalid_argument(what);
+        }
+        L.P              = P[l];
+        L.Pt             = P[l].transpose();
+        mLevels[l + 1].A = L.Pt * L.A * L.P;
+        mLevels[l + 1].A.prune(Scalar(0));
+    }
+    // Smoothing data of all but the coarsest level. Both smoothers' data is precomputed, such that
+    // eSmoother may be changed after construction.
+    for (std::size_t l = 0; l + 1 < mLevels.size(); ++l)
+    {
+        Level& L        = mLevels[l];
+        VectorX const D = L.A.diagonal();
+        if ((D.array() == Scalar(0)).any())
+        {
+            std::string const what =
+                fmt::format("Expected non-zero diagonal of operator on level {}", l);
+            throw std::invalid_argument(what);
+        }
+        L.Dinv              = D.cwiseInverse();
+        using IndexVectorXi = Eigen::Vector<CSRMatrix::StorageIndex, Eigen::Dynamic>;
+        auto const ptr = Eigen::Map<IndexVectorXi const>(L.A.outerIndexPtr(), L.A.outerSize() + 1);
+        auto const adj = Eigen::Map<IndexVectorXi const>(L.A.innerIndexPtr(), L.A.nonZeros());
+        L.colors       = graph::ColorPartitions(graph::GreedyColor(ptr, adj));
+        L.lambdaMax    = EstimateLargestEigenvalue(L.A, L.Dinv);
+    }
+    CSCMatrix const Ac = mLevels.back().A;
+    mCoarseSolver.compute(Ac);
+    if (mCoarseSolver.info() != Eigen::ComputationInfo::Success)
+    {
+        std::string const what = fmt::format(
+            "Failed to factorize the {}x{} coarsest level operator",
+            Ac.rows(),
+            Ac.cols());
+        throw std::invalid_argument(what);
+    }
+}
+
+bool Multigrid::Solve(
+    Eigen::Ref<VectorX const> const& b,
+    Eigen::Ref<VectorX> x,
+    Index maxCycles,
+    Scalar tolerance)
+{
+    PBAT_PROFILE_NAMED_SCOPE("pbat.math.linalg.Multigrid.Solve");
+    Level const& L = mLevels.front();
+    if (b.size() != L.A.rows() or x.size() != L.A.rows())
+    {
+        std::string const what = fmt::format(
+            "Expected right-hand side and solution of dimensions {}, but got b={}, x={}",
+            L.A.rows(),
+            b.size(),
+            x.size());
+        throw std::invalid_argument(what);
+    }
+    mCycles            = 0;
+    mRelativeResidual  = Scalar(0);
+    Scalar const bNorm = b.norm();
+    if (bNorm == Scalar(0))
+    {
+        x.setZero();
+        return true;
+    }
+    VectorX const bb = b;
+    VectorX xx       = x;
+    VectorX r(bb.size());
+    Residual(L.A, bb, xx, r);
+    mRelativeResidual = r.norm() / bNorm;
+    while (mRelativeResidual > tolerance and mCycles < maxCycles)
+    {
+        VCycle(0, bb, xx);
+        Residual(L.A, bb, xx, r);
+        mRelativeResidual = r.norm() / bNorm;
+        ++mCycles;
+    }
+    x = xx;
+    return mRelativeResidual <= tolerance;
+}
+
+void Multigrid::Cycle(Eigen::Ref<VectorX const> const& b, Eigen::Ref<VectorX> x) const
+{
+    PBAT_PROFILE_NAMED_SCOPE("pbat.math.linalg.Multigrid.Cycle");
+    auto const n = mLevels.front().A.rows();
+    if (b.size() != n or x.size() != n)
+    {
+        std::string const what = fmt::format(
+            "Expected right-hand side and solution of dimensions {}, but got b={}, x={}",
+            n,
+            b.size(),
+            x.size());
+        throw std::invalid_argument(what);
+    }
+    VectorX const bb = b;
+    VectorX xx       = x;
+    VCycle(0, bb, xx);
+    x = xx;
+}
+
+Index Multigrid::NumberOfLevels() const
+{
+    return static_cast<Index>(mLevels.size());
+}
+
+CSRMatrix const& Multigrid::Operator(Index l) const
+{
+    return mLevels[static_cast<std::size_t>(l)].A;
+}
+
+void Multigrid::VCycle(std::size_t l, VectorX const& b, VectorX& x) const
+{
+    if (l + 1 == mLevels.size())
+    {
+        x = mCoarseSolver.solve(b);
+        return;
+    }
+    Level const& L = mLevels[l];
+    Smooth(L, b, x, false);
+    VectorX r(b.size());
+    Residual(L.A, b, x, r);
+    VectorX bc(L.Pt.rows());
+    Multiply(L.Pt, r, bc);
+    VectorX xc = VectorX::Zero(bc.size());
+    VCycle(l + 1, bc, xc);
+    Multiply(L.P, xc, r);
+    x += r;
+    // Post-smoothing in reverse order keeps the V-cycle symmetric
+    Smooth(L, b, x, true);
+}
+
+void Multigrid::Smooth(Level const& L, VectorX const& b, VectorX& x, bool bReverse) const
+{
+    switch (eSmoother)
+    {
+        case EMultigridSmoother::Chebyshev: Chebyshev(L, b, x); break;
+        default: GaussSeidel(L, b, x, bReverse); break;
+    }
+}
+
+void Multigrid::GaussSeidel(Level const& L, VectorX const& b, VectorX& x, bool bReverse) const
+{
+    PBAT_PROFILE_NAMED_SCOPE("pbat.math.linalg.Multigrid.GaussSeidel");
+    auto const nColors = L.colors.size();
+    auto const Relax   = [&](std::vector<Index> const& partition) {
+        tbb::parallel_for(std::size_t{0}, partition.size(), [&](std::size_t k) {
+            Index const i = partition[k];
+            Scalar ri     = b(i);
+            for (CSRMatrix::InnerIterator it(L.A, i); it; ++it)
+                if (it.col() != i)
+                    ri -= it.value() * x(it.col());
+            x(i) = ri * L.Dinv(i);
+        });
+    };
+    for (auto s = 0; s < smoothingIterations; ++s)
+    {
+        for (std::size_t c = 0; c < nColors; ++c)
+            Relax(L.colors[bReverse ? nColors - 1 - c : c]);
+    }
+}
+
+void Multigrid::Chebyshev(Level const& L, VectorX const& b, VectorX& x) const
+{
+    PBAT_PROFILE_NAMED_SCOPE("pbat.math.linalg.Multigrid.Chebyshev");
+    // Smoothing only needs to damp the upper part of D^{-1} A's spectrum, the coarse levels
+    // correct the lower part
+    Scalar const upper = Scalar(1.1) * L.lambdaMax;
+    Scalar const lower = Scalar(0.25) * upper;
+    Scalar const theta = Scalar(0.5) * (upper + lower);
+    Scalar const delta = Scalar(0.5) * (upper - lower);
+    Scalar const sigma = theta / delta;
+    Scalar rho         = Scalar(1) / sigma;
+    VectorX r(b.size());
+    VectorX Ad(b.size());
+    Residual(L.A, b, x, r);
+    VectorX d = L.Dinv.cwiseProduct(r) / theta;
+    for (auto k = 0; k < smoothingIterations; ++k)
+    {
+        x += d;
+        Multiply(L.A, d, Ad);
+        r -= Ad;
+        Scalar const rhoNext = Scalar(1) / (Scalar(2) * sigma - rho);
+        d   = (rhoNext * rho) * d + (Scalar(2) * rhoNext / delta) * L.Dinv.cwiseProduct(r);
+        rho = rhoNext;
+    }
+}
+
+void Multigrid::Multiply(CSRMatrix const& A, VectorX const& x, VectorX& y)
+{
+    tbb::parallel_for(
+        tbb::blocked_range<Index>(Index{0}, Index{A.rows()}),
+        [&](tbb::blocked_range<Index> const& range) {
+            for (auto i = range.begin(); i < range.end(); ++i)
+            {
+                Scalar yi{0};
+                for (CSRMatrix::InnerIterator it(A, i); it; ++it)
+                    yi += it.value() * x(it.col());
+                y(i) = yi;
+            }
+        });
+}
+
+void Multigrid::Residual(CSRMatrix const& A, VectorX const& b, VectorX const& x, VectorX& r)
+{
+    Multiply(A, x, r);
+    r = b - r;
+}
+
+Scalar Multigrid::EstimateLargestEigenvalue(CSRMatrix const& A, VectorX const& Dinv)
+{
+    PBAT_PROFILE_NAMED_SCOPE("pbat.math.linalg.Multigrid.EstimateLargestEigenvalue");
+    // Power iteration on D^{-1} A. The initial vector is chosen deterministically, and away from
+    // constant vectors, which often lie in (or close to) the operator's null space.
+    auto constexpr kIterations = 20;
+    VectorX v                  = VectorX::LinSpaced(A.rows(), Scalar(-1), Scalar(1));
+    v(0) += Scalar(1);
+    v.normalize();
+    VectorX Av(A.rows());
+    Scalar lambda{0};
+    for (auto k = 0; k < kIterations; ++k)
+    {
+        Multiply(A, v, Av);
+        Av.array() *= Dinv.array();
+        lambda = Av.norm();
+        if (lambda == Scalar(0))
+            break;
+        v = Av / lambda;
+    }
+    return lambda;
+}
+
+} // namespace linalg
+} // namespace math
+} // namespace pbat
+
+namespace pbat {
+namespace test {
+
+/**
+ * @brief 1D Poisson operator with Dirichlet boundary conditions on n interior grid points
+ */
+static CSCMatrix Poisson1D(Index n)
+{
+    std::vector<Eigen::Triplet<Scalar, Index>> triplets{};
+    for (auto i = 0; i < n; ++i)
+    {
+        triplets.push_back({i, i, Scalar(2)});
+        if (i > 0)
+            triplets.push_back({i, i - 1, Scalar(-1)});
+        if (i + 1 < n)
+            triplets.push_back({i, i + 1, Scalar(-1)});
+    }
+    CSCMatrix A(n, n);
+    A.setFromTriplets(triplets.begin(), triplets.end());
+    return A;
+}
+
+/**
+ * @brief Linear interpolation from nc coarse to 2*nc+1 fine interior grid points
+ */
+static CSCMatrix LinearProlongation1D(Index nc)
+{
+    std::vector<Eigen::Triplet<Scalar, Index>> triplets{};
+    for (auto j = 0; j < nc; ++j)
+    {
+        triplets.push_back({2 * j, j, Scalar(0.5)});
+        triplets.push_back({2 * j + 1, j, Scalar(1)});
+        triplets.push_back({2 * j + 2, j, Scalar(0.5)});
+    }
+    CSCMatrix P(2 * nc + 1, nc);
+    P.setFromTriplets(triplets.begin(), triplets.end());
+    return P;
+}
+
+struct SparseMatrixOperator
+{
+    template <class TDerivedIn, class TDerivedOut>
+    void Apply(Eigen::MatrixBase<TDerivedIn> const& x, Eigen::DenseBase<TDerivedOut>& y) const
+    {
+        y += A * x;
+    }
+
+    CSCMatrix ToMatrix() const { return A; }
+    Index OutputDimensions() const { return A.rows(); }
+    Index InputDimensions() const { return A.cols(); }
+
+    CSCMatrix A;
+};
+
+} // namespace test
+} // namespace pbat
+
+TEST_CASE("[math][linalg] Multigrid")
+{
+    using namespace pbat;
+    using math::linalg::EMultigridSmoother;
+    using math::linalg::Multigrid;
+    CHECK(math::linalg::CPreconditioner<Multigrid>);
+
+    // 3-level hierarchy of 1D Poisson problems
+    auto constexpr n  = 127;
+    CSCMatrix const A = test::Poisson1D(n);
+    std::vector<CSCMatrix> const P{test::LinearProlongation1D(63), test::LinearProlongation1D(31)};
+    VectorX const b            = VectorX::Ones(n);
+    Scalar constexpr tolerance = 1e-10;
+    for (auto eSmoother : {EMultigridSmoother::GaussSeidel, EMultigridSmoother::Chebyshev})
+    {
+        Multigrid mg(A, P, eSmoother, 2);
+        CHECK_EQ(mg.NumberOfLevels(), 3);
+        // Galerkin operators of linear interpolation are scaled rediscretizations
+        CSCMatrix const A1         = mg.Operator(1);
+        Scalar const galerkinError = (A1 - Scalar(0.5) * test::Poisson1D(63)).norm();
+        CHECK_LE(galerkinError, 1e-14);
+
+        // Standalone solve converges in a mesh-independent number of cycles
+        VectorX x = VectorX::Zero(n);
+        CHECK(mg.Solve(b, x, 30, tolerance));
+        CHECK_LE(mg.RelativeResidual(), tolerance);
+        CHECK_LE((b - A * x).norm() / b.norm(), tolerance);
+        CHECK_LT(mg.Cycles(), 30);
+
+        // Warm start from the solution does not cycle
+        CHECK(mg.Solve(b, x, 30, tolerance));
+        CHECK_EQ(mg.Cycles(), 0);
+
+        // Multigrid preconditioned conjugate gradients beat unpreconditioned ones
+        test::SparseMatrixOperator const op{A};
+        math::linalg::ConjugateGradient cg(1000, tolerance);
+        x.setZero();
+        CHECK(cg.Solve(op, b, x));
+        Index const cgIterations = cg.Iterations();
+        x.setZero();
+        CHECK(cg.Solve(op, mg, b, x));
+        CHECK_LT(cg.Iterations(), cgIterations / 4);
+        CHECK_LE((b - A * x).norm() / b.norm(), 10 * tolerance);
+    }
+
+    // Mismatched prolongation
+    CHECK_THROWS_AS(
+        Multigrid(A, std::vector<CSCMatrix>{test::LinearProlongation1D(31)}),
+        std::invalid_argument);
+}
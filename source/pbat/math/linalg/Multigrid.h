@@ -0,0 +1,149 @@
+#ifndef PBAT_MATH_LINALG_MULTIGRID_H
+#define PBAT_MATH_LINALG_MULTIGRID_H
+
+#include "PhysicsBasedAnimationToolkitExport.h"
+
+#include <Eigen/SparseCholesky>
+#include <pbat/Aliases.h>
+#include <pbat/profiling/Profiling.h>
+#include <vector>
+
+namespace pbat {
+namespace math {
+namespace linalg {
+
+enum class EMultigridSmoother {
+    GaussSeidel, ///< Symmetric Gauss-Seidel, parallel over the colors of the operator's graph
+    Chebyshev    ///< Jacobi preconditioned Chebyshev polynomial smoothing
+};
+
+/**
+ * @brief Multigrid solver for sparse symmetric positive definite systems, using Galerkin coarse
+ * operators A_{l+1} = P_l^T A_l P_l, V-cycles, and a direct solve on the coarsest level.
+ *
+ * Usable as a standalone solver, or as a preconditioner of ConjugateGradient, in which case each
+ * preconditioner application performs a single V-cycle from a zero initial guess. Both smoothers
+ * yield a symmetric V-cycle, as required by conjugate gradients.
+ */
+class Multigrid
+{
+  public:
+    PBAT_API Multigrid() = default;
+    /**
+     * @brief
+     * @param A |#dofs| x |#dofs| symmetric positive definite operator on the finest level
+     * @param P |#levels-1| prolongation operators, such that P[l] maps level l+1 to level l, i.e.
+     * P[l] is |#dofs_l| x |#dofs_{l+1}|, e.g. obtained by fem::ProlongationMatrix
+     * @param eSmoother Smoother used on all but the coarsest level
+     * @param smoothingIterations Number of pre- and post-smoothing sweeps (or Chebyshev polynomial
+     * degree)
+     */
+    PBAT_API Multigrid(
+        CSCMatrix const& A,
+        std::vector<CSCMatrix> const& P,
+        EMultigridSmoother eSmoother = EMultigridSmoother::GaussSeidel,
+        int smoothingIterations      = 2);
+
+    /**
+     * @brief Applies this multigrid hierarchy as a preconditioner, i.e. z = V(r) for a single
+     * V-cycle V starting from z = 0
+     *
+     * @tparam TDerivedIn
+     * @tparam TDerivedOut
+     * @param r |#dofs| residual
+     * @param z |#dofs| preconditioned residual
+     */
+    template <class TDerivedIn, class TDerivedOut>
+    void Solve(Eigen::MatrixBase<TDerivedIn> const& r, Eigen::DenseBase<TDerivedOut>& z) const;
+
+    /**
+     * @brief Solves Ax = b by repeated V-cycles, starting from the initial guess x
+     *
+     * @param b |#dofs| right-hand side
+     * @param x |#dofs| initial guess, overwritten by the solution
+     * @param maxCycles Maximum number of V-cycles
+     * @param tolerance Relative residual tolerance, i.e. cycles stop once |b - Ax| <=
+     * tolerance * |b|
+     * @return True if the relative residual tolerance was reached
+     */
+    PBAT_API bool Solve(
+        Eigen::Ref<VectorX const> const& b,
+        Eigen::Ref<VectorX> x,
+        Index maxCycles,
+        Scalar tolerance);
+
+    /**
+     * @brief Improves the solution x of Ax = b by a single V-cycle
+     *
+     * @param b |#dofs| right-hand side
+     * @param x |#dofs| current solution, overwritten by the improved solution
+     */
+    PBAT_API void Cycle(Eigen::Ref<VectorX const> const& b, Eigen::Ref<VectorX> x) const;
+
+    /**
+     * @brief
+     * @return Number of levels, including the finest and coarsest levels
+     */
+    PBAT_API Index NumberOfLevels() const;
+    /**
+     * @brief
+     * @param l Level index, where 0 is the finest level
+     * @return Galerkin operator of level l
+     */
+    PBAT_API CSRMatrix const& Operator(Index l) const;
+    /**
+     * @brief
+     * @return Number of V-cycles of the last standalone solve
+     */
+    Index Cycles() const { return mCycles; }
+    /**
+     * @brief
+     * @return Relative residual |b - Ax| / |b| of the last standalone solve
+     */
+    Scalar RelativeResidual() const { return mRelativeResidual; }
+
+    EMultigridSmoother eSmoother{EMultigridSmoother::GaussSeidel}; ///< Smoother
+    int smoothingIterations{2};                                    ///< Number of smoothing sweeps
+
+  private:
+    struct Level
+    {
+        CSRMatrix A;                            ///< Galerkin operator
+        CSRMatrix P;                            ///< Prolongation from the next coarser level
+        CSRMatrix Pt;                           ///< Restriction to the next coarser level
+        VectorX Dinv;                           ///< Inverse diagonal of A
+        std::vector<std::vector<Index>> colors; ///< Color partitions of A's rows
+        Scalar lambdaMax{0.};                   ///< Estimate of the largest eigenvalue of D^{-1} A
+    };
+
+    void VCycle(std::size_t l, VectorX const& b, VectorX& x) const;
+    void Smooth(Level const& L, VectorX const& b, VectorX& x, bool bReverse) const;
+    void GaussSeidel(Level const& L, VectorX const& b, VectorX& x, bool bReverse) const;
+    void Chebyshev(Level const& L, VectorX const& b, VectorX& x) const;
+
+    static void Multiply(CSRMatrix const& A, VectorX const& x, VectorX& y);
+    static void Residual(CSRMatrix const& A, VectorX const& b, VectorX const& x, VectorX& r);
+    static Scalar EstimateLargestEigenvalue(CSRMatrix const& A, VectorX const& Dinv);
+
+    std::vector<Level> mLevels;                     ///< Levels, from finest to coarsest
+    Eigen::SimplicialLDLT<CSCMatrix> mCoarseSolver; ///< Factorization of the coarsest operator
+    Index mCycles{0};                               ///< Number of V-cycles of the last solve
+    Scalar mRelativeResidual{0.};                   ///< Relative residual of the last solve
+};
+
+template <class TDerivedIn, class TDerivedOut>
+inline void
+Multigrid::Solve(Eigen::MatrixBase<TDerivedIn> const& r, Eigen::DenseBase<TDerivedOut>& z) const
+{
+    PBAT_PROFILE_NAMED_SCOPE("pbat.math.linalg.Multigrid.Precondition");
+    VectorX const b = r;
+    VectorX x       = VectorX::Zero(b.size());
+    Cycle(b, x);
+    z = x;
+}
+
+} // namespace linalg
+} // namespace math
+} // namespace pbat
+
+#endif // PBAT_MATH_LINALG_MULTIGRID_H
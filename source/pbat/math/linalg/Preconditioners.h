@@ -0,0 +1,192 @@
+#ifndef PBAT_MATH_LINALG_PRECONDITIONERS_H
+#define PBAT_MATH_LINALG_PRECONDITIONERS_H
+
+#include <Eigen/LU>
+#include <concepts>
+#include <exception>
+#include <fmt/core.h>
+#include <pbat/Aliases.h>
+#include <pbat/profiling/Profiling.h>
+#include <string>
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#include <utility>
+
+namespace pbat {
+namespace math {
+namespace linalg {
+
+/**
+ * @brief Concept for preconditioners M of iterative solvers, which overwrite z with M^{-1} r
+ * without requiring the coefficients of the preconditioned linear operator.
+ */
+template <class T>
+concept CPreconditioner = requires(T t)
+{
+    {t.Solve(VectorX{}, std::declval<VectorX&>())};
+};
+
+/**
+ * @brief Preconditioner M = I, i.e. no preconditioning
+ */
+struct IdentityPreconditioner
+{
+    template <class TDerivedIn, class TDerivedOut>
+    void Solve(Eigen::MatrixBase<TDerivedIn> const& r, Eigen::DenseBase<TDerivedOut>& z) const
+    {
+        z = r;
+    }
+};
+
+/**
+ * @brief Jacobi preconditioner M = diag(A)
+ */
+class JacobiPreconditioner
+{
+  public:
+    JacobiPreconditioner() = default;
+    /**
+     * @brief
+     * @param D |#dofs| diagonal of the preconditioned operator, e.g. obtained by Diagonal() on FEM
+     * operators
+     */
+    JacobiPreconditioner(Eigen::Ref<VectorX const> const& D);
+
+    template <class TDerivedIn, class TDerivedOut>
+    void Solve(Eigen::MatrixBase<TDerivedIn> const& r, Eigen::DenseBase<TDerivedOut>& z) const;
+
+  private:
+    VectorX Dinv; ///< |#dofs| inverse diagonal
+};
+
+/**
+ * @brief Block Jacobi preconditioner M = blockdiag(A), e.g. with the kDims x kDims node blocks of
+ * FEM operators on vector-valued functions.
+ *
+ * @tparam BlockSize Number of rows (and columns) of each diagonal block
+ */
+template <int BlockSize>
+class BlockJacobiPreconditioner
+{
+  public:
+    static int constexpr kBlockSize = BlockSize;
+
+    BlockJacobiPreconditioner() = default;
+    /**
+     * @brief
+     * @param D |kBlockSize| x |kBlockSize * #blocks| diagonal blocks of the preconditioned
+     * operator, e.g. obtained by BlockDiagonal() on FEM operators
+     */
+    BlockJacobiPreconditioner(Eigen::Ref<MatrixX const> const& D);
+
+    template <class TDerivedIn, class TDerivedOut>
+    void Solve(Eigen::MatrixBase<TDerivedIn> const& r, Eigen::DenseBase<TDerivedOut>& z) const;
+
+  private:
+    MatrixX Dinv; ///< |kBlockSize| x |kBlockSize * #blocks| inverse diagonal blocks
+};
+
+inline JacobiPreconditioner::JacobiPreconditioner(Eigen::Ref<VectorX const> const& D) : Dinv()
+{
+    PBAT_PROFILE_NAMED_SCOPE("pbat.math.linalg.JacobiPreconditioner.Construct");
+    if ((D.array() == Scalar(0)).any())
+    {
+        std::string const what = "Expected non-zero diagonal for Jacobi preconditioner";
+        throw std::invalid_argument(what);
+    }
+    Dinv = D.cwiseInverse();
+}
+
+template <class TDerivedIn, class TDerivedOut>
+inline void JacobiPreconditioner::Solve(
+    Eigen::MatrixBase<TDerivedIn> const& r,
+    Eigen::DenseBase<TDerivedOut>& z) const
+{
+    PBAT_PROFILE_NAMED_SCOPE("pbat.math.linalg.JacobiPreconditioner.Solve");
+    if (r.rows() != Dinv.size() or z.rows() != Dinv.size())
+    {
+        std::string const what = fmt::format(
+            "Expected input and output with {} rows, but got r.rows()={}, z.rows()={}",
+            Dinv.size(),
+            r.rows(),
+            z.rows());
+        throw std::invalid_argument(what);
+    }
+    tbb::parallel_for(
+        tbb::blocked_range<Index>(Index{0}, Index{Dinv.size()}),
+        [&](tbb::blocked_range<Index> const& range) {
+            auto const n = range.end() - range.begin();
+            z.segment(range.begin(), n) =
+                Dinv.segment(range.begin(), n).cwiseProduct(r.segment(range.begin(), n));
+        });
+}
+
+template <int BlockSize>
+inline BlockJacobiPreconditioner<BlockSize>::BlockJacobiPreconditioner(
+    Eigen::Ref<MatrixX const> const& D)
+    : Dinv(D.rows(), D.cols())
+{
+    PBAT_PROFILE_NAMED_SCOPE("pbat.math.linalg.BlockJacobiPreconditioner.Construct");
+    if (D.rows() != kBlockSize or D.cols() % kBlockSize != 0)
+    {
+        std::string const what = fmt::format(
+            "Expected {} x |{} * #blocks| diagonal blocks, but got {}x{}",
+            kBlockSize,
+            kBlockSize,
+            D.rows(),
+            D.cols());
+        throw std::invalid_argument(what);
+    }
+    auto const nBlocks = D.cols() / kBlockSize;
+    Eigen::Vector<bool, Eigen::Dynamic> bIsInvertible(nBlocks);
+    tbb::parallel_for(Index{0}, Index{nBlocks}, [&](Index b) {
+        Matrix<kBlockSize, kBlockSize> const Db =
+            D.template block<kBlockSize, kBlockSize>(0, b * kBlockSize);
+        Matrix<kBlockSize, kBlockSize> Dbinv{};
+        bool bIsBlockInvertible{false};
+        Db.computeInverseWithCheck(Dbinv, bIsBlockInvertible, Scalar(0));
+        bIsInvertible(b)                                      = bIsBlockInvertible;
+        Dinv.block<kBlockSize, kBlockSize>(0, b * kBlockSize) = Dbinv;
+    });
+    for (auto b = 0; b < nBlocks; ++b)
+    {
+        if (not bIsInvertible(b))
+        {
+            std::string const what = fmt::format(
+                "Expected invertible diagonal blocks for block Jacobi preconditioner, but block {} "
+                "is singular",
+                b);
+            throw std::invalid_argument(what);
+        }
+    }
+}
+
+template <int BlockSize>
+template <class TDerivedIn, class TDerivedOut>
+inline void BlockJacobiPreconditioner<BlockSize>::Solve(
+    Eigen::MatrixBase<TDerivedIn> const& r,
+    Eigen::DenseBase<TDerivedOut>& z) const
+{
+    PBAT_PROFILE_NAMED_SCOPE("pbat.math.linalg.BlockJacobiPreconditioner.Solve");
+    if (r.rows() != Dinv.cols() or z.rows() != Dinv.cols())
+    {
+        std::string const what = fmt::format(
+            "Expected input and output with {} rows, but got r.rows()={}, z.rows()={}",
+            Dinv.cols(),
+            r.rows(),
+            z.rows());
+        throw std::invalid_argument(what);
+    }
+    auto const nBlocks = Dinv.cols() / kBlockSize;
+    tbb::parallel_for(Index{0}, Index{nBlocks}, [&](Index b) {
+        z.template segment<kBlockSize>(b * kBlockSize) =
+            Dinv.block<kBlockSize, kBlockSize>(0, b * kBlockSize) *
+            r.template segment<kBlockSize>(b * kBlockSize);
+    });
+}
+
+} // namespace linalg
+} // namespace math
+} // namespace pbat
+
+#endif // PBAT_MATH_LINALG_PRECONDITIONERS_H
@@ -6,7 +6,27 @@ namespace linalg {
 
 bool SparsityPattern::IsEmpty() const
 {
-    return ij.empty();
+    return uk.empty();
+}
+
+CSCMatrix const& SparsityPattern::Pattern() const
+{
+    return A;
+}
+
+std::vector<Index> const& SparsityPattern::UniqueNonZeroOffsets() const
+{
+    return up;
+}
+
+std::vector<Index> const& SparsityPattern::DuplicateNonZeroIndices() const
+{
+    return uk;
+}
+
+std::vector<Index> const& SparsityPattern::UniqueNonZeroIndices() const
+{
+    return ku;
 }
 
 } // namespace linalg
@@ -51,4 +71,26 @@ TEST_CASE("[math][linalg] SparsityPattern")
     Scalar const error    = (Adense - Aexpected).norm() / Aexpected.norm();
     Scalar constexpr zero = 1e-15;
     CHECK_LE(error, zero);
+
+    // In-place value updates reuse A's pattern
+    CSCMatrix Ain = A;
+    std::vector<Scalar> nonZeros2(nonZeros.size(), 2.);
+    sparsityPattern.ToMatrix(nonZeros2, Ain);
+    Scalar const inPlaceError = (MatrixX(Ain) - 2. * Aexpected).norm() / Aexpected.norm();
+    CHECK_LE(inPlaceError, zero);
+    CSCMatrix Awrong(nRows, nCols);
+    CHECK_THROWS_AS(sparsityPattern.ToMatrix(nonZeros2, Awrong), std::invalid_argument);
+
+    // Patching the unique non-zeros of changed duplicate non-zeros matches full assembly
+    std::vector<Index> const& ku = sparsityPattern.UniqueNonZeroIndices();
+    CHECK_EQ(ku.size(), nonZeros.size());
+    for (auto k = 0ULL; k < ku.size(); ++k)
+        CHECK_EQ(Ain.innerIndexPtr()[ku[k]], rowIndices[k]);
+    nonZeros2[0] = 3.;
+    nonZeros2[7] = 3.;
+    std::vector<Index> const changedUnique{{ku[0], ku[7]}};
+    sparsityPattern.ToMatrix(nonZeros2, changedUnique, Ain);
+    CSCMatrix const Apatched = sparsityPattern.ToMatrix(nonZeros2);
+    Scalar const patchError  = (MatrixX(Ain) - MatrixX(Apatched)).norm() / Aexpected.norm();
+    CHECK_LE(patchError, zero);
 }
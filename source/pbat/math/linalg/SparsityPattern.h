@@ -8,11 +8,13 @@
 #include <pbat/Aliases.h>
 #include <pbat/common/Concepts.h>
 #include <pbat/profiling/Profiling.h>
-#include <range/v3/action/sort.hpp>
-#include <range/v3/range/conversion.hpp>
-#include <range/v3/view/iota.hpp>
-#include <range/v3/view/unique.hpp>
+#include <cstdint>
+#include <functional>
 #include <ranges>
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#include <tbb/parallel_scan.h>
+#include <tbb/parallel_sort.h>
 #include <type_traits>
 #include <utility>
 #include <vector>
@@ -44,11 +46,72 @@ class SparsityPattern
     template <common::CArithmeticRange TNonZeroRange>
     CSCMatrix ToMatrix(TNonZeroRange&& nonZeros) const;
 
+    /**
+     * @brief Overwrites the values of Ain, which must have this sparsity pattern, with the sum of
+     * duplicate non-zeros, in parallel.
+     *
+     * Ain is typically the result of a previous call to ToMatrix(nonZeros), such that repeated
+     * assemblies (e.g. of Newton hessians) reuse Ain's storage.
+     *
+     * @tparam TNonZeroRange
+     * @param nonZeros Non-zero values in the order of the (row,col) indices passed to Compute
+     * @param Ain Compressed matrix with this sparsity pattern
+     */
+    template <common::CArithmeticRange TNonZeroRange>
+    void ToMatrix(TNonZeroRange&& nonZeros, CSCMatrix& Ain) const;
+
+    /**
+     * @brief Overwrites only the given unique non-zeros of Ain, which must have this sparsity
+     * pattern, with the sum of their duplicate non-zeros, in parallel.
+     *
+     * Local changes to the (duplicate) non-zeros, e.g. to a few element matrices, can thus be
+     * patched into Ain in time proportional to the change, using UniqueNonZeroIndices() to find
+     * the affected unique non-zeros.
+     *
+     * @tparam TNonZeroRange
+     * @tparam TUniqueNonZeroRange
+     * @param nonZeros Non-zero values in the order of the (row,col) indices passed to Compute
+     * @param uniqueNonZeros Distinct unique non-zero indices (in the storage order of Pattern()) to
+     * overwrite
+     * @param Ain Compressed matrix with this sparsity pattern
+     */
+    template <common::CArithmeticRange TNonZeroRange, common::CIndexRange TUniqueNonZeroRange>
+    void ToMatrix(
+        TNonZeroRange&& nonZeros,
+        TUniqueNonZeroRange&& uniqueNonZeros,
+        CSCMatrix& Ain) const;
+
     PBAT_API bool IsEmpty() const;
 
+    /**
+     * @brief Compressed matrix of unique non-zeros (with zero values)
+     * @return
+     */
+    PBAT_API CSCMatrix const& Pattern() const;
+    /**
+     * @brief |#unique non-zeros + 1| offsets into DuplicateNonZeroIndices(), such that unique
+     * non-zero u (in the storage order of Pattern()) gathers duplicates
+     * DuplicateNonZeroIndices()[UniqueNonZeroOffsets()[u]:UniqueNonZeroOffsets()[u+1]]
+     * @return
+     */
+    PBAT_API std::vector<Index> const& UniqueNonZeroOffsets() const;
+    /**
+     * @brief (Triplet/duplicate) non-zero indices grouped by unique non-zero
+     * @return
+     */
+    PBAT_API std::vector<Index> const& DuplicateNonZeroIndices() const;
+    /**
+     * @brief Unique non-zero index (in the storage order of Pattern()) of each (triplet/duplicate)
+     * non-zero
+     * @return
+     */
+    PBAT_API std::vector<Index> const& UniqueNonZeroIndices() const;
+
   private:
-    std::vector<Index> ij; ///< Maps (triplet/duplicate) non-zero index k to its corresponding index
-                           ///< into the unique non-zero list
+    std::vector<Index> up; ///< |#unique non-zeros + 1| prefix s.t. unique non-zero u is the sum of
+                           ///< (triplet/duplicate) non-zeros uk[up[u]], ..., uk[up[u+1]-1]
+    std::vector<Index> uk; ///< (Triplet/duplicate) non-zero indices k grouped by unique non-zero
+    std::vector<Index> ku; ///< Unique non-zero index u of each (triplet/duplicate) non-zero k
     CSCMatrix A;           ///< Sparsity pattern + unique non-zeros
 };
 
@@ -78,13 +141,9 @@ inline void SparsityPattern::Compute(
     TColIndexRange&& colIndices)
 {
     PBAT_PROFILE_NAMED_SCOPE("pbat.math.linalg.SparsityPattern.Compute");
-    namespace srng   = std::ranges;
-    namespace sviews = std::views;
-    namespace rng    = ranges;
-    namespace views  = rng::views;
+    namespace srng = std::ranges;
 
     A = CSCMatrix(nRows, nCols);
-    ij.resize(srng::size(rowIndices), Index{0});
 
     auto const [rowMin, rowMax] = srng::minmax_element(rowIndices);
     auto const [colMin, colMax] = srng::minmax_element(colIndices);
@@ -118,39 +177,84 @@ inline void SparsityPattern::Compute(
     auto rows = srng::data(rowIndices);
     auto cols = srng::data(colIndices);
 
-    auto const indexPair = [&](Index s) {
-        return std::make_pair(cols[s], rows[s]);
-    };
-    auto const less = [&](Index lhs, Index rhs) {
-        return indexPair(lhs) < indexPair(rhs);
-    };
-    auto const equal = [&](Index lhs, Index rhs) {
-        return indexPair(lhs) == indexPair(rhs);
-    };
+    // Pack (col,row) into 64-bit keys, such that sorting keys sorts non-zeros in column-major
+    // order. Ties (i.e. duplicates) are broken by the non-zero index k for determinism.
+    using KeyType                = std::uint64_t;
     auto const numNonZeroIndices = static_cast<Index>(nRowIndices);
+    auto const nz                = static_cast<std::size_t>(numNonZeroIndices);
+    std::vector<std::pair<KeyType, Index>> keys(nz);
+    tbb::parallel_for(Index{0}, numNonZeroIndices, [&](Index k) {
+        auto const kk = static_cast<std::size_t>(k);
+        keys[kk]      = std::make_pair(
+            static_cast<KeyType>(cols[kk]) * static_cast<KeyType>(nRows) +
+                static_cast<KeyType>(rows[kk]),
+            k);
+    });
     // NOTE: Bottleneck is the sort
-    auto const sortedNonZeroIndices = views::iota(Index{0}, numNonZeroIndices) |
-                                      rng::to<std::vector>() | rng::actions::sort(less);
-    auto const sortedUniqueNonZeroIndices =
-        sortedNonZeroIndices | views::unique(equal) | rng::to<std::vector>();
+    tbb::parallel_sort(keys.begin(), keys.end());
 
-    IndexVectorX cc = IndexVectorX::Zero(nCols);
-    for (auto u : sortedUniqueNonZeroIndices)
-        ++cc[cols[u]];
+    // Duplicates of a unique non-zero are contiguous in the sorted non-zeros, such that the
+    // unique non-zero index of sorted non-zero i is the number of key changes before i.
+    auto const bIsUnique = [&](std::size_t i) {
+        return i == 0ULL or keys[i].first != keys[i - 1ULL].first;
+    };
+    uk.resize(nz);
+    ku.resize(nz);
+    std::vector<Index> u(nz);
+    Index const numUniqueNonZeroIndices = tbb::parallel_scan(
+        tbb::blocked_range<std::size_t>(0ULL, nz),
+        Index{0},
+        [&](tbb::blocked_range<std::size_t> const& r, Index sum, bool bIsFinalScan) {
+            for (auto i = r.begin(); i < r.end(); ++i)
+            {
+                if (bIsUnique(i))
+                    ++sum;
+                if (bIsFinalScan)
+                {
+                    u[i]  = sum - 1;
+                    uk[i] = keys[i].second;
+                }
+            }
+            return sum;
+        },
+        std::plus<Index>{});
+    auto const nu = static_cast<std::size_t>(numUniqueNonZeroIndices);
+    up.resize(nu + 1ULL);
+    up.back() = numNonZeroIndices;
+    tbb::parallel_for(std::size_t{0}, nz, [&](std::size_t i) {
+        ku[static_cast<std::size_t>(uk[i])] = u[i];
+        if (bIsUnique(i))
+            up[static_cast<std::size_t>(u[i])] = static_cast<Index>(i);
+    });
 
-    for (auto k = 0, u = 0; k < numNonZeroIndices; ++k)
-    {
-        // NOTE: Yes, the casting is just absurd here... otherwise code
-        // doesn't compile with agressive warnings on signed/unsigned mismatch
-        auto const s                    = sortedNonZeroIndices[static_cast<std::size_t>(k)];
-        auto const uu                   = sortedUniqueNonZeroIndices[static_cast<std::size_t>(u)];
-        bool const bIsSameEntry         = equal(s, uu);
-        ij[static_cast<std::size_t>(s)] = static_cast<Index>(bIsSameEntry ? u : ++u);
-    }
-    A.reserve(cc);
-    for (auto s : sortedUniqueNonZeroIndices)
-        A.insert(rows[s], cols[s]) = 0.;
-    A.makeCompressed();
+    // Construct CSC arrays directly from the sorted unique non-zeros
+    using SparseIndex = typename CSCMatrix::StorageIndex;
+    A.resizeNonZeros(numUniqueNonZeroIndices);
+    SparseIndex* const innerIndices = A.innerIndexPtr();
+    SparseIndex* const outerIndices = A.outerIndexPtr();
+    Scalar* const values            = A.valuePtr();
+    auto const colOf                = [&](std::size_t uu) {
+        KeyType const key = keys[static_cast<std::size_t>(up[uu])].first;
+        return static_cast<Index>(key / static_cast<KeyType>(nRows));
+    };
+    tbb::parallel_for(std::size_t{0}, nu, [&](std::size_t uu) {
+        KeyType const key = keys[static_cast<std::size_t>(up[uu])].first;
+        innerIndices[uu]  = static_cast<SparseIndex>(key % static_cast<KeyType>(nRows));
+        values[uu]        = Scalar{0};
+    });
+    // Column j's non-zeros start at the first unique non-zero whose column is >= j
+    tbb::parallel_for(Index{0}, nCols + 1, [&](Index j) {
+        std::size_t lo{0ULL}, hi{nu};
+        while (lo < hi)
+        {
+            auto const mid = lo + (hi - lo) / 2ULL;
+            if (colOf(mid) < j)
+                lo = mid + 1ULL;
+            else
+                hi = mid;
+        }
+        outerIndices[j] = static_cast<SparseIndex>(lo);
+    });
 }
 
 template <common::CArithmeticRange TNonZeroRange>
@@ -161,19 +265,65 @@ CSCMatrix SparsityPattern::ToMatrix(TNonZeroRange&& nonZeros) const
         std::is_same_v<Scalar, std::ranges::range_value_t<TNonZeroRange>>,
         "Only Scalar non-zero values are accepted");
 
+    CSCMatrix Acpy{A};
+    ToMatrix(std::forward<TNonZeroRange>(nonZeros), Acpy);
+    return Acpy;
+}
+
+template <common::CArithmeticRange TNonZeroRange>
+void SparsityPattern::ToMatrix(TNonZeroRange&& nonZeros, CSCMatrix& Ain) const
+{
+    PBAT_PROFILE_NAMED_SCOPE("pbat.math.linalg.SparsityPattern.ToMatrixInPlace");
+    auto const nUnique = static_cast<Index>(up.size()) - 1;
+    ToMatrix(std::forward<TNonZeroRange>(nonZeros), std::views::iota(Index{0}, nUnique), Ain);
+}
+
+template <common::CArithmeticRange TNonZeroRange, common::CIndexRange TUniqueNonZeroRange>
+void SparsityPattern::ToMatrix(
+    TNonZeroRange&& nonZeros,
+    TUniqueNonZeroRange&& uniqueNonZeros,
+    CSCMatrix& Ain) const
+{
+    PBAT_PROFILE_NAMED_SCOPE("pbat.math.linalg.SparsityPattern.ToMatrixUnique");
+    static_assert(
+        std::is_same_v<Scalar, std::ranges::range_value_t<TNonZeroRange>>,
+        "Only Scalar non-zero values are accepted");
+
     namespace rng  = std::ranges;
     auto const nnz = rng::size(nonZeros);
-    if (nnz != ij.size())
+    if (nnz != uk.size())
     {
-        std::string const what = fmt::format("Expected {} non zeros, got {}", ij.size(), nnz);
+        std::string const what = fmt::format("Expected {} non zeros, got {}", uk.size(), nnz);
+        throw std::invalid_argument(what);
+    }
+    bool const bHasSamePattern = Ain.isCompressed() and (Ain.rows() == A.rows()) and
+                                 (Ain.cols() == A.cols()) and (Ain.nonZeros() == A.nonZeros());
+    if (not bHasSamePattern)
+    {
+        std::string const what = fmt::format(
+            "Expected compressed {}x{} matrix with {} non zeros, but got {}x{} matrix with {} "
+            "non zeros",
+            A.rows(),
+            A.cols(),
+            A.nonZeros(),
+            Ain.rows(),
+            Ain.cols(),
+            Ain.nonZeros());
         throw std::invalid_argument(what);
     }
 
-    CSCMatrix Acpy{A};
-    Scalar* values = Acpy.valuePtr();
-    for (auto k = 0ULL; k < nnz; ++k)
-        values[ij[k]] += nonZeros[k];
-    return Acpy;
+    Scalar* values      = Ain.valuePtr();
+    auto const nUpdates = static_cast<Index>(rng::size(uniqueNonZeros));
+    auto const uBegin   = rng::begin(uniqueNonZeros);
+    tbb::parallel_for(Index{0}, nUpdates, [&](Index i) {
+        auto const u      = static_cast<Index>(uBegin[i]);
+        auto const kBegin = static_cast<std::size_t>(up[static_cast<std::size_t>(u)]);
+        auto const kEnd   = static_cast<std::size_t>(up[static_cast<std::size_t>(u + 1)]);
+        Scalar value{0};
+        for (auto k = kBegin; k < kEnd; ++k)
+            value += nonZeros[static_cast<std::size_t>(uk[k])];
+        values[u] = value;
+    });
 }
 
 } // namespace linalg
@@ -3,6 +3,7 @@
 
 #include "HyperElasticity.h"
 #include "SaintVenantKirchhoffEnergy.h"
+#include "SpdProjection.h"
 #include "StableNeoHookeanEnergy.h"
 
 #endif // PBAT_PHYSICS_PHYSICS_H
\ No newline at end of file
@@ -0,0 +1,48 @@
+#include "SpdProjection.h"
+
+#include <doctest/doctest.h>
+#include <pbat/common/ConstexprFor.h>
+
+TEST_CASE("[physics] SpdProjection")
+{
+    using namespace pbat;
+    namespace mini          = pbat::math::linalg::mini;
+    Scalar constexpr Y      = 1e6;
+    Scalar constexpr nu     = 0.45;
+    auto const [mu, lambda] = physics::LameCoefficients(Y, nu);
+    Scalar constexpr zero   = 1e-10;
+    common::ForTypes<physics::StableNeoHookeanEnergy<3>, physics::SaintVenantKirchhoffEnergy<3>>(
+        [&]<class ElasticEnergyType>() {
+            CHECK(physics::CHasAnalyticEigenSystem<ElasticEnergyType>);
+            ElasticEnergyType Psi{};
+            std::srand(0);
+            for (auto t = 0; t < 10; ++t)
+            {
+                // Stretched, compressed and inverted deformation gradients
+                Matrix<3, 3> F = Matrix<3, 3>::Identity() + Matrix<3, 3>::Random();
+                if (t % 2 == 1)
+                    F.col(0) *= Scalar(-1);
+                auto const vecF       = mini::FromEigen(F);
+                auto const hessPsiF   = Psi.hessian(vecF, mu, lambda);
+                Matrix<9, 9> const HF = mini::ToEigen(hessPsiF);
+                Eigen::SelfAdjointEigenSolver<Matrix<9, 9>> eigs(HF);
+                Vector<9> const l = eigs.eigenvalues().cwiseMax(Scalar(0));
+                Matrix<9, 9> const HExpected =
+                    eigs.eigenvectors() * l.asDiagonal() * eigs.eigenvectors().transpose();
+                Matrix<9, 9> const H = physics::ProjectedHessian(Psi, F, mu, lambda);
+                Scalar const error   = (H - HExpected).norm() / HExpected.norm();
+                CHECK_LE(error, zero);
+            }
+            // Analytic eigenvalues need not divide by differences of singular values
+            Matrix<3, 3> const F  = Matrix<3, 3>::Identity();
+            Matrix<9, 9> const H  = physics::ProjectedHessian(Psi, F, mu, lambda);
+            bool const bIsFinite = H.allFinite();
+            CHECK(bIsFinite);
+        });
+    // Energies without closed-form eigensystems fall back to numerical projection
+    physics::StableNeoHookeanEnergy<2> Psi{};
+    Matrix<2, 2> const F = Matrix<2, 2>{{0.5, 0.1}, {0.2, -0.3}};
+    Matrix<4, 4> const H = physics::ProjectedHessian(Psi, F, mu, lambda);
+    Eigen::SelfAdjointEigenSolver<Matrix<4, 4>> eigs(H);
+    CHECK_GE(eigs.eigenvalues().minCoeff(), -zero * H.norm());
+}
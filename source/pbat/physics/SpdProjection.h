@@ -0,0 +1,211 @@
+#ifndef PBAT_PHYSICS_SPD_PROJECTION_H
+#define PBAT_PHYSICS_SPD_PROJECTION_H
+
+#include "HyperElasticity.h"
+#include "SaintVenantKirchhoffEnergy.h"
+#include "StableNeoHookeanEnergy.h"
+#include "pbat/Aliases.h"
+#include "pbat/math/linalg/mini/Eigen.h"
+
+#include <Eigen/Eigenvalues>
+#include <Eigen/SVD>
+#include <cmath>
+#include <concepts>
+
+namespace pbat {
+namespace physics {
+
+/**
+ * @brief Closed-form eigensystem of an isotropic hyper elastic energy's hessian w.r.t. the
+ * deformation gradient F.
+ *
+ * Let F = U \Sigma V^T be the rotation variant SVD of F, i.e. U,V are rotations and \sigma_3 may
+ * be negative. The 9 eigenmatrices of \partial^2 \Psi / \partial F^2 are then
+ * - 3 scaling modes U diag(q_k) V^T, where q_k are the eigenvectors of the 3x3 hessian of \Psi
+ * w.r.t. singular values \sigma,
+ * - 3 twist modes U (e_i e_j^T - e_j e_i^T) V^T / \sqrt{2},
+ * - 3 flip modes U (e_i e_j^T + e_j e_i^T) V^T / \sqrt{2},
+ * for pairs (i,j) in {(1,2),(0,2),(0,1)}, i.e. the k^{th} pair excludes index k. Specializations
+ * provide the singular value hessian, and twist and flip eigenvalues, without dividing by
+ * \sigma_i - \sigma_j.
+ *
+ * @tparam THyperElasticEnergy Hyper elastic energy
+ */
+template <class THyperElasticEnergy>
+struct AnalyticEigenSystem;
+
+template <class THyperElasticEnergy>
+concept CHasAnalyticEigenSystem = requires(Vector<3> const& sigma)
+{
+    {
+        AnalyticEigenSystem<THyperElasticEnergy>::SingularValueHessian(sigma, Scalar{}, Scalar{})
+    } -> std::convertible_to<Matrix<3, 3>>;
+    {
+        AnalyticEigenSystem<THyperElasticEnergy>::TwistEigenvalues(sigma, Scalar{}, Scalar{})
+    } -> std::convertible_to<Vector<3>>;
+    {
+        AnalyticEigenSystem<THyperElasticEnergy>::FlipEigenvalues(sigma, Scalar{}, Scalar{})
+    } -> std::convertible_to<Vector<3>>;
+};
+
+/**
+ * @brief \Psi = \mu/2 (|F|^2 - 3) + \lambda/2 (J - \alpha)^2, \alpha = 1 + \mu / \lambda
+ */
+template <>
+struct AnalyticEigenSystem<StableNeoHookeanEnergy<3>>
+{
+    static Matrix<3, 3> SingularValueHessian(Vector<3> const& sigma, Scalar mu, Scalar lambda)
+    {
+        Scalar const J     = sigma.prod();
+        Scalar const alpha = Scalar(1) + mu / lambda;
+        Matrix<3, 3> H;
+        for (auto i = 0; i < 3; ++i)
+        {
+            auto const j = (i + 1) % 3;
+            auto const k = (i + 2) % 3;
+            H(i, i)      = mu + lambda * sigma(j) * sigma(j) * sigma(k) * sigma(k);
+            H(i, j)      = lambda * (J * sigma(k) + (J - alpha) * sigma(k));
+            H(j, i)      = H(i, j);
+        }
+        return H;
+    }
+    static Vector<3> TwistEigenvalues(Vector<3> const& sigma, Scalar mu, Scalar lambda)
+    {
+        Scalar const J     = sigma.prod();
+        Scalar const alpha = Scalar(1) + mu / lambda;
+        return (mu + lambda * (J - alpha) * sigma.array()).matrix();
+    }
+    static Vector<3> FlipEigenvalues(Vector<3> const& sigma, Scalar mu, Scalar lambda)
+    {
+        Scalar const J     = sigma.prod();
+        Scalar const alpha = Scalar(1) + mu / lambda;
+        return (mu - lambda * (J - alpha) * sigma.array()).matrix();
+    }
+};
+
+/**
+ * @brief \Psi = \mu |E|^2 + \lambda/2 tr(E)^2, E = (F^T F - I)/2
+ */
+template <>
+struct AnalyticEigenSystem<SaintVenantKirchhoffEnergy<3>>
+{
+    static Matrix<3, 3> SingularValueHessian(Vector<3> const& sigma, Scalar mu, Scalar lambda)
+    {
+        Scalar const trE = Scalar(0.5) * (sigma.squaredNorm() - Scalar(3));
+        Matrix<3, 3> H   = lambda * sigma * sigma.transpose();
+        H.diagonal().array() +=
+            mu * (Scalar(3) * sigma.array().square() - Scalar(1)) + lambda * trE;
+        return H;
+    }
+    static Vector<3> TwistEigenvalues(Vector<3> const& sigma, Scalar mu, Scalar lambda)
+    {
+        return PairEigenvalues(sigma, mu, lambda, Scalar(-1));
+    }
+    static Vector<3> FlipEigenvalues(Vector<3> const& sigma, Scalar mu, Scalar lambda)
+    {
+        return PairEigenvalues(sigma, mu, lambda, Scalar(1));
+    }
+
+  private:
+    static Vector<3> PairEigenvalues(Vector<3> const& sigma, Scalar mu, Scalar lambda, Scalar sign)
+    {
+        Scalar const trE = Scalar(0.5) * (sigma.squaredNorm() - Scalar(3));
+        Vector<3> l;
+        for (auto k = 0; k < 3; ++k)
+        {
+            Scalar const si = sigma((k + 1) % 3);
+            Scalar const sj = sigma((k + 2) % 3);
+            l(k)            = mu * (si * si + sign * si * sj + sj * sj - Scalar(1)) + lambda * trE;
+        }
+        return l;
+    }
+};
+
+/**
+ * @brief Computes the hessian of Psi w.r.t. F, projected to the positive semi-definite cone by
+ * clamping its negative eigenvalues to 0.
+ *
+ * Uses the closed-form eigensystem of Psi if available (see AnalyticEigenSystem), and otherwise
+ * falls back to a numerical eigen decomposition of the |kDims^2|x|kDims^2| hessian.
+ *
+ * @tparam THyperElasticEnergy Hyper elastic energy
+ * @param Psi Hyper elastic energy
+ * @param F Deformation gradient
+ * @param mu 1st Lame coefficient
+ * @param lambda 2nd Lame coefficient
+ * @return |kDims^2|x|kDims^2| projected hessian w.r.t. F (column-major vectorized)
+ */
+template <CHyperElasticEnergy THyperElasticEnergy>
+Matrix<
+    THyperElasticEnergy::kDims * THyperElasticEnergy::kDims,
+    THyperElasticEnergy::kDims * THyperElasticEnergy::kDims>
+ProjectedHessian(
+    THyperElasticEnergy const& Psi,
+    Matrix<THyperElasticEnergy::kDims, THyperElasticEnergy::kDims> const& F,
+    Scalar mu,
+    Scalar lambda)
+{
+    auto constexpr kDims = THyperElasticEnergy::kDims;
+    using HessianType    = Matrix<kDims * kDims, kDims * kDims>;
+    if constexpr (kDims == 3 and CHasAnalyticEigenSystem<THyperElasticEnergy>)
+    {
+        using EigenSystemType = AnalyticEigenSystem<THyperElasticEnergy>;
+        Eigen::JacobiSVD<Matrix<3, 3>> SVD{};
+        SVD.compute(F, Eigen::ComputeFullU | Eigen::ComputeFullV);
+        Matrix<3, 3> U  = SVD.matrixU();
+        Matrix<3, 3> V  = SVD.matrixV();
+        Vector<3> sigma = SVD.singularValues();
+        // Rotation variant SVD, i.e. reflections are moved into the smallest singular value
+        if (U.determinant() < Scalar(0))
+        {
+            U.col(2) *= Scalar(-1);
+            sigma(2) *= Scalar(-1);
+        }
+        if (V.determinant() < Scalar(0))
+        {
+            V.col(2) *= Scalar(-1);
+            sigma(2) *= Scalar(-1);
+        }
+        HessianType H       = HessianType::Zero();
+        auto const fAddMode = [&](Scalar l, Matrix<3, 3> const& Q) {
+            if (l > Scalar(0))
+                H += l * Q.reshaped() * Q.reshaped().transpose();
+        };
+        // Scaling modes
+        Eigen::SelfAdjointEigenSolver<Matrix<3, 3>> eigs{};
+        eigs.computeDirect(EigenSystemType::SingularValueHessian(sigma, mu, lambda));
+        for (auto k = 0; k < 3; ++k)
+        {
+            Matrix<3, 3> const Q = U * eigs.eigenvectors().col(k).asDiagonal() * V.transpose();
+            fAddMode(eigs.eigenvalues()(k), Q);
+        }
+        // Twist and flip modes
+        Vector<3> const lt    = EigenSystemType::TwistEigenvalues(sigma, mu, lambda);
+        Vector<3> const lf    = EigenSystemType::FlipEigenvalues(sigma, mu, lambda);
+        Scalar const invSqrt2 = Scalar(1) / std::sqrt(Scalar(2));
+        for (auto k = 0; k < 3; ++k)
+        {
+            auto const i           = (k + 1) % 3;
+            auto const j           = (k + 2) % 3;
+            Matrix<3, 3> const Eij = U.col(i) * V.col(j).transpose();
+            Matrix<3, 3> const Eji = U.col(j) * V.col(i).transpose();
+            fAddMode(lt(k), invSqrt2 * (Eij - Eji));
+            fAddMode(lf(k), invSqrt2 * (Eij + Eji));
+        }
+        return H;
+    }
+    else
+    {
+        namespace mini = math::linalg::mini;
+        auto vecF      = mini::FromEigen(F);
+        auto hessPsiF  = Psi.hessian(vecF, mu, lambda);
+        Eigen::SelfAdjointEigenSolver<HessianType> eigs(mini::ToEigen(hessPsiF));
+        Vector<kDims * kDims> const l = eigs.eigenvalues().cwiseMax(Scalar(0));
+        return eigs.eigenvectors() * l.asDiagonal() * eigs.eigenvectors().transpose();
+    }
+}
+
+} // namespace physics
+} // namespace pbat
+
+#endif // PBAT_PHYSICS_SPD_PROJECTION_H
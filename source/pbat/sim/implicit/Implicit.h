@@ -0,0 +1,6 @@
+#ifndef PBAT_SIM_IMPLICIT_IMPLICIT_H
+#define PBAT_SIM_IMPLICIT_IMPLICIT_H
+
+#include "Integrator.h"
+
+#endif // PBAT_SIM_IMPLICIT_IMPLICIT_H
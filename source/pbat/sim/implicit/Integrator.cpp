@@ -0,0 +1,110 @@
+#include "Integrator.h"
+
+#include <doctest/doctest.h>
+#include <pbat/fem/Mesh.h>
+#include <pbat/fem/Tetrahedron.h>
+#include <pbat/physics/StableNeoHookeanEnergy.h>
+
+TEST_CASE("[sim][implicit] Integrator")
+{
+    using namespace pbat;
+    // Arrange
+    // Cube mesh
+    MatrixX P(3, 8);
+    IndexMatrixX T(4, 5);
+    // clang-format off
+    P << 0., 1., 0., 1., 0., 1., 0., 1.,
+         0., 0., 1., 1., 0., 0., 1., 1.,
+         0., 0., 0., 0., 1., 1., 1., 1.;
+    T << 0, 3, 5, 6, 0,
+         1, 2, 4, 7, 5,
+         3, 0, 6, 5, 3,
+         5, 6, 0, 3, 6;
+    // clang-format on
+    auto constexpr kDims = 3;
+    using Mesh           = fem::Mesh<fem::Tetrahedron<1>, kDims>;
+    using Energy         = physics::StableNeoHookeanEnergy<kDims>;
+    using Integrator     = sim::implicit::Integrator<Mesh, Energy, 1>;
+    Mesh const mesh(P, T);
+    auto constexpr Y          = Scalar{1e6};
+    auto constexpr nu         = Scalar{0.45};
+    auto constexpr rho        = Scalar{1e3};
+    auto constexpr dt         = Scalar{1e-2};
+    auto constexpr iterations = 10;
+    auto constexpr zero       = Scalar{1e-10};
+    Vector<kDims> const g{0., 0., -9.81};
+
+    SUBCASE("Free fall")
+    {
+        // Act
+        Integrator implicit(mesh, Y, nu, rho);
+        implicit.aext.colwise() = g;
+        implicit.Step(dt, iterations);
+
+        // Assert
+        // Rigid translations have no elastic energy, so the cube falls exactly by dt^2 g, and
+        // Newton's method converges in a single iteration
+        MatrixX const dx       = implicit.x - P;
+        Scalar const fallError = (dx.colwise() - dt * dt * g).norm();
+        CHECK_LE(fallError, zero);
+        CHECK_EQ(implicit.stats.iterations, 1);
+        CHECK_LE(implicit.stats.residuals.back(), implicit.gradientTolerance);
+        Scalar const velocityError = (implicit.v.colwise() - dt * g).norm();
+        CHECK_LE(velocityError, zero);
+    }
+    SUBCASE("Hanging cube")
+    {
+        // Arrange
+        // Fix the cube's left face
+        IndexVectorX dbc(4);
+        dbc << 0, 2, 4, 6;
+        Integrator implicit(mesh, Y, nu, rho, dbc);
+        implicit.aext.colwise() = g;
+
+        // Act
+        auto constexpr kSteps = 10;
+        for (auto s = 0; s < kSteps; ++s)
+        {
+            implicit.Step(dt, iterations);
+            // Assert
+            CHECK_LT(implicit.stats.iterations, iterations);
+            CHECK_LE(implicit.stats.residuals.back(), implicit.gradientTolerance);
+            for (auto alpha : implicit.stats.stepSizes)
+                CHECK_GT(alpha, 0.);
+        }
+
+        // Assert
+        IndexVectorX freeNodes(4);
+        freeNodes << 1, 3, 5, 7;
+        MatrixX const dx            = implicit.x - P;
+        Scalar const dbcError       = dx(Eigen::all, dbc).norm();
+        bool const bFreeVerticesSag = (dx(2, freeNodes).array() < Scalar{0}).all();
+        CHECK_LE(dbcError, zero);
+        CHECK(bFreeVerticesSag);
+    }
+    SUBCASE("Failed line search takes no step")
+    {
+        // Arrange
+        // Newton steps on the (quadratic) free fall potential decrease it by at most half the
+        // directional derivative, so an Armijo slope > 1 rejects every step size.
+        Integrator implicit(mesh, Y, nu, rho);
+        implicit.aext.colwise() = g;
+        implicit.armijoSlope    = Scalar{2};
+
+        // Act
+        implicit.Step(dt, iterations);
+
+        // Assert
+        CHECK_EQ(implicit.stats.iterations, 1);
+        REQUIRE_EQ(implicit.stats.stepSizes.size(), 1ULL);
+        CHECK_EQ(implicit.stats.stepSizes.front(), Scalar{0});
+        CHECK_LE((implicit.x - P).norm(), zero);
+        CHECK_LE(implicit.v.norm(), zero);
+    }
+    SUBCASE("Invalid Dirichlet nodes")
+    {
+        IndexVectorX dbc(1);
+        dbc << P.cols();
+        CHECK_THROWS_AS(Integrator(mesh, Y, nu, rho, dbc), std::invalid_argument);
+    }
+}
@@ -0,0 +1,305 @@
+#ifndef PBAT_SIM_IMPLICIT_INTEGRATOR_H
+#define PBAT_SIM_IMPLICIT_INTEGRATOR_H
+
+#include <exception>
+#include <fmt/core.h>
+#include <pbat/Aliases.h>
+#include <pbat/fem/Concepts.h>
+#include <pbat/fem/HyperElasticPotential.h>
+#include <pbat/fem/Jacobian.h>
+#include <pbat/fem/LumpedMassMatrix.h>
+#include <pbat/fem/ShapeFunctions.h>
+#include <pbat/math/linalg/Cholmod.h>
+#include <pbat/physics/HyperElasticity.h>
+#include <pbat/profiling/Profiling.h>
+#include <string>
+#include <tbb/parallel_for.h>
+#include <vector>
+
+#ifndef PBAT_USE_SUITESPARSE
+    #include <Eigen/SparseCholesky>
+#endif // PBAT_USE_SUITESPARSE
+
+namespace pbat {
+namespace sim {
+namespace implicit {
+
+/**
+ * @brief Convergence telemetry of the last call to Integrator::Step
+ */
+struct Stats
+{
+    Index iterations{0};           ///< Number of Newton iterations run
+    std::vector<Scalar> residuals; ///< residuals[k] is the norm of the incremental potential's
+                                   ///< (free) gradient at the k^{th} Newton iteration
+    std::vector<Scalar> stepSizes; ///< stepSizes[k] is the line search step size of the k^{th}
+                                   ///< Newton iteration, or 0 if no step size satisfied the
+                                   ///< sufficient decrease condition
+};
+
+/**
+ * @brief Implicit (backward) Euler integrator of hyper elastic meshes with lumped masses and
+ * Dirichlet constrained nodes.
+ *
+ * Each time step minimizes the incremental potential
+ * E(x) = 1/2 |x - xtilde|_M^2 + dt^2 U(x), xtilde = xt + dt*v + dt^2*aext,
+ * by Newton's method with SPD projected hessians and backtracking line search. The hessian's
+ * sparsity pattern and the symbolic analysis of its factorization are computed once, and reused
+ * across Newton iterations and time steps. Dirichlet constraints are imposed by replacing the
+ * rows and columns of constrained dofs by identity rows and columns, which preserves the sparsity
+ * pattern.
+ *
+ * The integrator owns its mesh, and the elastic potential refers to it, so integrators are neither
+ * copyable nor movable.
+ *
+ * @tparam TMesh
+ * @tparam THyperElasticEnergy
+ * @tparam QuadratureOrder Quadrature order of the elastic potential
+ */
+template <fem::CMesh TMesh, physics::CHyperElasticEnergy THyperElasticEnergy, int QuadratureOrder>
+class Integrator
+{
+  public:
+    using MeshType = TMesh;
+    using ElasticPotentialType =
+        fem::HyperElasticPotential<TMesh, THyperElasticEnergy, QuadratureOrder>;
+    static auto constexpr kDims               = MeshType::kDims;
+    static int constexpr kMassQuadratureOrder = 2 * MeshType::ElementType::kOrder;
+
+    /**
+     * @brief
+     * @param mesh The finite element mesh, whose nodes are the rest positions
+     * @param Y Young's modulus
+     * @param nu Poisson's ratio
+     * @param rho Mass density
+     * @param dbc Dirichlet constrained nodes, which remain at their positions x
+     */
+    Integrator(
+        MeshType const& mesh,
+        Scalar Y,
+        Scalar nu,
+        Scalar rho,
+        Eigen::Ref<IndexVectorX const> const& dbc = IndexVectorX{});
+
+    Integrator(Integrator const&)            = delete;
+    Integrator& operator=(Integrator const&) = delete;
+
+    /**
+     * @brief Integrates the simulation 1 time step.
+     *
+     * Newton iterations stop early once the norm of the incremental potential's gradient w.r.t.
+     * free dofs falls below gradientTolerance. If the line search finds no step size satisfying
+     * the sufficient decrease condition, no step is taken and Newton iterations stop.
+     *
+     * @param dt Time step
+     * @param iterations Maximum number of Newton iterations
+     */
+    void Step(Scalar dt, Index iterations = Index{10});
+
+    /**
+     * @brief
+     * @param xk |kDims * #nodes| candidate positions
+     * @param xtilde |kDims * #nodes| inertial target positions
+     * @param dt Time step
+     * @return Incremental potential at xk, i.e. assuming U's element potentials were computed at xk
+     */
+    Scalar IncrementalPotential(VectorX const& xk, VectorX const& xtilde, Scalar dt) const;
+
+    MeshType mesh;          ///< The finite element mesh
+    MatrixX detJeU;         ///< Jacobian determinants at the elastic quadrature points
+    MatrixX GNeU;           ///< Shape function gradients at the elastic quadrature points
+    ElasticPotentialType U; ///< Hyper elastic potential
+    VectorX m;              ///< |kDims * #nodes| lumped dof masses
+    MatrixX x;              ///< |kDims| x |#nodes| positions
+    MatrixX v;              ///< |kDims| x |#nodes| velocities
+    MatrixX aext;           ///< |kDims| x |#nodes| external accelerations
+    IndexVectorX dbc;       ///< Dirichlet constrained nodes
+
+    Scalar gradientTolerance{1e-6}; ///< Newton convergence tolerance on the gradient norm
+    Index lineSearchIterations{20}; ///< Maximum number of line search backtracking steps
+    Scalar armijoSlope{1e-4};       ///< Sufficient decrease parameter of the line search
+    Scalar backtrackFactor{0.5};    ///< Step size reduction factor of the line search
+    Stats stats;                    ///< Convergence telemetry of the last Step
+
+  private:
+    /**
+     * @brief Assembles A = M + dt^2 H in place, with identity rows and columns at Dirichlet dofs
+     */
+    void AssembleHessian(Scalar dt2);
+    /**
+     * @brief Factorizes A, computing the symbolic analysis on first use only
+     */
+    void Factorize();
+
+    CSCMatrix A;                  ///< Incremental potential hessian
+    std::vector<char> bDirichlet; ///< |kDims * #nodes| mask of Dirichlet constrained dofs
+    bool bAnalyzed{false};        ///< True if A's symbolic factorization has been computed
+#ifdef PBAT_USE_SUITESPARSE
+    math::linalg::Cholmod mSolver; ///< Sparse Cholesky factorization of A
+#else
+    Eigen::SimplicialLDLT<CSCMatrix> mSolver; ///< Sparse LDLT factorization of A
+#endif // PBAT_USE_SUITESPARSE
+};
+
+template <fem::CMesh TMesh, physics::CHyperElasticEnergy THyperElasticEnergy, int QuadratureOrder>
+inline Integrator<TMesh, THyperElasticEnergy, QuadratureOrder>::Integrator(
+    MeshType const& meshIn,
+    Scalar Y,
+    Scalar nu,
+    Scalar rho,
+    Eigen::Ref<IndexVectorX const> const& dbcIn)
+    : mesh(meshIn),
+      detJeU(fem::DeterminantOfJacobian<QuadratureOrder>(mesh)),
+      GNeU(fem::ShapeFunctionGradients<QuadratureOrder>(mesh)),
+      U(mesh, detJeU, GNeU, Y, nu),
+      m(),
+      x(mesh.X),
+      v(MatrixX::Zero(kDims, mesh.X.cols())),
+      aext(MatrixX::Zero(kDims, mesh.X.cols())),
+      dbc(dbcIn),
+      stats(),
+      A(),
+      bDirichlet(static_cast<std::size_t>(kDims * mesh.X.cols()), char{0}),
+      mSolver()
+{
+    PBAT_PROFILE_NAMED_SCOPE("pbat.sim.implicit.Integrator.Construct");
+    auto const nNodes = mesh.X.cols();
+    for (auto i = 0; i < dbc.size(); ++i)
+    {
+        if (dbc(i) < 0 or dbc(i) >= nNodes)
+        {
+            std::string const what = fmt::format(
+                "Expected Dirichlet constrained nodes in [0,{}), but got dbc({})={}",
+                nNodes,
+                i,
+                dbc(i));
+            throw std::invalid_argument(what);
+        }
+        for (auto d = 0; d < kDims; ++d)
+            bDirichlet[static_cast<std::size_t>(kDims * dbc(i) + d)] = char{1};
+    }
+    MatrixX const detJeM = fem::DeterminantOfJacobian<kMassQuadratureOrder>(mesh);
+    fem::LumpedMassMatrix<MeshType, kMassQuadratureOrder> const M(mesh, detJeM, rho, kDims);
+    m = M.m.transpose().replicate(kDims, 1).reshaped();
+    U.PrecomputeHessianSparsity();
+}
+
+template <fem::CMesh TMesh, physics::CHyperElasticEnergy THyperElasticEnergy, int QuadratureOrder>
+inline void
+Integrator<TMesh, THyperElasticEnergy, QuadratureOrder>::Step(Scalar dt, Index iterations)
+{
+    PBAT_PROFILE_NAMED_SCOPE("pbat.sim.implicit.Integrator.Step");
+    Scalar const dt2     = dt * dt;
+    VectorX const xt     = x.reshaped();
+    VectorX const xtilde = xt + dt * v.reshaped() + dt2 * aext.reshaped();
+    VectorX xk           = xt;
+    VectorX g(xk.size());
+    VectorX dx(xk.size());
+    VectorX xa(xk.size());
+    stats.iterations = 0;
+    stats.residuals.clear();
+    stats.stepSizes.clear();
+    auto const n = static_cast<Index>(xk.size());
+    for (Index k = 0; k < iterations; ++k)
+    {
+        U.ComputeElementElasticity(xk, true, true);
+        g = m.cwiseProduct(xk - xtilde) + dt2 * U.ToVector();
+        tbb::parallel_for(Index{0}, n, [&](Index i) {
+            if (bDirichlet[static_cast<std::size_t>(i)])
+                g(i) = Scalar(0);
+        });
+        Scalar const residual = g.norm();
+        stats.residuals.push_back(residual);
+        if (residual <= gradientTolerance)
+            break;
+        AssembleHessian(dt2);
+        Factorize();
+#ifdef PBAT_USE_SUITESPARSE
+        dx = -mSolver.Solve(g).col(0);
+#else
+        dx = -mSolver.solve(g);
+#endif // PBAT_USE_SUITESPARSE
+        // Backtracking line search on the incremental potential
+        Scalar const E0    = IncrementalPotential(xk, xtilde, dt);
+        Scalar const slope = g.dot(dx);
+        Scalar alpha{1};
+        bool bIsSufficientDecrease{false};
+        for (Index j = 0; j < lineSearchIterations and not bIsSufficientDecrease; ++j)
+        {
+            xa = xk + alpha * dx;
+            U.ComputeElementElasticity(xa, false, false);
+            bIsSufficientDecrease =
+                IncrementalPotential(xa, xtilde, dt) <= E0 + armijoSlope * alpha * slope;
+            if (not bIsSufficientDecrease)
+                alpha *= backtrackFactor;
+        }
+        ++stats.iterations;
+        if (not bIsSufficientDecrease)
+        {
+            stats.stepSizes.push_back(Scalar(0));
+            break;
+        }
+        xk += alpha * dx;
+        stats.stepSizes.push_back(alpha);
+    }
+    v = (xk - xt).reshaped(kDims, x.cols()) / dt;
+    x = xk.reshaped(kDims, x.cols());
+}
+
+template <fem::CMesh TMesh, physics::CHyperElasticEnergy THyperElasticEnergy, int QuadratureOrder>
+inline Scalar Integrator<TMesh, THyperElasticEnergy, QuadratureOrder>::IncrementalPotential(
+    VectorX const& xk,
+    VectorX const& xtilde,
+    Scalar dt) const
+{
+    VectorX const dx = xk - xtilde;
+    return Scalar(0.5) * dx.dot(m.cwiseProduct(dx)) + dt * dt * U.Eval();
+}
+
+template <fem::CMesh TMesh, physics::CHyperElasticEnergy THyperElasticEnergy, int QuadratureOrder>
+inline void Integrator<TMesh, THyperElasticEnergy, QuadratureOrder>::AssembleHessian(Scalar dt2)
+{
+    PBAT_PROFILE_NAMED_SCOPE("pbat.sim.implicit.Integrator.AssembleHessian");
+    // Overwrites A's values only, after the first assembly
+    U.ToMatrix(A);
+    tbb::parallel_for(Index{0}, Index{A.outerSize()}, [&](Index j) {
+        bool const bIsColDirichlet = bDirichlet[static_cast<std::size_t>(j)];
+        for (CSCMatrix::InnerIterator it(A, j); it; ++it)
+        {
+            auto const i               = static_cast<Index>(it.row());
+            bool const bIsRowDirichlet = bDirichlet[static_cast<std::size_t>(i)];
+            if (bIsRowDirichlet or bIsColDirichlet)
+                it.valueRef() = (i == j) ? Scalar(1) : Scalar(0);
+            else
+                it.valueRef() = dt2 * it.value() + ((i == j) ? m(i) : Scalar(0));
+        }
+    });
+}
+
+template <fem::CMesh TMesh, physics::CHyperElasticEnergy THyperElasticEnergy, int QuadratureOrder>
+inline void Integrator<TMesh, THyperElasticEnergy, QuadratureOrder>::Factorize()
+{
+    PBAT_PROFILE_NAMED_SCOPE("pbat.sim.implicit.Integrator.Factorize");
+#ifdef PBAT_USE_SUITESPARSE
+    if (not bAnalyzed)
+        mSolver.Analyze(A);
+    bool const bFactorized = mSolver.Factorize(A);
+#else
+    if (not bAnalyzed)
+        mSolver.analyzePattern(A);
+    mSolver.factorize(A);
+    bool const bFactorized = mSolver.info() == Eigen::ComputationInfo::Success;
+#endif // PBAT_USE_SUITESPARSE
+    bAnalyzed = true;
+    if (not bFactorized)
+    {
+        std::string const what = "Failed to factorize the incremental potential's hessian";
+        throw std::runtime_error(what);
+    }
+}
+
+} // namespace implicit
+} // namespace sim
+} // namespace pbat
+
+#endif // PBAT_SIM_IMPLICIT_INTEGRATOR_H
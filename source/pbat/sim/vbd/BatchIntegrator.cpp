@@ -0,0 +1,438 @@
+#include "BatchIntegrator.h"
+
+#include "pbat/profiling/Profiling.h"
+
+#include <algorithm>
+#include <exception>
+#include <fmt/format.h>
+#include <string>
+#include <utility>
+
+namespace pbat {
+namespace sim {
+namespace vbd {
+
+namespace {
+
+IndexVectorX VertexPrefix(std::vector<Data> const& scenes)
+{
+    IndexVectorX prefix(static_cast<Index>(scenes.size()) + 1);
+    prefix(0) = 0;
+    for (auto s = 0ULL; s < scenes.size(); ++s)
+        prefix(static_cast<Index>(s) + 1) = prefix(static_cast<Index>(s)) + scenes[s].x.cols();
+    return prefix;
+}
+
+/**
+ * @brief Computes the disjoint union of scenes
+ * @param scenes Constructed scenes
+ * @return Unconstructed packed data
+ */
+Data Pack(std::vector<Data> const& scenes)
+{
+    PBAT_PROFILE_NAMED_SCOPE("pbat.sim.vbd.BatchIntegrator.Pack");
+    if (scenes.empty())
+    {
+        throw std::invalid_argument("Expected at least 1 scene in VBD batch");
+    }
+    Data const& first = scenes.front();
+    // Count packed quantities
+    Index nVertices{0}, nElements{0}, nQuadPts{0}, nAdjacency{0}, nCollisionVertices{0},
+        nCollisionTriangles{0}, nDbc{0};
+    std::size_t nColors{0};
+    for (auto s = 0ULL; s < scenes.size(); ++s)
+    {
+        Data const& scene = scenes[s];
+        bool const bHasSameElasticity = scene.eElement == first.eElement and
+                                        scene.order == first.order and
+                                        scene.eEnergy == first.eEnergy and
+                                        scene.T.rows() == first.T.rows();
+        if (not bHasSameElasticity)
+        {
+            std::string const what = fmt::format(
+                "Scene {} of VBD batch does not have the same element type, order and hyper "
+                "elastic energy as scene 0",
+                s);
+            throw std::invalid_argument(what);
+        }
+        // Solver parameters apply to the whole batch, so they must not differ across scenes
+        bool const bHasSameParameters =
+            scene.strategy == first.strategy and scene.kD == first.kD and scene.kC == first.kC and
+            scene.detHZero == first.detHZero and
+            scene.bCacheElementDerivatives == first.bCacheElementDerivatives and
+            scene.cacheTolerance == first.cacheTolerance and
+            scene.residualTolerance == first.residualTolerance and
+            scene.displacementTolerance == first.displacementTolerance and
+            scene.bUseActiveSet == first.bUseActiveSet and
+            scene.activeResidualThreshold == first.activeResidualThreshold and
+            scene.activeDisplacementThreshold == first.activeDisplacementThreshold and
+            scene.bEstimateSpectralRadius == first.bEstimateSpectralRadius and
+            scene.chebyshevWarmupIterations == first.chebyshevWarmupIterations and
+            scene.rhoMax == first.rhoMax and
+            scene.rhoDivergenceFactor == first.rhoDivergenceFactor and
+            scene.chebyshevDivergenceIterations == first.chebyshevDivergenceIterations;
+        if (not bHasSameParameters)
+        {
+            std::string const what = fmt::format(
+                "Scene {} of VBD batch does not have the same solver parameters (initialization "
+                "strategy, damping, collision penalty, hessian determinant zero, element "
+                "derivative cache, convergence tolerances, active set and Chebyshev settings) as "
+                "scene 0",
+                s);
+            throw std::invalid_argument(what);
+        }
+        bool const bIsConstructed = scene.xtilde.cols() == scene.x.cols() and
+                                    scene.m.size() == scene.x.cols() and
+                                    not(scene.partitions.empty() and scene.x.cols() > 0);
+        if (not bIsConstructed)
+        {
+            std::string const what =
+                fmt::format("Scene {} of VBD batch must be constructed before packing", s);
+            throw std::invalid_argument(what);
+        }
+        nVertices += scene.x.cols();
+        nElements += scene.T.cols();
+        nQuadPts += scene.wg.size();
+        nAdjacency += scene.GVGg.size();
+        nCollisionVertices += scene.V.size();
+        nCollisionTriangles += scene.F.cols();
+        nDbc += scene.dbc.size();
+        nColors = std::max(nColors, scene.partitions.size());
+    }
+    // Pack scenes
+    Data data{first};
+    data.x.resize(3, nVertices);
+    data.v.resize(3, nVertices);
+    data.aext.resize(3, nVertices);
+    data.m.resize(nVertices);
+    data.xt.resize(3, nVertices);
+    data.vt.resize(3, nVertices);
+    data.G.resize(nVertices);
+    data.T.resize(first.T.rows(), nElements);
+    data.wg.resize(nQuadPts);
+    data.GP.resize(first.GP.rows(), 3 * nQuadPts);
+    data.lame.resize(2, nQuadPts);
+    data.GVGp.resize(nVertices + 1);
+    data.GVGg.resize(nAdjacency);
+    data.GVGe.resize(nAdjacency);
+    data.GVGilocal.resize(nAdjacency);
+    data.V.resize(nCollisionVertices);
+    data.F.resize(3, nCollisionTriangles);
+    data.dbc.resize(nDbc);
+    data.partitions.assign(nColors, {});
+    // Scenes' renumberings are kept as blocks of the packed renumbering, such that each scene's
+    // results can be mapped back to its user ordering. The packed data is not renumbered again.
+    bool const bIsAnySceneReordered = std::any_of(scenes.begin(), scenes.end(), [](Data const& s) {
+        return s.perm.size() > 0 or s.eperm.size() > 0;
+    });
+    auto const nPerm  = bIsAnySceneReordered ? nVertices : Index(0);
+    auto const nEperm = bIsAnySceneReordered ? nElements : Index(0);
+    data.perm.resize(nPerm);
+    data.iperm.resize(nPerm);
+    data.eperm.resize(nEperm);
+    data.eiperm.resize(nEperm);
+    data.bReorderVertices = false;
+    data.GVGp(0)          = 0;
+    auto const PackPermutation = [](IndexVectorX const& sperm, Index n, Index o, auto&& dperm) {
+        if (sperm.size() == n)
+            dperm = sperm.array() + o;
+        else
+            dperm.setLinSpaced(n, o, o + n - 1);
+    };
+    Index vo{0}, eo{0}, go{0}, ao{0}, co{0}, fo{0}, dbco{0}, cgo{0};
+    for (auto s = 0ULL; s < scenes.size(); ++s)
+    {
+        Data const& scene = scenes[s];
+        auto const nv     = scene.x.cols();
+        auto const ne     = scene.T.cols();
+        auto const ng     = scene.wg.size();
+        auto const na     = scene.GVGg.size();
+        auto const nc     = scene.V.size();
+        auto const nf     = scene.F.cols();
+        auto const nd     = scene.dbc.size();
+        // Per-vertex quantities
+        data.x.middleCols(vo, nv)    = scene.x;
+        data.v.middleCols(vo, nv)    = scene.v;
+        data.aext.middleCols(vo, nv) = scene.aext;
+        data.m.segment(vo, nv)       = scene.m;
+        data.xt.middleCols(vo, nv)   = scene.xt;
+        data.vt.middleCols(vo, nv)   = scene.vt;
+        // Collision groups of different scenes are disjoint, such that scenes never collide,
+        // while bodies of the same scene only collide as the scene's own groups specify.
+        if (scene.G.size() > 0)
+        {
+            auto const gmin         = scene.G.minCoeff();
+            data.G.segment(vo, nv)  = scene.G.array() - gmin + cgo;
+            cgo                    += scene.G.maxCoeff() - gmin + 1;
+        }
+        else
+        {
+            data.G.segment(vo, nv).setConstant(cgo);
+            ++cgo;
+        }
+        // Per-element and per-quad.pt. quantities
+        data.T.middleCols(eo, ne)          = scene.T.array() + vo;
+        data.wg.segment(go, ng)            = scene.wg;
+        data.GP.middleCols(3 * go, 3 * ng) = scene.GP;
+        data.lame.middleCols(go, ng)       = scene.lame;
+        // Vertex-quad.pt. adjacency
+        data.GVGp.segment(vo + 1, nv)  = scene.GVGp.tail(nv).array() + ao;
+        data.GVGg.segment(ao, na)      = scene.GVGg.array() + go;
+        data.GVGe.segment(ao, na)      = scene.GVGe.array() + eo;
+        data.GVGilocal.segment(ao, na) = scene.GVGilocal;
+        // Collision mesh and boundary conditions
+        data.V.segment(co, nc)     = scene.V.array() + vo;
+        data.F.middleCols(fo, nf)  = scene.F.array() + vo;
+        data.dbc.segment(dbco, nd) = scene.dbc.array() + vo;
+        // Renumberings, i.e. identity for scenes which were not renumbered
+        if (bIsAnySceneReordered)
+        {
+            PackPermutation(scene.perm, nv, vo, data.perm.segment(vo, nv));
+            PackPermutation(scene.iperm, nv, vo, data.iperm.segment(vo, nv));
+            PackPermutation(scene.eperm, ne, eo, data.eperm.segment(eo, ne));
+            PackPermutation(scene.eiperm, ne, eo, data.eiperm.segment(eo, ne));
+        }
+        for (auto c = 0ULL; c < scene.partitions.size(); ++c)
+            for (Index i : scene.partitions[c])
+                data.partitions[c].push_back(i + vo);
+        vo += nv;
+        eo += ne;
+        go += ng;
+        ao += na;
+        co += nc;
+        fo += nf;
+        dbco += nd;
+    }
+    return data;
+}
+
+} // namespace
+
+BatchIntegrator::BatchIntegrator(std::vector<Data> const& scenes)
+    : vertexPrefix(VertexPrefix(scenes)), integrator(Pack(scenes).Construct())
+{
+}
+
+void BatchIntegrator::Step(Scalar dt, Index iterations, Index substeps, Scalar rho)
+{
+    PBAT_PROFILE_NAMED_SCOPE("pbat.sim.vbd.BatchIntegrator.Step");
+    integrator.Step(dt, iterations, substeps, rho);
+}
+
+Index BatchIntegrator::NumberOfScenes() const
+{
+    return vertexPrefix.size() - 1;
+}
+
+IndexVectorX BatchIntegrator::Vertices(Index s) const
+{
+    auto const nv = vertexPrefix(s + 1) - vertexPrefix(s);
+    if (integrator.data.perm.size() > 0)
+        return integrator.data.perm.segment(vertexPrefix(s), nv);
+    return IndexVectorX::LinSpaced(nv, vertexPrefix(s), vertexPrefix(s + 1) - 1);
+}
+
+MatrixX BatchIntegrator::Positions(Index s) const
+{
+    return integrator.data.x(Eigen::all, Vertices(s));
+}
+
+MatrixX BatchIntegrator::Velocities(Index s) const
+{
+    return integrator.data.v(Eigen::all, Vertices(s));
+}
+
+void BatchIntegrator::SetPositions(Index s, Eigen::Ref<MatrixX const> const& x)
+{
+    integrator.data.x(Eigen::all, Vertices(s)) = x;
+}
+
+void BatchIntegrator::SetVelocities(Index s, Eigen::Ref<MatrixX const> const& v)
+{
+    integrator.data.v(Eigen::all, Vertices(s)) = v;
+}
+
+} // namespace vbd
+} // namespace sim
+} // namespace pbat
+
+#include "pbat/fem/Mesh.h"
+#include "pbat/fem/ShapeFunctions.h"
+#include "pbat/fem/Tetrahedron.h"
+#include "pbat/physics/HyperElasticity.h"
+
+#include <doctest/doctest.h>
+#include <numeric>
+
+TEST_CASE("[sim][vbd] BatchIntegrator")
+{
+    using namespace pbat;
+    // Arrange
+    // Cube mesh
+    MatrixX P(3, 8);
+    IndexMatrixX T(4, 5);
+    IndexMatrixX F(3, 12);
+    // clang-format off
+    P << 0.f, 1.f, 0.f, 1.f, 0.f, 1.f, 0.f, 1.f,
+         0.f, 0.f, 1.f, 1.f, 0.f, 0.f, 1.f, 1.f,
+         0.f, 0.f, 0.f, 0.f, 1.f, 1.f, 1.f, 1.f;
+    T << 0, 3, 5, 6, 0,
+         1, 2, 4, 7, 5,
+         3, 0, 6, 5, 3,
+         5, 6, 0, 3, 6;
+    F << 0, 1, 1, 3, 3, 2, 2, 0, 0, 0, 4, 5,
+         1, 5, 3, 7, 2, 6, 0, 4, 3, 2, 5, 7,
+         4, 4, 5, 5, 7, 7, 6, 6, 1, 3, 6, 6;
+    // clang-format on
+    auto constexpr dt         = Scalar{1e-2};
+    auto constexpr substeps   = 2;
+    auto constexpr iterations = 10;
+    // Overlapping scenes with different initial velocities, which must neither collide nor
+    // otherwise interact when batched.
+    auto const MakeMeshScene = [](MatrixX const& P,
+                                  IndexMatrixX const& T,
+                                  IndexMatrixX const& F,
+                                  Vector<3> const& v) {
+        using Element = fem::Tetrahedron<1>;
+        using Mesh    = fem::Mesh<Element, 3>;
+        Mesh mesh{P, T};
+        MatrixX const GP        = fem::ShapeFunctionGradients<1>(mesh);
+        VectorX const wg        = fem::InnerProductWeights<1>(mesh).reshaped();
+        auto const [mu, lambda] = physics::LameCoefficients(Scalar{1e6}, Scalar{0.45});
+        MatrixX lame(2, T.cols());
+        lame.row(0).setConstant(mu);
+        lame.row(1).setConstant(lambda);
+        IndexVectorX GVGp = IndexVectorX::Zero(P.cols() + 1);
+        for (auto e = 0; e < T.cols(); ++e)
+            for (auto ilocal = 0; ilocal < T.rows(); ++ilocal)
+                ++GVGp(T(ilocal, e) + 1);
+        std::partial_sum(GVGp.begin(), GVGp.end(), GVGp.begin());
+        IndexVectorX GVGe(T.size());
+        IndexVectorX GVGilocal(T.size());
+        IndexVectorX k = GVGp.head(P.cols());
+        for (auto e = 0; e < T.cols(); ++e)
+        {
+            for (auto ilocal = 0; ilocal < T.rows(); ++ilocal)
+            {
+                auto const i    = T(ilocal, e);
+                GVGe(k(i))      = e;
+                GVGilocal(k(i)) = ilocal;
+                ++k(i);
+            }
+        }
+        MatrixX V(3, P.cols());
+        V.colwise() = v;
+        IndexVectorX CV(P.cols());
+        CV.setLinSpaced(0, static_cast<Index>(P.cols() - 1));
+        return sim::vbd::Data()
+            .WithVolumeMesh(P, T)
+            .WithSurfaceMesh(CV, F)
+            .WithQuadrature(wg, GP, lame)
+            .WithVertexAdjacency(GVGp, GVGe, GVGe, GVGilocal)
+            .WithVelocity(V);
+    };
+    auto const MakeScene = [&](Vector<3> const& v) {
+        return MakeMeshScene(P, T, F, v).Construct();
+    };
+    std::vector<sim::vbd::Data> scenes{};
+    scenes.push_back(MakeScene(Vector<3>{Scalar{0}, Scalar{0}, Scalar{0}}));
+    scenes.push_back(MakeScene(Vector<3>{Scalar{1}, Scalar{0}, Scalar{0}}));
+    scenes.push_back(MakeScene(Vector<3>{Scalar{0}, Scalar{-1}, Scalar{1}}));
+
+    // Act
+    sim::vbd::BatchIntegrator batch{scenes};
+    batch.Step(dt, iterations, substeps);
+    std::vector<sim::vbd::Integrator> integrators{};
+    for (auto const& scene : scenes)
+    {
+        integrators.emplace_back(scene);
+        integrators.back().Step(dt, iterations, substeps);
+    }
+
+    // Assert
+    REQUIRE_EQ(batch.NumberOfScenes(), static_cast<Index>(scenes.size()));
+    CHECK_EQ(batch.integrator.data.x.cols(), static_cast<Index>(scenes.size()) * P.cols());
+    bool const bHasNoContacts = (batch.integrator.data.FC.array() < 0).all();
+    CHECK(bHasNoContacts);
+    for (auto s = 0ULL; s < scenes.size(); ++s)
+    {
+        CHECK(batch.Positions(static_cast<Index>(s)).isApprox(integrators[s].data.x));
+        CHECK(batch.Velocities(static_cast<Index>(s)).isApprox(integrators[s].data.v));
+    }
+
+    SUBCASE("Scenes' collision groups are preserved")
+    {
+        // Arrange
+        // Overlapping cubes of distinct collision groups, which must not collide, neither in
+        // isolation nor when batched with copies of their scene.
+        auto const nCubeVertices = P.cols();
+        MatrixX P2(3, 2 * nCubeVertices);
+        P2.leftCols(nCubeVertices)  = P;
+        P2.rightCols(nCubeVertices) = P.colwise() + Vector<3>{Scalar{0.5}, Scalar{0}, Scalar{0}};
+        IndexMatrixX T2(T.rows(), 2 * T.cols());
+        T2.leftCols(T.cols())  = T;
+        T2.rightCols(T.cols()) = T.array() + nCubeVertices;
+        IndexMatrixX F2(F.rows(), 2 * F.cols());
+        F2.leftCols(F.cols())  = F;
+        F2.rightCols(F.cols()) = F.array() + nCubeVertices;
+        IndexVectorX G(2 * nCubeVertices);
+        G.head(nCubeVertices).setZero();
+        G.tail(nCubeVertices).setOnes();
+        sim::vbd::Data const scene =
+            MakeMeshScene(P2, T2, F2, Vector<3>::Zero())
+                .WithCollisionGroups(G)
+                .WithCollisionPenalty(Scalar{1e4})
+                .Construct();
+
+        // Act
+        sim::vbd::BatchIntegrator groupedBatch{{scene, scene}};
+        groupedBatch.Step(dt, iterations, 1);
+        sim::vbd::Integrator vbd{scene};
+        vbd.Step(dt, iterations, 1);
+
+        // Assert
+        bool const bHasNoGroupedContacts = (groupedBatch.integrator.data.FC.array() < 0).all();
+        CHECK(bHasNoGroupedContacts);
+        for (auto s = 0; s < groupedBatch.NumberOfScenes(); ++s)
+        {
+            CHECK(groupedBatch.Positions(s).isApprox(vbd.data.x));
+            CHECK(groupedBatch.Velocities(s).isApprox(vbd.data.v));
+        }
+    }
+
+    SUBCASE("Scenes with different solver parameters are rejected")
+    {
+        sim::vbd::Data dampedScene = scenes.back();
+        dampedScene.WithRayleighDamping(Scalar{1e-2});
+        CHECK_THROWS_AS(
+            sim::vbd::BatchIntegrator({scenes.front(), dampedScene}),
+            std::invalid_argument);
+    }
+
+    SUBCASE("Scenes' vertex reordering is undone by per-scene accessors")
+    {
+        // Arrange
+        sim::vbd::Data const scene =
+            MakeMeshScene(P, T, F, Vector<3>{Scalar{0}, Scalar{-1}, Scalar{0}})
+                .WithVertexReordering()
+                .Construct();
+        REQUIRE_EQ(scene.perm.size(), P.cols());
+
+        // Act
+        sim::vbd::BatchIntegrator reorderedBatch{{scenes.front(), scene}};
+        bool const bStartsInUserOrdering = reorderedBatch.Positions(1).isApprox(P);
+        reorderedBatch.Step(dt, iterations, substeps);
+        sim::vbd::Integrator vbd{scene};
+        vbd.Step(dt, iterations, substeps);
+        MatrixX const xUser = vbd.data.x(Eigen::all, vbd.data.perm);
+        MatrixX const vUser = vbd.data.v(Eigen::all, vbd.data.perm);
+
+        // Assert
+        CHECK(bStartsInUserOrdering);
+        CHECK(reorderedBatch.Positions(0).isApprox(integrators.front().data.x));
+        CHECK(reorderedBatch.Positions(1).isApprox(xUser));
+        CHECK(reorderedBatch.Velocities(1).isApprox(vUser));
+        reorderedBatch.SetPositions(1, P);
+        CHECK(reorderedBatch.Positions(1).isApprox(P));
+    }
+}
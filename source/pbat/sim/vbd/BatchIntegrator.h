@@ -0,0 +1,83 @@
+#ifndef PBAT_SIM_VBD_BATCH_INTEGRATOR_H
+#define PBAT_SIM_VBD_BATCH_INTEGRATOR_H
+
+#include "Data.h"
+#include "Integrator.h"
+#include "PhysicsBasedAnimationToolkitExport.h"
+#include "pbat/Aliases.h"
+
+#include <vector>
+
+namespace pbat {
+namespace sim {
+namespace vbd {
+
+/**
+ * @brief Steps many independent VBD scenes at once.
+ *
+ * Scenes are packed into a single flat Data, i.e. the disjoint union of their meshes, whose
+ * partition c is the union of all scenes' partitions c. Each BCD sweep over a color is thus 1
+ * parallel pass over all scenes' vertices of that color, which amortizes scheduling overhead
+ * across scenes. Scenes never collide with each other, and each scene's own collision groups are
+ * preserved, i.e. mapped to groups unique to the scene.
+ *
+ * Scenes must use the same element type, hyper elastic energy and solver parameters (i.e.
+ * initialization strategy, damping, collision penalty, tolerances, active set, cache and
+ * Chebyshev settings), which then apply to the whole batch.
+ */
+class BatchIntegrator
+{
+  public:
+    /**
+     * @brief Packs constructed scenes into a batch
+     * @param scenes Scenes on which Data::Construct() has been called
+     */
+    PBAT_API BatchIntegrator(std::vector<Data> const& scenes);
+
+    PBAT_API void
+    Step(Scalar dt, Index iterations, Index substeps = Index{1}, Scalar rho = Scalar{1});
+
+    PBAT_API Index NumberOfScenes() const;
+    /**
+     * @brief Packed vertex indices of scene s's vertices, in the scene's user vertex ordering,
+     * i.e. undoing the scene's renumbering if it was constructed WithVertexReordering
+     * @param s Scene index
+     * @return |#verts in scene s| indices into integrator.data's vertices
+     */
+    PBAT_API IndexVectorX Vertices(Index s) const;
+    /**
+     * @brief Vertex positions of scene s, in the scene's user vertex ordering
+     * @param s Scene index
+     * @return 3x|#verts in scene s| positions
+     */
+    PBAT_API MatrixX Positions(Index s) const;
+    /**
+     * @brief Vertex velocities of scene s, in the scene's user vertex ordering
+     * @param s Scene index
+     * @return 3x|#verts in scene s| velocities
+     */
+    PBAT_API MatrixX Velocities(Index s) const;
+    /**
+     * @brief Sets vertex positions of scene s, in the scene's user vertex ordering
+     * @param s Scene index
+     * @param x 3x|#verts in scene s| positions
+     */
+    PBAT_API void SetPositions(Index s, Eigen::Ref<MatrixX const> const& x);
+    /**
+     * @brief Sets vertex velocities of scene s, in the scene's user vertex ordering
+     * @param s Scene index
+     * @param v 3x|#verts in scene s| velocities
+     */
+    PBAT_API void SetVelocities(Index s, Eigen::Ref<MatrixX const> const& v);
+
+    IndexVectorX vertexPrefix;      ///< |#scenes+1| s.t. vertices of scene s are
+                                    ///< [vertexPrefix[s], vertexPrefix[s+1]) in integrator.data,
+                                    ///< in the scene's internal ordering
+    PBAT_API Integrator integrator; ///< Integrator of the packed scenes
+};
+
+} // namespace vbd
+} // namespace sim
+} // namespace pbat
+
+#endif // PBAT_SIM_VBD_BATCH_INTEGRATOR_H
@@ -1,15 +1,201 @@
 #include "Data.h"
 
+#include "pbat/fem/Tetrahedron.h"
+#include "pbat/geometry/Morton.h"
+#include "pbat/graph/Adjacency.h"
+#include "pbat/graph/Color.h"
 #include "pbat/physics/HyperElasticity.h"
+#include "pbat/profiling/Profiling.h"
 
 #include <algorithm>
 #include <exception>
 #include <fmt/format.h>
+#include <limits>
 #include <string>
+#include <tbb/parallel_for.h>
 
 namespace pbat {
 namespace sim {
 namespace vbd {
+namespace {
+
+/**
+ * @brief Renumbers vertices such that each partition is a contiguous range of vertices sorted by
+ * Morton code, followed by unpartitioned (i.e. constrained) vertices.
+ *
+ * @param data VBD data whose partitions have already been computed
+ */
+void ReorderVertices(Data& data)
+{
+    PBAT_PROFILE_NAMED_SCOPE("pbat.sim.vbd.ReorderVertices");
+    auto const nVertices = static_cast<Index>(data.x.cols());
+    if (nVertices == 0)
+        return;
+    // Compute Morton codes of vertices in the mesh's normalized bounding box
+    Vector<3> const xmin   = data.x.rowwise().minCoeff();
+    Vector<3> const xmax   = data.x.rowwise().maxCoeff();
+    Vector<3> const extent = (xmax - xmin).cwiseMax(std::numeric_limits<Scalar>::min());
+    std::vector<geometry::MortonCodeType> morton(static_cast<std::size_t>(nVertices));
+    tbb::parallel_for(Index(0), nVertices, [&](Index i) {
+        Vector<3> const xi = (data.x.col(i) - xmin).cwiseQuotient(extent);
+        morton[static_cast<std::size_t>(i)] = geometry::Morton3D(
+            {static_cast<float>(xi(0)), static_cast<float>(xi(1)), static_cast<float>(xi(2))});
+    });
+    auto const MortonLess = [&](Index i, Index j) {
+        return morton[static_cast<std::size_t>(i)] < morton[static_cast<std::size_t>(j)];
+    };
+    // Build the internal to user vertex ordering
+    IndexVectorX iperm(nVertices);
+    std::vector<bool> bPartitioned(static_cast<std::size_t>(nVertices), false);
+    Index k{0};
+    for (auto& partition : data.partitions)
+    {
+        std::stable_sort(partition.begin(), partition.end(), MortonLess);
+        for (Index i : partition)
+        {
+            if (bPartitioned[static_cast<std::size_t>(i)])
+            {
+                std::string const what =
+                    fmt::format("Vertex {} belongs to more than 1 partition", i);
+                throw std::invalid_argument(what);
+            }
+            bPartitioned[static_cast<std::size_t>(i)] = true;
+            iperm(k++)                                = i;
+        }
+    }
+    auto const kUnpartitioned = k;
+    for (Index i = 0; i < nVertices; ++i)
+        if (not bPartitioned[static_cast<std::size_t>(i)])
+            iperm(k++) = i;
+    std::stable_sort(iperm.begin() + kUnpartitioned, iperm.end(), MortonLess);
+    IndexVectorX perm(nVertices);
+    perm(iperm) = IndexVectorX::LinSpaced(nVertices, Index(0), nVertices - 1);
+    // Permute per-vertex quantities
+    data.x    = data.x(Eigen::all, iperm).eval();
+    data.xt   = data.xt(Eigen::all, iperm).eval();
+    data.v    = data.v(Eigen::all, iperm).eval();
+    data.aext = data.aext(Eigen::all, iperm).eval();
+    data.m    = data.m(iperm).eval();
+    // Renumber vertex references
+    auto const Renumber = [&](Index i) { return perm(i); };
+    data.T              = data.T.unaryExpr(Renumber).eval();
+    data.F              = data.F.unaryExpr(Renumber).eval();
+    data.V              = data.V.unaryExpr(Renumber).eval();
+    data.dbc            = data.dbc.unaryExpr(Renumber).eval();
+    if (data.G.size() == nVertices)
+        data.G = data.G(iperm).eval();
+    std::sort(data.dbc.begin(), data.dbc.end());
+    for (auto& partition : data.partitions)
+        for (Index& i : partition)
+            i = perm(i);
+    // Permute vertex-quad.pt. adjacency. Element indices, quad.pts. and local vertex indices are
+    // unaffected by the renumbering.
+    IndexVectorX GVGp(nVertices + 1);
+    GVGp(0) = 0;
+    for (Index i = 0; i < nVertices; ++i)
+        GVGp(i + 1) = GVGp(i) + data.GVGp(iperm(i) + 1) - data.GVGp(iperm(i));
+    IndexVectorX GVGg(data.GVGg.size());
+    IndexVectorX GVGe(data.GVGe.size());
+    IndexVectorX GVGilocal(data.GVGilocal.size());
+    tbb::parallel_for(Index(0), nVertices, [&](Index i) {
+        auto const nAdjacent = GVGp(i + 1) - GVGp(i);
+        auto const kbegin    = data.GVGp(iperm(i));
+        GVGg.segment(GVGp(i), nAdjacent)      = data.GVGg.segment(kbegin, nAdjacent);
+        GVGe.segment(GVGp(i), nAdjacent)      = data.GVGe.segment(kbegin, nAdjacent);
+        GVGilocal.segment(GVGp(i), nAdjacent) = data.GVGilocal.segment(kbegin, nAdjacent);
+    });
+    data.GVGp      = std::move(GVGp);
+    data.GVGg      = std::move(GVGg);
+    data.GVGe      = std::move(GVGe);
+    data.GVGilocal = std::move(GVGilocal);
+    // Compose with a previous reordering, if any, so that perm always maps from user ordering
+    if (data.perm.size() == nVertices)
+    {
+        data.iperm            = data.iperm(iperm).eval();
+        data.perm(data.iperm) = IndexVectorX::LinSpaced(nVertices, Index(0), nVertices - 1);
+    }
+    else
+    {
+        data.perm  = std::move(perm);
+        data.iperm = std::move(iperm);
+    }
+}
+
+/**
+ * @brief Renumbers elements by their minimum vertex index, such that elements adjacent to nearby
+ * vertices are nearby in memory, and permutes quad.pt. quantities and the vertex-quad.pt.
+ * adjacency accordingly.
+ *
+ * @param data VBD data whose vertices have already been reordered
+ */
+void ReorderElements(Data& data)
+{
+    PBAT_PROFILE_NAMED_SCOPE("pbat.sim.vbd.ReorderElements");
+    auto const nElements = static_cast<Index>(data.T.cols());
+    auto const nQuadPts  = static_cast<Index>(data.wg.size());
+    auto const nVertices = static_cast<Index>(data.x.cols());
+    if (nElements == 0)
+        return;
+    // Build the internal to user element ordering
+    IndexVectorX const Tmin = data.T.colwise().minCoeff().transpose();
+    IndexVectorX eiperm     = IndexVectorX::LinSpaced(nElements, Index(0), nElements - 1);
+    std::stable_sort(eiperm.begin(), eiperm.end(), [&](Index e, Index f) {
+        return Tmin(e) < Tmin(f);
+    });
+    IndexVectorX eperm(nElements);
+    eperm(eiperm) = IndexVectorX::LinSpaced(nElements, Index(0), nElements - 1);
+    // Quad.pts. follow their element, whose index is recovered from the vertex-quad.pt.
+    // adjacency. Unreferenced quad.pts. go last.
+    IndexVectorX qe = IndexVectorX::Constant(nQuadPts, nElements);
+    for (auto k = 0; k < data.GVGg.size(); ++k)
+        qe(data.GVGg(k)) = eperm(data.GVGe(k));
+    IndexVectorX giperm = IndexVectorX::LinSpaced(nQuadPts, Index(0), nQuadPts - 1);
+    std::stable_sort(giperm.begin(), giperm.end(), [&](Index g, Index q) {
+        return qe(g) < qe(q);
+    });
+    IndexVectorX gperm(nQuadPts);
+    gperm(giperm) = IndexVectorX::LinSpaced(nQuadPts, Index(0), nQuadPts - 1);
+    // Permute per-element and per-quad.pt. quantities
+    IndexVectorX GPcols(3 * nQuadPts);
+    for (Index g = 0; g < nQuadPts; ++g)
+        for (auto d = 0; d < 3; ++d)
+            GPcols(3 * g + d) = 3 * giperm(g) + d;
+    data.T    = data.T(Eigen::all, eiperm).eval();
+    data.wg   = data.wg(giperm).eval();
+    data.GP   = data.GP(Eigen::all, GPcols).eval();
+    data.lame = data.lame(Eigen::all, giperm).eval();
+    // Renumber the vertex-quad.pt. adjacency, and sort each vertex's neighbours by quad.pt., such
+    // that BCD iterations traverse element data in memory order.
+    tbb::parallel_for(Index(0), nVertices, [&](Index i) {
+        auto const kbegin = data.GVGp(i);
+        auto const nAdj   = data.GVGp(i + 1) - kbegin;
+        IndexVectorX order(nAdj);
+        for (auto k = 0; k < nAdj; ++k)
+            order(k) = kbegin + k;
+        std::sort(order.begin(), order.end(), [&](Index k, Index l) {
+            return gperm(data.GVGg(k)) < gperm(data.GVGg(l));
+        });
+        IndexVectorX const GVGg      = gperm(data.GVGg(order));
+        IndexVectorX const GVGe      = eperm(data.GVGe(order));
+        IndexVectorX const GVGilocal = data.GVGilocal(order);
+        data.GVGg.segment(kbegin, nAdj)      = GVGg;
+        data.GVGe.segment(kbegin, nAdj)      = GVGe;
+        data.GVGilocal.segment(kbegin, nAdj) = GVGilocal;
+    });
+    // Compose with a previous reordering, if any, so that eperm always maps from user ordering
+    if (data.eperm.size() == nElements)
+    {
+        data.eiperm             = data.eiperm(eiperm).eval();
+        data.eperm(data.eiperm) = IndexVectorX::LinSpaced(nElements, Index(0), nElements - 1);
+    }
+    else
+    {
+        data.eperm  = std::move(eperm);
+        data.eiperm = std::move(eiperm);
+    }
+}
+
+} // namespace
 
 Data& Data::WithVolumeMesh(
     Eigen::Ref<MatrixX const> const& Vin,
@@ -29,6 +215,12 @@ Data& Data::WithSurfaceMesh(
     return *this;
 }
 
+Data& Data::WithCollisionGroups(Eigen::Ref<IndexVectorX const> const& Gin)
+{
+    this->G = Gin;
+    return *this;
+}
+
 Data& Data::WithVelocity(Eigen::Ref<MatrixX const> const& vIn)
 {
     this->v = vIn;
@@ -111,6 +303,62 @@ Data& Data::WithHessianDeterminantZeroUnder(Scalar zero)
     return *this;
 }
 
+Data& Data::WithVertexReordering(bool bReorder)
+{
+    this->bReorderVertices = bReorder;
+    return *this;
+}
+
+Data& Data::WithElementDerivativeCache(bool bCache, Scalar tolerance)
+{
+    this->bCacheElementDerivatives = bCache;
+    this->cacheTolerance           = tolerance;
+    return *this;
+}
+
+Data& Data::WithElement(EElement eElementIn, int orderIn)
+{
+    this->eElement = eElementIn;
+    this->order    = orderIn;
+    return *this;
+}
+
+Data& Data::WithHyperElasticEnergy(EHyperElasticEnergy eEnergyIn)
+{
+    this->eEnergy = eEnergyIn;
+    return *this;
+}
+
+Data& Data::WithConvergenceTolerances(Scalar residual, Scalar displacement)
+{
+    this->residualTolerance     = residual;
+    this->displacementTolerance = displacement;
+    return *this;
+}
+
+Data& Data::WithActiveSet(Scalar residual, Scalar displacement)
+{
+    this->bUseActiveSet               = true;
+    this->activeResidualThreshold     = residual;
+    this->activeDisplacementThreshold = displacement;
+    return *this;
+}
+
+Data& Data::WithSpectralRadiusEstimation(Index warmupIterations, Scalar rhoMaxIn)
+{
+    if (warmupIterations < 2)
+    {
+        std::string const what = fmt::format(
+            "Spectral radius estimation requires at least 2 warmup iterations, but got {}",
+            warmupIterations);
+        throw std::invalid_argument(what);
+    }
+    this->bEstimateSpectralRadius   = true;
+    this->chebyshevWarmupIterations = warmupIterations;
+    this->rhoMax                    = rhoMaxIn;
+    return *this;
+}
+
 Data& Data::Construct(bool bValidate)
 {
     if (xt.size() == 0)
@@ -134,29 +382,53 @@ Data& Data::Construct(bool bValidate)
     xchebm2.resizeLike(x);
     xchebm1.resizeLike(x);
     vt.resizeLike(x);
+    FC.setConstant(V.size(), Index(-1));
+    GVCp.setZero(x.cols() + 1);
+    GVCc.resize(0);
+    GVCilocal.resize(0);
+    bVertexActive.setConstant(x.cols(), true);
+    if (bCacheElementDerivatives)
+    {
+        gF.resize(9, wg.size());
+        HF.resize(81, wg.size());
+        bQuadraturePointDirty.setConstant(wg.size(), true);
+    }
     if (lame.size() == 0)
     {
         auto const [mu, lambda] = physics::LameCoefficients(Scalar(1e6), Scalar(0.45));
-        lame.resize(2, T.cols());
+        lame.resize(2, wg.size());
         lame.row(0).setConstant(mu);
         lame.row(1).setConstant(lambda);
     }
     // Constrained vertices must not move
     v(Eigen::all, dbc).setZero();
     aext(Eigen::all, dbc).setZero();
+    // Color the mesh's primal graph if the user did not provide vertex partitions
+    if (partitions.empty())
+    {
+        auto const G   = graph::MeshPrimalGraph(T, static_cast<Index>(x.cols()));
+        auto const ptr = Eigen::Map<IndexVectorX const>(G.outerIndexPtr(), G.outerSize() + 1);
+        auto const adj = Eigen::Map<IndexVectorX const>(G.innerIndexPtr(), G.nonZeros());
+        IndexVectorX const C = graph::GreedyColor(ptr, adj);
+        partitions           = graph::ColorPartitions(C);
+    }
     for (auto& partition : partitions)
     {
         std::vector<Index> freePartition = partition;
         std::sort(partition.begin(), partition.end());
-        std::set_difference(
+        auto const freePartitionEnd = std::set_difference(
             partition.begin(),
             partition.end(),
             this->dbc.begin(),
             this->dbc.end(),
             freePartition.begin());
+        freePartition.erase(freePartitionEnd, freePartition.end());
         std::swap(partition, freePartition);
     }
-    
+    std::erase_if(partitions, [](std::vector<Index> const& partition) {
+        return partition.empty();
+    });
+
     if (bValidate)
     {
         // clang-format off
@@ -178,21 +450,33 @@ Data& Data::Construct(bool bValidate)
                 x.cols());
             throw std::invalid_argument(what);
         }
+        if (eElement != EElement::Tetrahedron or order < 1 or order > 2)
+        {
+            std::string const what = fmt::format(
+                "Only linear and quadratic tetrahedra are supported, but got order={}",
+                order);
+            throw std::invalid_argument(what);
+        }
+        auto const nElementNodes =
+            (order == 1) ? fem::Tetrahedron<1>::kNodes : fem::Tetrahedron<2>::kNodes;
         // clang-format off
         bool const bElementDimensionsValid = 
-            T.rows()    == 4 and 
-            T.cols()    == wg.size() and 
-            GP.rows()   == 4 and 
-            GP.cols()   == T.cols()*3 and 
+            T.rows()    == nElementNodes and 
+            wg.size()   >= T.cols() and 
+            GP.rows()   == nElementNodes and 
+            GP.cols()   == wg.size()*3 and 
             lame.rows() == 2 and 
-            lame.cols() == T.cols();
+            lame.cols() == wg.size();
         // clang-format on
         if (not bElementDimensionsValid)
         {
             std::string const what = fmt::format(
-                "With #elements={0}, expected T=4x{0}, wg=1x{0}, GP=4x{1}, lame=2x{0}",
+                "With #elements={0}, #quad.pts.={1} and {2} nodes per element, expected T={2}x{0}, "
+                "wg=1x{1}, GP={2}x{3}, lame=2x{1}",
                 T.cols(),
-                T.cols() * 3);
+                wg.size(),
+                nElementNodes,
+                wg.size() * 3);
             throw std::invalid_argument(what);
         }
         // clang-format off
@@ -209,6 +493,29 @@ Data& Data::Construct(bool bValidate)
                 x.cols() + 1);
             throw std::invalid_argument(what);
         }
+        // clang-format off
+        bool const bCollisionMeshValid = 
+            (F.size() == 0 or F.rows() == 3) and
+            (V.size() == 0 or (V.minCoeff() >= 0 and V.maxCoeff() < x.cols())) and
+            (G.size() == 0 or G.size() == x.cols());
+        // clang-format on
+        if (not bCollisionMeshValid)
+        {
+            std::string const what = fmt::format(
+                "Expected 3x|#collision triangles| F, collision vertices V in [0,{0}) and "
+                "collision groups G of size 0 or {0}",
+                x.cols());
+            throw std::invalid_argument(what);
+        }
+    }
+    if (bReorderVertices)
+    {
+        ReorderVertices(*this);
+        ReorderElements(*this);
+    }
+    if (bCacheElementDerivatives)
+    {
+        xc = x;
     }
     return *this;
 }
@@ -17,6 +17,12 @@ PBAT_API struct Data
     Data& WithSurfaceMesh(
         Eigen::Ref<IndexVectorX const> const& V,
         Eigen::Ref<IndexMatrixX const> const& F);
+    /**
+     * @brief Restricts contacts to vertices and triangles of the same collision group
+     * @param groups |#verts| collision group of each vertex
+     * @return
+     */
+    Data& WithCollisionGroups(Eigen::Ref<IndexVectorX const> const& groups);
     Data& WithVelocity(Eigen::Ref<MatrixX const> const& v);
     Data& WithAcceleration(Eigen::Ref<MatrixX const> const& aext);
     Data& WithMass(Eigen::Ref<VectorX const> const& m);
@@ -35,12 +41,96 @@ PBAT_API struct Data
     Data& WithRayleighDamping(Scalar kD);
     Data& WithCollisionPenalty(Scalar kC);
     Data& WithHessianDeterminantZeroUnder(Scalar zero);
+    /**
+     * @brief Renumbers vertices in Construct() such that each partition is contiguous in memory
+     * and spatially coherent (i.e. sorted by Morton code). Elements are then renumbered by their
+     * minimum vertex index, such that elements adjacent to nearby vertices are nearby in memory.
+     *
+     * Vertex quantities, T, F, V, dbc, partitions, quad.pt. quantities and the vertex adjacency
+     * are all expressed in the internal ordering after Construct(). Use perm to map results back
+     * to user ordering, i.e. x(Eigen::all, perm) gives vertex positions in user ordering, and
+     * eperm for elements, i.e. T(Eigen::all, eperm) are the user's elements.
+     *
+     * @param bReorder
+     * @return
+     */
+    Data& WithVertexReordering(bool bReorder = true);
+    /**
+     * @brief Caches per-element stress and stress derivatives across BCD iterations, such that
+     * an element's derivatives are only recomputed after one of its vertices moved.
+     *
+     * Exact block coordinate descent re-evaluates an element once after each of its vertices
+     * moved, so with the default tolerance=0, only elements whose vertices are all at rest are
+     * spared. In practice, BCD moves (nearly) all free vertices in every iteration until it has
+     * converged, such that tolerance=0 saves (nearly) no evaluations. With tolerance>0, vertices
+     * only invalidate their elements once they moved farther than tolerance from where they last
+     * did so, which bounds the cached derivatives' staleness, e.g. a tolerance well under the
+     * vertices' displacements per time step spares most evaluations of late BCD iterations.
+     * Vertex positions are always updated.
+     *
+     * @param bCache
+     * @param tolerance Vertex displacement from the position at which a vertex last invalidated
+     * its elements' cached derivatives, under which they remain valid
+     * @return
+     */
+    Data& WithElementDerivativeCache(bool bCache = true, Scalar tolerance = Scalar(0));
+    /**
+     * @brief Sets the type of elements in T, i.e. the rows of T, GP and the vertex adjacency GVG*
+     * must match elements of the given order.
+     *
+     * @param eElement
+     * @param order Polynomial order of the elements, i.e. 1 (linear) or 2 (quadratic)
+     * @return
+     */
+    Data& WithElement(EElement eElement, int order = 1);
+    Data& WithHyperElasticEnergy(EHyperElasticEnergy eEnergy);
+    /**
+     * @brief Stops BCD iterations once the max vertex gradient norm is under residual and the max
+     * vertex displacement is under displacement. Non-positive tolerances are ignored.
+     *
+     * @param residual
+     * @param displacement
+     * @return
+     */
+    Data& WithConvergenceTolerances(Scalar residual, Scalar displacement = Scalar(0));
+    /**
+     * @brief Only solves active vertices in BCD iterations after the first of each substep.
+     *
+     * A vertex remains active while its gradient norm exceeds residual or its displacement
+     * exceeds displacement. Vertices whose displacement exceeds displacement also activate their
+     * 1-ring, i.e. the vertices of their adjacent elements and contacts. Inactive vertices keep
+     * their positions, are not Chebyshev accelerated, and are integrated in time as usual.
+     * Convergence tolerances (see WithConvergenceTolerances) also apply to the residuals of
+     * inactive vertices at the time they were deactivated.
+     *
+     * @param residual
+     * @param displacement
+     * @return
+     */
+    Data& WithActiveSet(Scalar residual, Scalar displacement);
+    /**
+     * @brief Enables Chebyshev acceleration with a spectral radius estimated online.
+     *
+     * Each substep runs warmupIterations plain BCD iterations, whose ratio of successive max
+     * vertex displacements estimates the spectral radius (smoothed over substeps), before
+     * switching to Chebyshev acceleration. If accelerated iterations diverge, i.e. their max
+     * vertex displacement increases over chebyshevDivergenceIterations consecutive iterations,
+     * the substep falls back to plain BCD iterations from the last plain iterate, and the
+     * estimate is reduced.
+     *
+     * @param warmupIterations Number of plain BCD iterations per substep, at least 2
+     * @param rhoMax Upper bound on the estimated spectral radius
+     * @return
+     */
+    Data& WithSpectralRadiusEstimation(Index warmupIterations = 3, Scalar rhoMax = Scalar(0.95));
     Data& Construct(bool bValidate = true);
 
   public:
     IndexVectorX V; ///< Collision vertices
     IndexMatrixX F; ///< Collision triangles (on the boundary of T)
-    IndexMatrixX T; ///< Tetrahedra
+    IndexMatrixX T; ///< |#elem.nodes|x|#elements| elements
+    IndexVectorX G; ///< |#verts| collision groups s.t. only vertices and triangles of the same
+                    ///< group collide, or empty if all vertices may collide
 
     MatrixX x;    ///< Vertex positions
     MatrixX v;    ///< Vertex velocities
@@ -68,17 +158,75 @@ PBAT_API struct Data
                             ///< GVGilocal[k] for GVGp[i] <= k < GVGp[i+1] gives the local index of
                             ///< vertex i for the neighbouring quad.pts.
 
+    IndexVectorX FC;        ///< |#collision vertices| contact triangles s.t. FC[c] is the
+                            ///< triangle in contact with collision vertex V[c], or -1 if none
+    IndexVectorX GVCp;      ///< |#verts+1| prefixes into GVCc
+    IndexVectorX GVCc;      ///< |# of vertex-contact edges| contacts s.t.
+                            ///< GVCc[k] for GVCp[i] <= k < GVCp[i+1] gives the contacts (i.e.
+                            ///< indices into V and FC) involving vertex i
+    IndexVectorX GVCilocal; ///< |# of vertex-contact edges| local vertex indices s.t.
+                            ///< GVCilocal[k] for GVCp[i] <= k < GVCp[i+1] is 0 if vertex i is
+                            ///< the contact's collision vertex, or 1+j if vertex i is the j^{th}
+                            ///< vertex of the contact triangle
+
     IndexVectorX dbc; ///< Dirichlet constrained vertices (sorted)
 
     std::vector<std::vector<Index>>
         partitions; ///< partitions[c] gives the c^{th} group of vertices which can all be
-                    ///< integrated independently in parallel
+                    ///< integrated independently in parallel. If empty, Construct() computes
+                    ///< partitions by greedy coloring of the mesh's primal graph.
 
     EInitializationStrategy strategy{
         EInitializationStrategy::AdaptivePbat}; ///< BCD optimization initialization strategy
     Scalar kD{0};                               ///< Uniform damping coefficient
     Scalar kC{1};                               ///< Uniform collision penalty
     Scalar detHZero{1e-7}; ///< Numerical zero for hessian pseudo-singularity check
+
+    EElement eElement{EElement::Tetrahedron}; ///< Type of elements in T
+    int order{1};                             ///< Polynomial order of elements in T
+    EHyperElasticEnergy eEnergy{
+        EHyperElasticEnergy::StableNeoHookean}; ///< Hyper elastic energy of the elements
+
+    bool bReorderVertices{false}; ///< Renumber vertices for locality in Construct()
+    IndexVectorX perm;            ///< |#verts| s.t. perm[i] is the internal index of user vertex
+                                  ///< i, or empty if vertices were not reordered
+    IndexVectorX iperm;           ///< |#verts| s.t. iperm[i] is the user index of internal vertex
+                                  ///< i, or empty if vertices were not reordered
+    IndexVectorX eperm;           ///< |#elements| s.t. eperm[e] is the internal index of user
+                                  ///< element e, or empty if elements were not reordered
+    IndexVectorX eiperm;          ///< |#elements| s.t. eiperm[e] is the user index of internal
+                                  ///< element e, or empty if elements were not reordered
+
+    bool bCacheElementDerivatives{false}; ///< Cache per-element derivatives in BCD iterations
+    Scalar cacheTolerance{0};             ///< Vertex displacement under which the cache is kept
+    MatrixX xc;                           ///< 3x|#verts| positions at which vertices last
+                                          ///< invalidated their elements' cached derivatives
+    MatrixX gF;                           ///< 9x|#quad.pts.| cached elastic energy gradients
+                                          ///< w.r.t. the deformation gradient
+    MatrixX HF;                           ///< 81x|#quad.pts.| cached (column-major) elastic
+                                          ///< energy hessians w.r.t. the deformation gradient
+    Eigen::Vector<bool, Eigen::Dynamic>
+        bQuadraturePointDirty; ///< |#quad.pts.| flags s.t. bQuadraturePointDirty[g] is true if
+                               ///< gF.col(g) and HF.col(g) must be recomputed
+
+    Scalar residualTolerance{0};     ///< Max vertex gradient norm under which BCD stops, if > 0
+    Scalar displacementTolerance{0}; ///< Max vertex displacement under which BCD stops, if > 0
+
+    bool bUseActiveSet{false};             ///< Only solve active vertices in BCD iterations
+    Scalar activeResidualThreshold{0};     ///< Vertex gradient norm over which a vertex is active
+    Scalar activeDisplacementThreshold{0}; ///< Vertex displacement over which a vertex and its
+                                           ///< 1-ring are active
+    Eigen::Vector<bool, Eigen::Dynamic>
+        bVertexActive; ///< |#verts| flags s.t. bVertexActive[i] is true if vertex i is solved in
+                       ///< the current BCD iteration
+
+    bool bEstimateSpectralRadius{false};    ///< Estimate Chebyshev's spectral radius online
+    Index chebyshevWarmupIterations{3};     ///< Plain BCD iterations per substep before Chebyshev
+    Scalar rhoEstimate{0};                  ///< Current spectral radius estimate
+    Scalar rhoMax{0.95};                    ///< Upper bound on the spectral radius estimate
+    Scalar rhoDivergenceFactor{0.9};        ///< Scales the estimate down upon divergence
+    Index chebyshevDivergenceIterations{3}; ///< Consecutive accelerated iterations of increasing
+                                            ///< max vertex displacement declaring divergence
 };
 
 } // namespace vbd
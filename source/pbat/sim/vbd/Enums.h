@@ -13,6 +13,10 @@ enum class EInitializationStrategy {
     AdaptivePbat
 };
 
+enum class EElement { Tetrahedron };
+
+enum class EHyperElasticEnergy { SaintVenantKirchhoff, StableNeoHookean };
+
 } // namespace vbd
 } // namespace sim
 } // namespace pbat
@@ -1,37 +1,373 @@
 #include "Integrator.h"
 
 #include "Kernels.h"
+#include "pbat/common/ConstexprFor.h"
+#include "pbat/fem/Concepts.h"
+#include "pbat/fem/Tetrahedron.h"
+#include "pbat/geometry/DistanceQueries.h"
+#include "pbat/geometry/OverlapQueries.h"
+#include "pbat/geometry/TetrahedralAabbHierarchy.h"
+#include "pbat/geometry/TriangleAabbHierarchy.h"
 #include "pbat/math/linalg/mini/Mini.h"
+#include "pbat/physics/HyperElasticity.h"
+#include "pbat/physics/SaintVenantKirchhoffEnergy.h"
 #include "pbat/physics/StableNeoHookeanEnergy.h"
 #include "pbat/profiling/Profiling.h"
 
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <exception>
+#include <fmt/format.h>
+#include <limits>
+#include <memory>
+#include <numeric>
+#include <optional>
+#include <string>
+#include <tbb/concurrent_vector.h>
 #include <tbb/parallel_for.h>
 #include <type_traits>
+#include <vector>
 
 namespace pbat {
 namespace sim {
 namespace vbd {
 
-Integrator::Integrator(Data dataIn) : data(std::move(dataIn)) {}
+/**
+ * @brief Broad phase collision detection structures of each collision group, such that vertices
+ * only query the elements and triangles of their own group.
+ *
+ * Elements and triangles belong to the group of their first vertex. Groups' hierarchies are
+ * small, e.g. 1 per scene of a BatchIntegrator, so they are built and refitted in parallel over
+ * groups, and serially within each group.
+ */
+class CollisionGroupHierarchies
+{
+  public:
+    using TetrahedronBvh = geometry::TetrahedralAabbHierarchy;
+    using TriangleBvh    = geometry::TriangleAabbHierarchy<3>;
 
-void Integrator::Step(Scalar dt, Index iterations, Index substeps, Scalar rho)
+    /**
+     * @brief Partitions the collision mesh into groups and builds their hierarchies
+     * @param TV 4x|#elements| linear sub-mesh of data.T
+     * @param data
+     */
+    CollisionGroupHierarchies(IndexMatrixX const& TV, Data const& data);
+    /**
+     * @brief Refits all groups' hierarchies to data.x
+     */
+    void Update();
+    /**
+     * @brief Checks if these hierarchies were built on data's vertex positions and collision mesh,
+     * e.g. false if data was copied or its mesh was replaced since
+     * @param data
+     * @return
+     */
+    bool IsBuiltOn(Data const& data) const;
+
+    IndexVectorX vertexGroup; ///< |#verts| group of each vertex in [0, #groups)
+    std::vector<IndexMatrixX> TG; ///< |#groups| linear sub-mesh elements of each group
+    std::vector<IndexMatrixX> FG; ///< |#groups| collision triangles of each group
+    std::vector<IndexVectorX> FGf; ///< |#groups| indices into data.F of each group's triangles
+    std::vector<std::optional<TetrahedronBvh>>
+        Tbvh; ///< |#groups| element hierarchies, empty if the group has no elements
+    std::vector<std::optional<TriangleBvh>>
+        Fbvh; ///< |#groups| triangle hierarchies, empty if the group has no triangles
+
+  private:
+    Scalar const* x;     ///< Vertex positions the hierarchies reference
+    Index nVertices;     ///< Number of vertices at construction
+    Index nElements;     ///< Number of elements at construction
+    Index nTriangles;    ///< Number of collision triangles at construction
+    Index nGroupEntries; ///< Number of collision group entries at construction
+};
+
+CollisionGroupHierarchies::CollisionGroupHierarchies(IndexMatrixX const& TV, Data const& data)
+    : x(data.x.data()),
+      nVertices(data.x.cols()),
+      nElements(data.T.cols()),
+      nTriangles(data.F.cols()),
+      nGroupEntries(data.G.size())
 {
-    PBAT_PROFILE_NAMED_SCOPE("pbat.sim.vbd.Integrator.Step");
+    PBAT_PROFILE_NAMED_SCOPE("pbat.sim.vbd.Integrator.CollisionGroupHierarchies.Construct");
+    // Map (arbitrary) collision group ids to [0, #groups)
+    std::size_t nGroups{1};
+    if (data.G.size() > 0)
+    {
+        std::vector<Index> groups(data.G.begin(), data.G.end());
+        std::sort(groups.begin(), groups.end());
+        groups.erase(std::unique(groups.begin(), groups.end()), groups.end());
+        nGroups     = groups.size();
+        vertexGroup = data.G.unaryExpr([&](Index g) {
+            return static_cast<Index>(
+                std::distance(groups.begin(), std::lower_bound(groups.begin(), groups.end(), g)));
+        });
+    }
+    else
+    {
+        vertexGroup.setZero(nVertices);
+    }
+    // Bucket elements and triangles by group, i.e. counting sort by group
+    auto const Bucket = [&](IndexMatrixX const& C, IndexVectorX& offsets, IndexVectorX& sorted) {
+        offsets.setZero(static_cast<Index>(nGroups) + 1);
+        for (auto e = 0; e < C.cols(); ++e)
+            ++offsets(vertexGroup(C(0, e)) + 1);
+        std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+        sorted.resize(C.cols());
+        IndexVectorX k = offsets.head(static_cast<Index>(nGroups));
+        for (auto e = 0; e < C.cols(); ++e)
+            sorted(k(vertexGroup(C(0, e)))++) = e;
+    };
+    IndexVectorX TGp, TGe, FGp, FGe;
+    Bucket(TV, TGp, TGe);
+    Bucket(data.F, FGp, FGe);
+    // Hierarchies reference TG and FG, which are not resized from here on
+    TG.resize(nGroups);
+    FG.resize(nGroups);
+    FGf.resize(nGroups);
+    Tbvh.resize(nGroups);
+    Fbvh.resize(nGroups);
+    tbb::parallel_for(std::size_t(0), nGroups, [&](std::size_t gs) {
+        auto const g = static_cast<Index>(gs);
+        FGf[gs]      = FGe.segment(FGp(g), FGp(g + 1) - FGp(g));
+        TG[gs]       = TV(Eigen::all, TGe.segment(TGp(g), TGp(g + 1) - TGp(g)));
+        FG[gs]       = data.F(Eigen::all, FGf[gs]);
+        if (TG[gs].cols() > 0)
+            Tbvh[gs].emplace(data.x, TG[gs]);
+        if (FG[gs].cols() > 0)
+            Fbvh[gs].emplace(data.x, FG[gs]);
+    });
+}
+
+void CollisionGroupHierarchies::Update()
+{
+    PBAT_PROFILE_NAMED_SCOPE("pbat.sim.vbd.Integrator.CollisionGroupHierarchies.Update");
+    bool constexpr bParallelize{false};
+    tbb::parallel_for(std::size_t(0), Tbvh.size(), [&](std::size_t g) {
+        if (Tbvh[g].has_value())
+            Tbvh[g]->Update(bParallelize);
+        if (Fbvh[g].has_value())
+            Fbvh[g]->Update(bParallelize);
+    });
+}
 
+bool CollisionGroupHierarchies::IsBuiltOn(Data const& data) const
+{
+    return x == data.x.data() and nVertices == data.x.cols() and nElements == data.T.cols() and
+           nTriangles == data.F.cols() and nGroupEntries == data.G.size();
+}
+
+namespace {
+
+/**
+ * @brief Finds, for each collision vertex penetrating a tetrahedron, its nearest topologically
+ * separate collision triangle, and stores the vertex-contact adjacency in data.
+ * @param bvh Collision groups' hierarchies over data.x
+ * @param data
+ */
+void DetectVertexTriangleContacts(CollisionGroupHierarchies const& bvh, Data& data)
+{
+    PBAT_PROFILE_NAMED_SCOPE("pbat.sim.vbd.Integrator.DetectVertexTriangleContacts");
+    using TetrahedronBvh = CollisionGroupHierarchies::TetrahedronBvh;
+    using TriangleBvh    = CollisionGroupHierarchies::TriangleBvh;
+    using math::linalg::mini::FromEigen;
+    auto const nCollisionVertices = data.V.size();
+    tbb::parallel_for(Index(0), Index(nCollisionVertices), [&](Index c) {
+        data.FC(c)    = Index(-1);
+        Index const i = data.V(c);
+        auto const xi = data.x.col(i).head<3>();
+        // Vertices of different collision groups never collide
+        auto const g = static_cast<std::size_t>(bvh.vertexGroup(i));
+        if (not bvh.Tbvh[g].has_value() or not bvh.Fbvh[g].has_value())
+            return;
+        // Collision vertex must penetrate a tetrahedron which it is not a vertex of
+        std::vector<Index> const overlaps = bvh.Tbvh[g]->PrimitivesIntersecting(
+            [&](TetrahedronBvh::BoundingVolumeType const& bv) -> bool {
+                return bv.contains(xi);
+            },
+            [&](TetrahedronBvh::PrimitiveType const& T) -> bool {
+                bool const bAreTopologicallySeparate = (T.array() != i).all();
+                if (not bAreTopologicallySeparate)
+                    return false;
+                auto const xT = data.x(Eigen::all, T);
+                return geometry::OverlapQueries::PointTetrahedron3D(
+                    FromEigen(xi),
+                    FromEigen(xT.col(0).head<3>()),
+                    FromEigen(xT.col(1).head<3>()),
+                    FromEigen(xT.col(2).head<3>()),
+                    FromEigen(xT.col(3).head<3>()));
+            },
+            1ULL);
+        if (overlaps.empty())
+            return;
+        // Contact triangle is the nearest topologically separate triangle
+        Scalar constexpr kInvalidDistance = std::numeric_limits<Scalar>::max();
+        auto const [nearestTriangles, distances] = bvh.Fbvh[g]->NearestPrimitivesTo(
+            [&](TriangleBvh::BoundingVolumeType const& bv) -> Scalar {
+                return bv.squaredExteriorDistance(xi);
+            },
+            [&](TriangleBvh::PrimitiveType const& F) -> Scalar {
+                bool const bAreTopologicallySeparate = (F.array() != i).all();
+                if (not bAreTopologicallySeparate)
+                    return kInvalidDistance;
+                auto const xF = data.x(Eigen::all, F);
+                return geometry::DistanceQueries::PointTriangle(
+                    FromEigen(xi),
+                    FromEigen(xF.col(0).head<3>()),
+                    FromEigen(xF.col(1).head<3>()),
+                    FromEigen(xF.col(2).head<3>()));
+            },
+            1ULL);
+        bool const bHasContact =
+            not nearestTriangles.empty() and distances.front() < kInvalidDistance;
+        if (bHasContact)
+            data.FC(c) = bvh.FGf[g](nearestTriangles.front());
+    });
+    // Build vertex-contact adjacency, such that each vertex can accumulate the contact energy
+    // derivatives of all contacts it is involved in, i.e. as collision vertex or triangle vertex.
+    auto const nVertices = data.x.cols();
+    data.GVCp.setZero(nVertices + 1);
+    for (auto c = 0; c < nCollisionVertices; ++c)
+    {
+        auto const f = data.FC(c);
+        if (f < 0)
+            continue;
+        ++data.GVCp(data.V(c) + 1);
+        for (auto j = 0; j < 3; ++j)
+            ++data.GVCp(data.F(j, f) + 1);
+    }
+    std::partial_sum(data.GVCp.begin(), data.GVCp.end(), data.GVCp.begin());
+    data.GVCc.resize(data.GVCp(nVertices));
+    data.GVCilocal.resize(data.GVCp(nVertices));
+    IndexVectorX k = data.GVCp.head(nVertices);
+    for (auto c = 0; c < nCollisionVertices; ++c)
+    {
+        auto const f = data.FC(c);
+        if (f < 0)
+            continue;
+        auto const i         = data.V(c);
+        data.GVCc(k(i))      = c;
+        data.GVCilocal(k(i)) = 0;
+        ++k(i);
+        for (auto j = 0; j < 3; ++j)
+        {
+            auto const fj         = data.F(j, f);
+            data.GVCc(k(fj))      = c;
+            data.GVCilocal(k(fj)) = j + 1;
+            ++k(fj);
+        }
+    }
+}
+
+/**
+ * @brief Integrates data 1 time step with VBD on a mesh of TElement elements and hyper elastic
+ * energy THyperElasticEnergy, such that element kernels are fully inlined.
+ * @param bvh Collision groups' hierarchies of previous steps, (re)built if not built on data
+ */
+template <fem::CElement TElement, physics::CHyperElasticEnergy THyperElasticEnergy>
+void Solve(
+    Data& data,
+    Stats& stats,
+    std::shared_ptr<CollisionGroupHierarchies>& bvh,
+    Scalar dt,
+    Index iterations,
+    Index substeps,
+    Scalar rho)
+{
+    auto constexpr kNodes = TElement::kNodes;
+    auto constexpr kDims  = THyperElasticEnergy::kDims;
+    static_assert(kDims == 3, "VBD only supports 3D hyper elastic energies");
     Scalar sdt                           = dt / (static_cast<Scalar>(substeps));
     Scalar sdt2                          = sdt * sdt;
     auto const nVertices                 = data.x.cols();
     using IndexType                      = std::remove_const_t<decltype(nVertices)>;
-    bool const bUseChebyshevAcceleration = rho > Scalar(0) and rho < Scalar(1);
+    bool const bUseChebyshevAcceleration =
+        data.bEstimateSpectralRadius or (rho > Scalar(0) and rho < Scalar(1));
     using namespace math::linalg;
     using mini::FromEigen;
     using mini::ToEigen;
+    // Broad phase collision detection runs on the elements' linear (i.e. vertex) sub-mesh
+    bool const bHasCollisionMesh = data.V.size() > 0 and data.F.cols() > 0 and data.T.cols() > 0;
+    MatrixX xs{};
+    // Convergence telemetry, i.e. the last residual and displacement of each solved vertex
+    VectorX residuals(nVertices);
+    VectorX displacements(nVertices);
+    // Active set, i.e. compact per-color lists of the vertices solved in the current BCD iteration,
+    // and of the vertices activated for the next one
+    auto const nColors = data.partitions.size();
+    std::vector<std::vector<Index>> activePartitions{};
+    std::vector<tbb::concurrent_vector<Index>> nextActivePartitions(nColors);
+    Eigen::Vector<bool, Eigen::Dynamic> bVertexActiveNext{};
+    IndexVectorX vertexColor{};
+    IndexVectorX chebyshevIteration{};
+    if (data.bUseActiveSet)
+    {
+        bVertexActiveNext.setConstant(nVertices, false);
+        vertexColor.setConstant(nVertices, Index(-1));
+        for (auto c = 0ULL; c < nColors; ++c)
+            for (Index i : data.partitions[c])
+                vertexColor(i) = static_cast<Index>(c);
+    }
+    auto const& sweepPartitions = data.bUseActiveSet ? activePartitions : data.partitions;
+    auto const ActivateAll      = [&](Scalar& inactiveResidual) {
+        for (auto& next : nextActivePartitions)
+        {
+            for (Index i : next)
+                bVertexActiveNext[i] = false;
+            next.clear();
+        }
+        activePartitions = data.partitions;
+        data.bVertexActive.setConstant(false);
+        for (auto const& partition : activePartitions)
+            for (Index i : partition)
+                data.bVertexActive[i] = true;
+        inactiveResidual = Scalar(0);
+    };
+    auto const Activate         = [&](Index j) {
+        // Constrained vertices are never solved
+        auto const c = vertexColor(j);
+        if (c < 0)
+            return;
+        bool const bWasActive =
+            std::atomic_ref<bool>(bVertexActiveNext[j]).exchange(true, std::memory_order_relaxed);
+        if (not bWasActive)
+            nextActivePartitions[static_cast<std::size_t>(c)].push_back(j);
+    };
+    // Moving vertices activate their 1-ring, whose energies they changed
+    auto const ActivateOneRing = [&](Index i) {
+        Activate(i);
+        for (auto n = data.GVGp[i]; n < data.GVGp[i + 1]; ++n)
+            for (auto j : data.T.col(data.GVGe[n]))
+                Activate(j);
+        for (auto n = data.GVCp[i]; n < data.GVCp[i + 1]; ++n)
+        {
+            auto const c = data.GVCc[n];
+            Activate(data.V[c]);
+            for (auto j : data.F.col(data.FC[c]))
+                Activate(j);
+        }
+    };
+    // Vertices invalidate the cached derivatives of their adjacent elements once they moved
+    // farther than the cache tolerance from where they last did so, which bounds the cache's
+    // staleness while always keeping the solver's updates.
+    Scalar const cacheTolerance2          = data.cacheTolerance * data.cacheTolerance;
+    auto const InvalidateMovedVertexCache = [&](IndexType i) {
+        if ((data.x.col(i) - data.xc.col(i)).squaredNorm() <= cacheTolerance2)
+            return;
+        data.xc.col(i) = data.x.col(i);
+        for (auto n = data.GVGp[i]; n < data.GVGp[i + 1]; ++n)
+            std::atomic_ref<bool>(data.bQuadraturePointDirty[data.GVGg[n]])
+                .store(true, std::memory_order_relaxed);
+    };
+    // Element derivative evaluations of the current BCD iteration
+    std::atomic<Index> nEvaluations{0};
+    stats = Stats{};
     for (auto s = 0; s < substeps; ++s)
     {
         // Store previous positions
         data.xt = data.x;
         // Compute inertial target positions
-        tbb::parallel_for(IndexType(0), nVertices, [&](auto i) {
+        tbb::parallel_for(IndexType(0), nVertices, [&](IndexType i) {
             auto xtilde = kernels::InertialTarget(
                 FromEigen(data.xt.col(i).head<3>()),
                 FromEigen(data.v.col(i).head<3>()),
@@ -41,7 +377,7 @@ void Integrator::Step(Scalar dt, Index iterations, Index substeps, Scalar rho)
             data.xtilde.col(i) = ToEigen(xtilde);
         });
         // Initialize block coordinate descent's, i.e. BCD's, solution
-        tbb::parallel_for(IndexType(0), nVertices, [&](auto i) {
+        tbb::parallel_for(IndexType(0), nVertices, [&](IndexType i) {
             auto x = kernels::InitialPositionsForSolve(
                 FromEigen(data.xt.col(i).head<3>()),
                 FromEigen(data.vt.col(i).head<3>()),
@@ -52,72 +388,314 @@ void Integrator::Step(Scalar dt, Index iterations, Index substeps, Scalar rho)
                 data.strategy);
             data.x.col(i) = ToEigen(x);
         });
-        // Initialize Chebyshev semi-iterative method
+        // Detect contacts at the initial BCD solution
+        if (bHasCollisionMesh)
+        {
+            // Hierarchies are kept across steps, and only rebuilt if data's positions or
+            // collision mesh were replaced.
+            if (not bvh or not bvh->IsBuiltOn(data))
+            {
+                IndexMatrixX const TV = data.T(TElement::Vertices, Eigen::all);
+                bvh                   = std::make_shared<CollisionGroupHierarchies>(TV, data);
+            }
+            else
+            {
+                bvh->Update();
+            }
+            DetectVertexTriangleContacts(*bvh, data);
+        }
+        bool const bHasContacts = data.GVCc.size() > 0;
+        // All vertices must be visited at least once per substep, since their inertial targets
+        // changed. Vertices leaving the active set keep their last residual, whose max over
+        // vertices deactivated in this substep (conservatively) bounds inactive vertices'
+        // residuals.
+        Scalar inactiveResidual{0};
+        if (data.bUseActiveSet)
+            ActivateAll(inactiveResidual);
+        // BCD's initial solution moved vertices
+        if (data.bCacheElementDerivatives)
+            tbb::parallel_for(IndexType(0), nVertices, InvalidateMovedVertexCache);
+        // Initialize Chebyshev semi-iterative method. When estimating the spectral radius, the
+        // first iterations are plain BCD iterations, whose successive displacements' ratio
+        // estimates the spectral radius, and Chebyshev acceleration starts afterwards.
         Scalar omega{};
-        Scalar rho2 = rho * rho;
+        Scalar rhok = data.bEstimateSpectralRadius ? data.rhoEstimate : rho;
+        Scalar rho2 = rhok * rhok;
+        bool bAccelerate = bUseChebyshevAcceleration and not data.bEstimateSpectralRadius;
+        bool bHasDiverged{false};
+        Index kc{0};
+        Scalar displacementPrev{0};
+        Index nDisplacementIncreases{0};
+        Scalar rhoWarmup{0};
+        MatrixX xplain{};
         // Minimize Backward Euler, i.e. BDF1, objective
-        for (auto k = 0; k < iterations; ++k)
+        stats.residuals.emplace_back();
+        stats.displacements.emplace_back();
+        stats.evaluations.emplace_back();
+        Index k{0};
+        while (k < iterations)
         {
-            if (bUseChebyshevAcceleration)
-                omega = kernels::ChebyshevOmega(k, rho2, omega);
+            if (bAccelerate)
+                omega = kernels::ChebyshevOmega(kc, rho2, omega);
+            // Inactive vertices do not move, so their position is also their Chebyshev history
+            if (bAccelerate and kc == 0 and data.bUseActiveSet)
+            {
+                data.xchebm2 = data.x;
+                data.xchebm1 = data.x;
+                chebyshevIteration.setConstant(nVertices, Index(-1));
+            }
+            // Vertices in the same partition may share a contact, so contact energies read
+            // other vertices' positions from a snapshot of the current iterate.
+            if (bHasContacts)
+                xs = data.x;
+            nEvaluations.store(0, std::memory_order_relaxed);
 
-            for (auto const& partition : data.partitions)
+            for (auto const& partition : sweepPartitions)
             {
                 auto const nVerticesInPartition = static_cast<std::size_t>(partition.size());
-                tbb::parallel_for(std::size_t(0), nVerticesInPartition, [&](auto v) {
+                tbb::parallel_for(std::size_t(0), nVerticesInPartition, [&](std::size_t v) {
                     auto i     = partition[v];
                     auto begin = data.GVGp[i];
                     auto end   = data.GVGp[i + 1];
                     // Compute vertex elastic hessian
                     mini::SMatrix<Scalar, 3, 3> Hi = mini::Zeros<Scalar, 3, 3>();
                     mini::SVector<Scalar, 3> gi    = mini::Zeros<Scalar, 3, 1>();
+                    Index nVertexEvaluations{0};
                     for (auto n = begin; n < end; ++n)
                     {
-                        auto ilocal                     = data.GVGilocal[n];
-                        auto e                          = data.GVGe[n];
-                        auto g                          = data.GVGg[n];
-                        auto lamee                      = data.lame.col(e);
-                        auto wg                         = data.wg[g];
-                        auto Te                         = data.T.col(e);
-                        mini::SMatrix<Scalar, 4, 3> GPe = FromEigen(data.GP.block<4, 3>(0, e * 3));
-                        mini::SMatrix<Scalar, 3, 4> xe =
-                            FromEigen(data.x(Eigen::all, Te).block<3, 4>(0, 0));
-                        mini::SMatrix<Scalar, 3, 3> Fe = xe * GPe;
-                        physics::StableNeoHookeanEnergy<3> Psi{};
-                        mini::SVector<Scalar, 9> gF;
-                        mini::SMatrix<Scalar, 9, 9> HF;
-                        Psi.gradAndHessian(Fe, lamee(0), lamee(1), gF, HF);
-                        kernels::AccumulateElasticHessian(ilocal, wg, GPe, HF, Hi);
-                        kernels::AccumulateElasticGradient(ilocal, wg, GPe, gF, gi);
+                        auto ilocal = data.GVGilocal[n];
+                        auto e      = data.GVGe[n];
+                        auto g      = data.GVGg[n];
+                        auto lameg  = data.lame.col(g);
+                        auto wg     = data.wg[g];
+                        auto Te     = data.T.col(e);
+                        mini::SMatrix<Scalar, kNodes, kDims> GPg =
+                            FromEigen(data.GP.template block<kNodes, kDims>(0, g * kDims));
+                        mini::SVector<Scalar, kDims * kDims> gF;
+                        mini::SMatrix<Scalar, kDims * kDims, kDims * kDims> HF;
+                        // Vertices of the same partition never share an element, so cached
+                        // element derivatives are read and written without races.
+                        bool const bIsQuadraturePointCached =
+                            data.bCacheElementDerivatives and not data.bQuadraturePointDirty[g];
+                        if (bIsQuadraturePointCached)
+                        {
+                            using HFType = Matrix<kDims * kDims, kDims * kDims>;
+                            gF = FromEigen(data.gF.col(g).template head<kDims * kDims>());
+                            HF = FromEigen(Eigen::Map<HFType const>(data.HF.col(g).data()));
+                        }
+                        else
+                        {
+                            mini::SMatrix<Scalar, kDims, kNodes> xe = FromEigen(
+                                data.x(Eigen::all, Te).template block<kDims, kNodes>(0, 0));
+                            mini::SMatrix<Scalar, kDims, kDims> Fg = xe * GPg;
+                            THyperElasticEnergy Psi{};
+                            Psi.gradAndHessian(Fg, lameg(0), lameg(1), gF, HF);
+                            ++nVertexEvaluations;
+                        }
+                        if (data.bCacheElementDerivatives and not bIsQuadraturePointCached)
+                        {
+                            data.gF.col(g)                = ToEigen(gF);
+                            data.HF.col(g)                = ToEigen(HF).reshaped();
+                            data.bQuadraturePointDirty[g] = false;
+                        }
+                        kernels::AccumulateElasticHessian(ilocal, wg, GPg, HF, Hi);
+                        kernels::AccumulateElasticGradient(ilocal, wg, GPg, gF, gi);
+                    }
+                    nEvaluations.fetch_add(nVertexEvaluations, std::memory_order_relaxed);
+                    // Compute vertex contact hessian
+                    mini::SVector<Scalar, 3> xi = FromEigen(data.x.col(i).head<3>());
+                    for (auto n = data.GVCp[i]; n < data.GVCp[i + 1]; ++n)
+                    {
+                        auto c                      = data.GVCc[n];
+                        auto ilocal                 = data.GVCilocal[n];
+                        auto Ff                     = data.F.col(data.FC[c]);
+                        mini::SVector<Scalar, 3> xv = FromEigen(xs.col(data.V[c]).head<3>());
+                        mini::SMatrix<Scalar, 3, 3> xf =
+                            FromEigen(xs(Eigen::all, Ff).block<3, 3>(0, 0));
+                        if (ilocal == 0)
+                            xv = xi;
+                        else
+                            xf.Col(ilocal - 1) = xi;
+                        kernels::AddVertexTriangleContactDerivatives(
+                            ilocal,
+                            data.kC,
+                            xv,
+                            xf,
+                            gi,
+                            Hi);
                     }
                     // Update vertex position
                     Scalar m                         = data.m[i];
                     mini::SVector<Scalar, 3> xti     = FromEigen(data.xt.col(i).head<3>());
                     mini::SVector<Scalar, 3> xtildei = FromEigen(data.xtilde.col(i).head<3>());
-                    mini::SVector<Scalar, 3> xi      = FromEigen(data.x.col(i).head<3>());
                     kernels::AddDamping(sdt, xti, xi, data.kD, gi, Hi);
                     kernels::AddInertiaDerivatives(sdt2, m, xtildei, xi, gi, Hi);
+                    residuals(i)                         = mini::Norm(gi);
+                    mini::SVector<Scalar, 3> const xiold = xi;
                     kernels::IntegratePositions(gi, Hi, xi, data.detHZero);
+                    Scalar const dx2 = mini::SquaredNorm(xi - xiold);
+                    displacements(i) = std::sqrt(dx2);
+                    // Vertices stay active until they converge
+                    if (data.bUseActiveSet)
+                    {
+                        if (displacements(i) > data.activeDisplacementThreshold)
+                            ActivateOneRing(i);
+                        else if (residuals(i) > data.activeResidualThreshold)
+                            Activate(i);
+                    }
                     data.x.col(i) = ToEigen(xi);
+                    if (data.bCacheElementDerivatives)
+                        InvalidateMovedVertexCache(i);
                 });
             }
 
-            if (bUseChebyshevAcceleration)
+            // Only solved vertices are accelerated, since constrained and inactive vertices do
+            // not move
+            if (bAccelerate)
             {
-                tbb::parallel_for(IndexType(0), nVertices, [&](auto i) {
-                    auto xkm2eig = data.xchebm2.col(i).head<3>();
-                    auto xkm1eig = data.xchebm1.col(i).head<3>();
-                    auto xkeig   = data.x.col(i).head<3>();
-                    auto xkm2    = FromEigen(xkm2eig);
-                    auto xkm1    = FromEigen(xkm1eig);
-                    auto xk      = FromEigen(xkeig);
-                    kernels::ChebyshevUpdate(k, omega, xkm2, xkm1, xk);
-                });
+                for (auto const& partition : sweepPartitions)
+                {
+                    auto const nVerticesInPartition = static_cast<std::size_t>(partition.size());
+                    tbb::parallel_for(std::size_t(0), nVerticesInPartition, [&](std::size_t v) {
+                        auto const i = partition[v];
+                        // Vertices skipped in the previous iteration were at rest
+                        if (data.bUseActiveSet)
+                        {
+                            if (chebyshevIteration(i) < kc - 1)
+                                data.xchebm2.col(i) = data.xchebm1.col(i);
+                            chebyshevIteration(i) = kc;
+                        }
+                        Vector<3> const xiold = data.x.col(i).head<3>();
+                        auto xkm2eig          = data.xchebm2.col(i).head<3>();
+                        auto xkm1eig          = data.xchebm1.col(i).head<3>();
+                        auto xkeig            = data.x.col(i).head<3>();
+                        auto xkm2             = FromEigen(xkm2eig);
+                        auto xkm1             = FromEigen(xkm1eig);
+                        auto xk               = FromEigen(xkeig);
+                        kernels::ChebyshevUpdate(kc, omega, xkm2, xkm1, xk);
+                        // Accelerated moves also activate the 1-ring
+                        bool const bHasMoved =
+                            (data.x.col(i).head<3>() - xiold).norm() >
+                            data.activeDisplacementThreshold;
+                        if (data.bUseActiveSet and bHasMoved)
+                            ActivateOneRing(i);
+                        if (data.bCacheElementDerivatives)
+                            InvalidateMovedVertexCache(i);
+                    });
+                }
+                ++kc;
+            }
+            ++k;
+            // Inactive vertices' last residuals must also be converged, but they have not moved
+            Scalar residual{inactiveResidual};
+            Scalar displacement{0};
+            for (auto const& partition : sweepPartitions)
+            {
+                for (Index i : partition)
+                {
+                    residual     = std::max(residual, residuals(i));
+                    displacement = std::max(displacement, displacements(i));
+                }
+            }
+            bool bHasActiveVertices{true};
+            if (data.bUseActiveSet)
+            {
+                for (auto c = 0ULL; c < nColors; ++c)
+                {
+                    for (Index i : activePartitions[c])
+                    {
+                        data.bVertexActive[i] = false;
+                        if (not bVertexActiveNext[i])
+                            inactiveResidual = std::max(inactiveResidual, residuals(i));
+                    }
+                }
+                bHasActiveVertices = false;
+                for (auto c = 0ULL; c < nColors; ++c)
+                {
+                    auto& next = nextActivePartitions[c];
+                    activePartitions[c].assign(next.begin(), next.end());
+                    next.clear();
+                    std::sort(activePartitions[c].begin(), activePartitions[c].end());
+                    for (Index i : activePartitions[c])
+                    {
+                        bVertexActiveNext[i]  = false;
+                        data.bVertexActive[i] = true;
+                    }
+                    bHasActiveVertices = bHasActiveVertices or not activePartitions[c].empty();
+                }
+            }
+            // Estimate the spectral radius of BCD iterations, and switch to/from Chebyshev
+            // acceleration
+            bool bHasRestored{false};
+            if (data.bEstimateSpectralRadius and not bHasDiverged)
+            {
+                if (not bAccelerate)
+                {
+                    if (k > 1 and displacementPrev > Scalar(0))
+                        rhoWarmup = displacement / displacementPrev;
+                    if (k >= data.chebyshevWarmupIterations)
+                    {
+                        // Smooth the estimate over substeps
+                        data.rhoEstimate = (data.rhoEstimate > Scalar(0)) ?
+                                               Scalar(0.5) * (data.rhoEstimate + rhoWarmup) :
+                                               rhoWarmup;
+                        data.rhoEstimate = std::min(data.rhoEstimate, data.rhoMax);
+                        rhok             = data.rhoEstimate;
+                        rho2             = rhok * rhok;
+                        bAccelerate      = rhok > Scalar(0) and rhok < Scalar(1);
+                        kc               = 0;
+                        // Accelerated iterations restart from the last plain BCD iterate if they
+                        // diverge
+                        if (bAccelerate)
+                            xplain = data.x;
+                    }
+                }
+                else
+                {
+                    // Single displacement increases are common in accelerated iterations, so
+                    // divergence is only declared after several consecutive increases.
+                    nDisplacementIncreases =
+                        (displacement > displacementPrev) ? nDisplacementIncreases + 1 : Index(0);
+                    if (nDisplacementIncreases >= data.chebyshevDivergenceIterations)
+                    {
+                        // Acceleration diverges, so we fall back to plain BCD iterations from the
+                        // last plain iterate, and underestimate the spectral radius in
+                        // subsequent substeps.
+                        bAccelerate      = false;
+                        bHasDiverged     = true;
+                        bHasRestored     = true;
+                        data.rhoEstimate = data.rhoDivergenceFactor * rhok;
+                        data.x           = xplain;
+                        if (data.bCacheElementDerivatives)
+                            tbb::parallel_for(IndexType(0), nVertices, InvalidateMovedVertexCache);
+                        if (data.bUseActiveSet)
+                        {
+                            ActivateAll(inactiveResidual);
+                            bHasActiveVertices = true;
+                        }
+                    }
+                }
             }
+            displacementPrev = displacement;
+            // Stop once all enabled convergence criteria are met
+            stats.residuals.back().push_back(residual);
+            stats.displacements.back().push_back(displacement);
+            stats.evaluations.back().push_back(nEvaluations.load(std::memory_order_relaxed));
+            bool const bHasTolerance = data.residualTolerance > Scalar(0) or
+                                       data.displacementTolerance > Scalar(0);
+            bool const bHasConverged =
+                bHasTolerance and not bHasRestored and
+                (data.residualTolerance <= Scalar(0) or residual <= data.residualTolerance) and
+                (data.displacementTolerance <= Scalar(0) or
+                 displacement <= data.displacementTolerance);
+            if (bHasConverged or not bHasActiveVertices)
+                break;
         }
+        stats.iterations.push_back(k);
+        stats.rho.push_back(kc > 0 ? rhok : Scalar(0));
         // Update velocity
         data.vt = data.v;
-        tbb::parallel_for(IndexType(0), nVertices, [&](auto i) {
+        tbb::parallel_for(IndexType(0), nVertices, [&](IndexType i) {
             auto v = kernels::IntegrateVelocity(
                 FromEigen(data.xt.col(i).head<3>()),
                 FromEigen(data.x.col(i).head<3>()),
@@ -127,6 +705,61 @@ void Integrator::Step(Scalar dt, Index iterations, Index substeps, Scalar rho)
     }
 }
 
+/**
+ * @brief Calls f.template operator()<TElement, THyperElasticEnergy>() for the element type and
+ * hyper elastic energy selected at runtime.
+ */
+template <class Func>
+void ApplyToElementAndEnergy(EElement eElement, int order, EHyperElasticEnergy eEnergy, Func&& f)
+{
+    using namespace pbat::common;
+    bool bApplied{false};
+    ForValues<1, 2>([&]<auto Order>() {
+        using ElementType = fem::Tetrahedron<Order>;
+        ForTypes<physics::SaintVenantKirchhoffEnergy<3>, physics::StableNeoHookeanEnergy<3>>(
+            [&]<physics::CHyperElasticEnergy EnergyType>() {
+                EHyperElasticEnergy const eEnergyCandidate =
+                    std::is_same_v<EnergyType, physics::StableNeoHookeanEnergy<3>> ?
+                        EHyperElasticEnergy::StableNeoHookean :
+                        EHyperElasticEnergy::SaintVenantKirchhoff;
+                if (eElement == EElement::Tetrahedron and order == Order and
+                    eEnergy == eEnergyCandidate)
+                {
+                    f.template operator()<ElementType, EnergyType>();
+                    bApplied = true;
+                }
+            });
+    });
+    if (not bApplied)
+    {
+        std::string const what = fmt::format("Unsupported VBD element of order={}", order);
+        throw std::invalid_argument(what);
+    }
+}
+
+} // namespace
+
+Integrator::Integrator(Data dataIn) : data(std::move(dataIn)) {}
+
+void Integrator::Step(Scalar dt, Index iterations, Index substeps, Scalar rho)
+{
+    PBAT_PROFILE_NAMED_SCOPE("pbat.sim.vbd.Integrator.Step");
+    ApplyToElementAndEnergy(
+        data.eElement,
+        data.order,
+        data.eEnergy,
+        [&]<fem::CElement TElement, physics::CHyperElasticEnergy THyperElasticEnergy>() {
+            Solve<TElement, THyperElasticEnergy>(
+                data,
+                stats,
+                mCollisionHierarchies,
+                dt,
+                iterations,
+                substeps,
+                rho);
+        });
+}
+
 } // namespace vbd
 } // namespace sim
 } // namespace pbat
@@ -139,7 +772,9 @@ void Integrator::Step(Scalar dt, Index iterations, Index substeps, Scalar rho)
 #include "pbat/fem/Tetrahedron.h"
 #include "pbat/physics/HyperElasticity.h"
 
+#include <algorithm>
 #include <doctest/doctest.h>
+#include <numeric>
 #include <span>
 
 TEST_CASE("[sim][vbd] Integrator")
@@ -148,7 +783,6 @@ TEST_CASE("[sim][vbd] Integrator")
     // Arrange
     // Cube mesh
     MatrixX P(3, 8);
-    IndexMatrixX V(1, 8);
     IndexMatrixX T(4, 5);
     IndexMatrixX F(3, 12);
     // clang-format off
@@ -163,31 +797,6 @@ TEST_CASE("[sim][vbd] Integrator")
          1, 5, 3, 7, 2, 6, 0, 4, 3, 2, 5, 7,
          4, 4, 5, 5, 7, 7, 6, 6, 1, 3, 6, 6;
     // clang-format on
-    V.reshaped().setLinSpaced(0, static_cast<Index>(P.cols() - 1));
-    // Parallel graph information
-    using SparseMatrixType = Eigen::SparseMatrix<Index, Eigen::ColMajor, Index>;
-    using TripletType      = Eigen::Triplet<Index, Index>;
-    SparseMatrixType G(T.cols(), P.cols());
-    std::vector<TripletType> Gei{};
-    for (auto e = 0; e < T.cols(); ++e)
-    {
-        for (auto ilocal = 0; ilocal < T.rows(); ++ilocal)
-        {
-            auto i = T(ilocal, e);
-            Gei.push_back(TripletType{e, i, ilocal});
-        }
-    }
-    G.setFromTriplets(Gei.begin(), Gei.end());
-    assert(G.isCompressed());
-    std::span<Index> vertexTetrahedronPrefix{
-        G.outerIndexPtr(),
-        static_cast<std::size_t>(G.outerSize() + 1)};
-    std::span<Index> vertexTetrahedronNeighbours{
-        G.innerIndexPtr(),
-        static_cast<std::size_t>(G.nonZeros())};
-    std::span<Index> vertexTetrahedronLocalVertexIndices{
-        G.valuePtr(),
-        static_cast<std::size_t>(G.nonZeros())};
     std::vector<std::vector<Index>> partitions{};
     partitions.push_back({2, 7, 4, 1});
     partitions.push_back({0});
@@ -195,45 +804,498 @@ TEST_CASE("[sim][vbd] Integrator")
     partitions.push_back({6});
     partitions.push_back({3});
     // Material parameters
-    using Element = fem::Tetrahedron<1>;
-    using Mesh    = fem::Mesh<Element, 3>;
-    Mesh mesh{P, T};
-    MatrixX const GP        = fem::ShapeFunctionGradients<1>(mesh);
-    VectorX wg              = fem::InnerProductWeights<1>(mesh).reshaped();
     auto constexpr Y        = Scalar{1e6};
     auto constexpr nu       = Scalar{0.45};
     auto const [mu, lambda] = physics::LameCoefficients(Y, nu);
-    MatrixX lame(2, T.cols());
-    lame.row(0).setConstant(mu);
-    lame.row(1).setConstant(lambda);
     // Problem parameters
-    MatrixX aext(3, P.cols());
-    aext.colwise()            = Vector<3>{Scalar{0}, Scalar{0}, Scalar{-9.81}};
     auto constexpr dt         = Scalar{1e-2};
     auto constexpr substeps   = 1;
     auto constexpr iterations = 10;
+    auto constexpr zero       = Scalar{1e-4};
+
+    // Creates VBD data for the tetrahedral mesh (X,C), i.e. with its quadrature and parallel graph
+    // information
+    auto const MakeData = [&](MatrixX const& X, IndexMatrixX const& C) {
+        using SparseMatrixType = Eigen::SparseMatrix<Index, Eigen::ColMajor, Index>;
+        using TripletType      = Eigen::Triplet<Index, Index>;
+        SparseMatrixType G(C.cols(), X.cols());
+        std::vector<TripletType> Gei{};
+        for (auto e = 0; e < C.cols(); ++e)
+        {
+            for (auto ilocal = 0; ilocal < C.rows(); ++ilocal)
+            {
+                auto i = C(ilocal, e);
+                Gei.push_back(TripletType{e, i, ilocal});
+            }
+        }
+        G.setFromTriplets(Gei.begin(), Gei.end());
+        assert(G.isCompressed());
+        std::span<Index> vertexTetrahedronPrefix{
+            G.outerIndexPtr(),
+            static_cast<std::size_t>(G.outerSize() + 1)};
+        std::span<Index> vertexTetrahedronNeighbours{
+            G.innerIndexPtr(),
+            static_cast<std::size_t>(G.nonZeros())};
+        std::span<Index> vertexTetrahedronLocalVertexIndices{
+            G.valuePtr(),
+            static_cast<std::size_t>(G.nonZeros())};
+        using Element = fem::Tetrahedron<1>;
+        using Mesh    = fem::Mesh<Element, 3>;
+        Mesh mesh{X, C};
+        MatrixX const GP = fem::ShapeFunctionGradients<1>(mesh);
+        VectorX wg       = fem::InnerProductWeights<1>(mesh).reshaped();
+        MatrixX lame(2, C.cols());
+        lame.row(0).setConstant(mu);
+        lame.row(1).setConstant(lambda);
+        using pbat::common::ToEigen;
+        return sim::vbd::Data()
+            .WithVolumeMesh(X, C)
+            .WithQuadrature(wg, GP, lame)
+            .WithVertexAdjacency(
+                ToEigen(vertexTetrahedronPrefix),
+                ToEigen(vertexTetrahedronNeighbours),
+                ToEigen(vertexTetrahedronNeighbours),
+                ToEigen(vertexTetrahedronLocalVertexIndices));
+    };
+
+    SUBCASE("Free fall")
+    {
+        // Act
+        MatrixX aext(3, P.cols());
+        aext.colwise() = Vector<3>{Scalar{0}, Scalar{0}, Scalar{-9.81}};
+        using pbat::sim::vbd::Integrator;
+        Integrator vbd{
+            MakeData(P, T).WithAcceleration(aext).WithPartitions(partitions).Construct()};
+        vbd.Step(dt, iterations, substeps);
+
+        // Assert
+        MatrixX dx                           = vbd.data.x - P;
+        bool const bVerticesFallUnderGravity = (dx.row(2).array() < Scalar{0}).all();
+        CHECK(bVerticesFallUnderGravity);
+        bool const bVerticesOnlyFall = (dx.topRows(2).array().abs() < zero).all();
+        CHECK(bVerticesOnlyFall);
+    }
+    SUBCASE("Vertex reordering")
+    {
+        // Act
+        MatrixX aext(3, P.cols());
+        aext.colwise() = Vector<3>{Scalar{0}, Scalar{0}, Scalar{-9.81}};
+        using pbat::sim::vbd::Integrator;
+        Integrator vbd{MakeData(P, T).WithAcceleration(aext).Construct()};
+        Integrator vbdReordered{
+            MakeData(P, T).WithAcceleration(aext).WithVertexReordering().Construct()};
+        vbd.Step(dt, iterations, substeps);
+        vbdReordered.Step(dt, iterations, substeps);
+
+        // Assert
+        auto const& data = vbdReordered.data;
+        REQUIRE_EQ(data.perm.size(), P.cols());
+        IndexVectorX const iota =
+            IndexVectorX::LinSpaced(P.cols(), Index(0), static_cast<Index>(P.cols() - 1));
+        bool const bIsPermutation = (data.perm(data.iperm).array() == iota.array()).all();
+        CHECK(bIsPermutation);
+        REQUIRE_EQ(data.eperm.size(), T.cols());
+        bool const bIsElementPermutation =
+            (data.eperm(data.eiperm).array() ==
+             IndexVectorX::LinSpaced(T.cols(), Index(0), static_cast<Index>(T.cols() - 1)).array())
+                .all();
+        CHECK(bIsElementPermutation);
+        IndexMatrixX const Tuser =
+            data.T(Eigen::all, data.eperm).unaryExpr([&](Index i) { return data.iperm(i); });
+        bool const bMeshRenumbered = (Tuser.array() == T.array()).all();
+        CHECK(bMeshRenumbered);
+        IndexVectorX const Tmin          = data.T.colwise().minCoeff().transpose();
+        bool const bElementsSortedByMinVertex = std::is_sorted(Tmin.begin(), Tmin.end());
+        CHECK(bElementsSortedByMinVertex);
+        for (Index i = 0; i < P.cols(); ++i)
+        {
+            for (auto n = data.GVGp(i); n < data.GVGp(i + 1); ++n)
+            {
+                auto const e = data.GVGe(n);
+                CHECK_EQ(data.T(data.GVGilocal(n), e), i);
+            }
+        }
+        Index begin{0};
+        for (auto const& partition : data.partitions)
+        {
+            for (Index i : partition)
+                CHECK_EQ(i, begin++);
+        }
+        MatrixX const x = data.x(Eigen::all, data.perm);
+        CHECK(x.isApprox(vbd.data.x));
+    }
+    SUBCASE("Element derivative cache")
+    {
+        // Arrange
+        // Pin the bottom face of the cube
+        IndexVectorX const dbc = (IndexVectorX(4) << 0, 1, 2, 3).finished();
+        MatrixX aext(3, P.cols());
+        aext.colwise() = Vector<3>{Scalar{0}, Scalar{0}, Scalar{-9.81}};
+
+        // Act
+        using pbat::sim::vbd::Integrator;
+        Integrator vbd{MakeData(P, T)
+                           .WithAcceleration(aext)
+                           .WithDirichletConstrainedVertices(dbc)
+                           .Construct()};
+        // With the default zero tolerance, the cache is exact, but only spares elements whose
+        // free vertices stopped moving altogether, which rarely happens while BCD is converging.
+        Integrator vbdCached{MakeData(P, T)
+                                 .WithAcceleration(aext)
+                                 .WithDirichletConstrainedVertices(dbc)
+                                 .WithElementDerivativeCache()
+                                 .Construct()};
+        // A tolerance well under the vertices' displacements per time step spares most
+        // evaluations once BCD's displacements become small.
+        auto constexpr cacheTolerance = Scalar{1e-6};
+        Integrator vbdLooselyCached{MakeData(P, T)
+                                        .WithAcceleration(aext)
+                                        .WithDirichletConstrainedVertices(dbc)
+                                        .WithElementDerivativeCache(true, cacheTolerance)
+                                        .Construct()};
+        // Vertices never move farther than the tolerance, so elements are evaluated once, but
+        // vertex positions must still be updated.
+        Integrator vbdTolerant{MakeData(P, T)
+                                   .WithAcceleration(aext)
+                                   .WithDirichletConstrainedVertices(dbc)
+                                   .WithElementDerivativeCache(true, Scalar{1e3})
+                                   .Construct()};
+        vbd.Step(dt, iterations, substeps);
+        vbdCached.Step(dt, iterations, substeps);
+        vbdLooselyCached.Step(dt, iterations, substeps);
+        vbdTolerant.Step(dt, iterations, substeps);
+
+        // Assert
+        CHECK(vbdCached.data.x.isApprox(vbd.data.x));
+        auto const nQuadPts = static_cast<Index>(vbd.data.wg.size());
+        Index nFreeAdjacency{0};
+        for (auto const& partition : vbd.data.partitions)
+            for (Index i : partition)
+                nFreeAdjacency += vbd.data.GVGp(i + 1) - vbd.data.GVGp(i);
+        auto const& evaluations         = vbd.stats.evaluations.front();
+        auto const& cachedEvaluations        = vbdCached.stats.evaluations.front();
+        auto const& looselyCachedEvaluations = vbdLooselyCached.stats.evaluations.front();
+        auto const& tolerantEvaluations      = vbdTolerant.stats.evaluations.front();
+        REQUIRE_EQ(evaluations.size(), static_cast<std::size_t>(iterations));
+        REQUIRE_EQ(cachedEvaluations.size(), static_cast<std::size_t>(iterations));
+        REQUIRE_EQ(looselyCachedEvaluations.size(), static_cast<std::size_t>(iterations));
+        REQUIRE_EQ(tolerantEvaluations.size(), static_cast<std::size_t>(iterations));
+        for (auto k = 0ULL; k < evaluations.size(); ++k)
+        {
+            CHECK_EQ(evaluations[k], nFreeAdjacency);
+            CHECK_LE(cachedEvaluations[k], evaluations[k]);
+            CHECK_LE(looselyCachedEvaluations[k], evaluations[k]);
+            CHECK_EQ(tolerantEvaluations[k], (k == 0ULL) ? nQuadPts : Index{0});
+        }
+        auto const nEvaluations =
+            std::accumulate(evaluations.begin(), evaluations.end(), Index{0});
+        auto const nLooselyCachedEvaluations = std::accumulate(
+            looselyCachedEvaluations.begin(),
+            looselyCachedEvaluations.end(),
+            Index{0});
+        CHECK_LT(2 * nLooselyCachedEvaluations, nEvaluations);
+        CHECK_LE((vbdLooselyCached.data.x - vbd.data.x).norm(), Scalar{1e-5});
+        MatrixX const dx = vbdTolerant.data.x - P;
+        bool const bFreeVerticesFallUnderGravity =
+            (dx.row(2).tail(P.cols() - dbc.size()).array() < Scalar{0}).all();
+        CHECK(bFreeVerticesFallUnderGravity);
+    }
+    SUBCASE("Early termination")
+    {
+        // Arrange
+        MatrixX aext(3, P.cols());
+        aext.colwise()                       = Vector<3>{Scalar{0}, Scalar{0}, Scalar{-9.81}};
+        auto constexpr maxIterations         = 100;
+        auto constexpr displacementTolerance = Scalar{1e-10};
+
+        // Act
+        using pbat::sim::vbd::Integrator;
+        Integrator vbd{MakeData(P, T)
+                           .WithAcceleration(aext)
+                           .WithConvergenceTolerances(Scalar{0}, displacementTolerance)
+                           .Construct()};
+        vbd.Step(dt, maxIterations, 2);
 
-    // Act
-    using pbat::common::ToEigen;
-    using pbat::sim::vbd::Integrator;
-    Integrator vbd{sim::vbd::Data()
-                       .WithVolumeMesh(P, T)
-                       .WithAcceleration(aext)
-                       .WithPartitions(partitions)
-                       .WithQuadrature(wg, GP, lame)
-                       .WithVertexAdjacency(
-                           ToEigen(vertexTetrahedronPrefix),
-                           ToEigen(vertexTetrahedronNeighbours),
-                           ToEigen(vertexTetrahedronNeighbours),
-                           ToEigen(vertexTetrahedronLocalVertexIndices))
-                       .Construct()};
-    vbd.Step(dt, iterations, substeps);
-
-    // Assert
-    auto constexpr zero                  = Scalar{1e-4};
-    MatrixX dx                           = vbd.data.x - P;
-    bool const bVerticesFallUnderGravity = (dx.row(2).array() < Scalar{0}).all();
-    CHECK(bVerticesFallUnderGravity);
-    bool const bVerticesOnlyFall = (dx.topRows(2).array().abs() < zero).all();
-    CHECK(bVerticesOnlyFall);
-}
\ No newline at end of file
+        // Assert
+        auto const& stats = vbd.stats;
+        REQUIRE_EQ(stats.iterations.size(), 2ULL);
+        REQUIRE_EQ(stats.displacements.size(), 2ULL);
+        REQUIRE_EQ(stats.residuals.size(), 2ULL);
+        for (auto s = 0ULL; s < 2ULL; ++s)
+        {
+            CHECK_LT(stats.iterations[s], maxIterations);
+            CHECK_EQ(stats.displacements[s].size(), stats.iterations[s]);
+            CHECK_EQ(stats.residuals[s].size(), stats.iterations[s]);
+            CHECK_LE(stats.displacements[s].back(), displacementTolerance);
+        }
+    }
+    SUBCASE("Active set")
+    {
+        // Arrange
+        // Pinned cube at rest, and a free falling cube
+        IndexVectorX const dbc = (IndexVectorX(4) << 0, 1, 2, 3).finished();
+        MatrixX const zero3    = MatrixX::Zero(3, P.cols());
+        MatrixX aext(3, P.cols());
+        aext.colwise()           = Vector<3>{Scalar{0}, Scalar{0}, Scalar{-9.81}};
+        auto constexpr threshold = Scalar{1e-10};
+
+        // Act
+        using pbat::sim::vbd::Integrator;
+        Integrator vbdAtRest{MakeData(P, T)
+                                 .WithAcceleration(zero3)
+                                 .WithDirichletConstrainedVertices(dbc)
+                                 .WithActiveSet(threshold, threshold)
+                                 .Construct()};
+        Integrator vbd{MakeData(P, T).WithAcceleration(aext).Construct()};
+        Integrator vbdActive{
+            MakeData(P, T).WithAcceleration(aext).WithActiveSet(Scalar{0}, Scalar{0}).Construct()};
+        vbdAtRest.Step(dt, iterations, substeps);
+        vbd.Step(dt, iterations, substeps);
+        vbdActive.Step(dt, iterations, substeps);
+
+        // Assert
+        CHECK_EQ(vbdAtRest.stats.iterations.front(), 1);
+        CHECK_FALSE(vbdAtRest.data.bVertexActive.any());
+        CHECK(vbdAtRest.data.x.isApprox(P));
+        CHECK(vbdActive.data.x.isApprox(vbd.data.x));
+    }
+    SUBCASE("Partially active set")
+    {
+        // Arrange
+        // Pinned cube at rest, next to a pinned cube hanging under gravity
+        auto const nVertices = P.cols();
+        auto const nElements = T.cols();
+        MatrixX X(3, 2 * nVertices);
+        X.leftCols(nVertices)  = P;
+        X.rightCols(nVertices) = P.colwise() + Vector<3>{Scalar{2}, Scalar{0}, Scalar{0}};
+        IndexMatrixX C(4, 2 * nElements);
+        C.leftCols(nElements)  = T;
+        C.rightCols(nElements) = T.array() + nVertices;
+        IndexVectorX const dbc = (IndexVectorX(8) << 0, 1, 2, 3, 8, 9, 10, 11).finished();
+        MatrixX aext           = MatrixX::Zero(3, 2 * nVertices);
+        aext.rightCols(nVertices).colwise() = Vector<3>{Scalar{0}, Scalar{0}, Scalar{-9.81}};
+        auto constexpr threshold            = Scalar{1e-6};
+        auto constexpr nSubsteps            = 2;
+        auto constexpr maxIterations        = 5;
+
+        // Act
+        using pbat::sim::vbd::Integrator;
+        Integrator vbd{
+            MakeData(X, C).WithAcceleration(aext).WithDirichletConstrainedVertices(dbc).Construct()};
+        Integrator vbdActive{MakeData(X, C)
+                                 .WithAcceleration(aext)
+                                 .WithDirichletConstrainedVertices(dbc)
+                                 .WithActiveSet(threshold, threshold)
+                                 .Construct()};
+        Integrator vbdChebyshev{MakeData(X, C)
+                                    .WithAcceleration(aext)
+                                    .WithDirichletConstrainedVertices(dbc)
+                                    .WithActiveSet(threshold, threshold)
+                                    .Construct()};
+        vbd.Step(dt, maxIterations, nSubsteps);
+        vbdActive.Step(dt, maxIterations, nSubsteps);
+        vbdChebyshev.Step(dt, maxIterations, nSubsteps, Scalar{0.5});
+
+        // Assert
+        for (auto const* integrator : {&vbdActive, &vbdChebyshev})
+        {
+            auto const& data                 = integrator->data;
+            bool const bRestingCubeIsInactive = not data.bVertexActive.head(nVertices).any();
+            CHECK(bRestingCubeIsInactive);
+            bool const bHangingCubeIsActive = data.bVertexActive.tail(nVertices).any();
+            CHECK(bHangingCubeIsActive);
+            bool const bRestingCubeDidNotMove = (data.x.leftCols(nVertices).array() ==
+                                                 X.leftCols(nVertices).array())
+                                                    .all();
+            CHECK(bRestingCubeDidNotMove);
+        }
+        CHECK(vbdActive.data.x.isApprox(vbd.data.x, Scalar{1e-6}));
+        CHECK(vbdChebyshev.data.x.isApprox(vbd.data.x, Scalar{1e-4}));
+    }
+    SUBCASE("Spectral radius estimation")
+    {
+        // Arrange
+        IndexVectorX const dbc = (IndexVectorX(4) << 0, 1, 2, 3).finished();
+        MatrixX aext(3, P.cols());
+        aext.colwise()               = Vector<3>{Scalar{0}, Scalar{0}, Scalar{-9.81}};
+        auto constexpr maxIterations = 30;
+        auto constexpr nSubsteps     = 3;
+
+        // Act
+        using pbat::sim::vbd::Integrator;
+        Integrator vbd{MakeData(P, T)
+                           .WithAcceleration(aext)
+                           .WithDirichletConstrainedVertices(dbc)
+                           .Construct()};
+        Integrator vbdChebyshev{MakeData(P, T)
+                                    .WithAcceleration(aext)
+                                    .WithDirichletConstrainedVertices(dbc)
+                                    .WithSpectralRadiusEstimation()
+                                    .Construct()};
+        vbd.Step(dt, maxIterations, nSubsteps);
+        vbdChebyshev.Step(dt, maxIterations, nSubsteps);
+
+        // Assert
+        auto const& stats = vbdChebyshev.stats;
+        REQUIRE_EQ(stats.rho.size(), nSubsteps);
+        for (auto s = 0ULL; s < stats.rho.size(); ++s)
+        {
+            CHECK_GT(stats.rho[s], Scalar{0});
+            CHECK_LE(stats.rho[s], vbdChebyshev.data.rhoMax);
+        }
+        CHECK(vbdChebyshev.data.x.isApprox(vbd.data.x, Scalar{1e-6}));
+    }
+    SUBCASE("Chebyshev divergence fallback")
+    {
+        // Arrange
+        IndexVectorX const dbc = (IndexVectorX(4) << 0, 1, 2, 3).finished();
+        MatrixX aext(3, P.cols());
+        aext.colwise()               = Vector<3>{Scalar{0}, Scalar{0}, Scalar{-9.81}};
+        auto constexpr largeDt       = Scalar{1e-1};
+        auto constexpr maxIterations = 30;
+        auto constexpr nSubsteps     = 3;
+        // Divergence zeroes the spectral radius estimate
+        auto const MakeIntegrator = [&](Index divergenceIterations) {
+            sim::vbd::Integrator vbd{MakeData(P, T)
+                                         .WithAcceleration(aext)
+                                         .WithDirichletConstrainedVertices(dbc)
+                                         .WithSpectralRadiusEstimation()
+                                         .Construct()};
+            vbd.data.rhoDivergenceFactor           = Scalar{0};
+            vbd.data.chebyshevDivergenceIterations = divergenceIterations;
+            return vbd;
+        };
+
+        // Act
+        sim::vbd::Integrator vbd{
+            MakeData(P, T).WithAcceleration(aext).WithDirichletConstrainedVertices(dbc).Construct()};
+        sim::vbd::Integrator vbdSensitive = MakeIntegrator(Index{1});
+        sim::vbd::Integrator vbdWindowed  = MakeIntegrator(Index{3});
+        vbd.Step(largeDt, maxIterations, nSubsteps);
+        vbdSensitive.Step(largeDt, maxIterations, nSubsteps);
+        vbdWindowed.Step(largeDt, maxIterations, nSubsteps);
+
+        // Assert
+        // A single increase of the accelerated displacement triggers the fallback to plain
+        // iterations from the last plain iterate, which must still converge to the plain solution
+        CHECK_EQ(vbdSensitive.data.rhoEstimate, Scalar{0});
+        CHECK(vbdSensitive.data.x.isApprox(vbd.data.x, Scalar{1e-6}));
+        // Isolated increases are not divergence
+        CHECK_GT(vbdWindowed.data.rhoEstimate, Scalar{0});
+        CHECK(vbdWindowed.data.x.isApprox(vbd.data.x, Scalar{1e-6}));
+    }
+    SUBCASE("Quadratic elements and Saint-Venant-Kirchhoff energy")
+    {
+        // Arrange
+        using Element             = fem::Tetrahedron<2>;
+        using Mesh                = fem::Mesh<Element, 3>;
+        auto constexpr kQuadOrder = 2;
+        auto constexpr kQuadPts   = Element::QuadratureType<kQuadOrder>::kPoints;
+        Mesh mesh{P, T};
+        MatrixX const GP     = fem::ShapeFunctionGradients<kQuadOrder>(mesh);
+        VectorX const wg     = fem::InnerProductWeights<kQuadOrder>(mesh).reshaped();
+        auto const nNodes    = mesh.X.cols();
+        auto const nElements = mesh.E.cols();
+        MatrixX lame(2, wg.size());
+        lame.row(0).setConstant(mu);
+        lame.row(1).setConstant(lambda);
+        // Vertex-quad.pt. adjacency
+        IndexVectorX GVGp = IndexVectorX::Zero(nNodes + 1);
+        for (auto e = 0; e < nElements; ++e)
+            for (auto ilocal = 0; ilocal < Element::kNodes; ++ilocal)
+                GVGp(mesh.E(ilocal, e) + 1) += kQuadPts;
+        std::partial_sum(GVGp.begin(), GVGp.end(), GVGp.begin());
+        IndexVectorX GVGg(GVGp(nNodes));
+        IndexVectorX GVGe(GVGp(nNodes));
+        IndexVectorX GVGilocal(GVGp(nNodes));
+        IndexVectorX k = GVGp.head(nNodes);
+        for (auto e = 0; e < nElements; ++e)
+        {
+            for (auto ilocal = 0; ilocal < Element::kNodes; ++ilocal)
+            {
+                auto const i = mesh.E(ilocal, e);
+                for (auto q = 0; q < kQuadPts; ++q)
+                {
+                    GVGg(k(i))      = e * kQuadPts + q;
+                    GVGe(k(i))      = e;
+                    GVGilocal(k(i)) = ilocal;
+                    ++k(i);
+                }
+            }
+        }
+        MatrixX aext(3, nNodes);
+        aext.colwise() = Vector<3>{Scalar{0}, Scalar{0}, Scalar{-9.81}};
+
+        // Act
+        using pbat::sim::vbd::EElement;
+        using pbat::sim::vbd::EHyperElasticEnergy;
+        using pbat::sim::vbd::Integrator;
+        Integrator vbd{sim::vbd::Data()
+                           .WithVolumeMesh(mesh.X, mesh.E)
+                           .WithQuadrature(wg, GP, lame)
+                           .WithVertexAdjacency(GVGp, GVGg, GVGe, GVGilocal)
+                           .WithElement(EElement::Tetrahedron, Element::kOrder)
+                           .WithHyperElasticEnergy(EHyperElasticEnergy::SaintVenantKirchhoff)
+                           .WithAcceleration(aext)
+                           .Construct()};
+        vbd.Step(dt, iterations, substeps);
+
+        // Assert
+        MatrixX dx                           = vbd.data.x - mesh.X;
+        bool const bVerticesFallUnderGravity = (dx.row(2).array() < Scalar{0}).all();
+        CHECK(bVerticesFallUnderGravity);
+        bool const bVerticesOnlyFall = (dx.topRows(2).array().abs() < zero).all();
+        CHECK(bVerticesOnlyFall);
+    }
+    SUBCASE("Contact")
+    {
+        // Arrange
+        // Fixed cube at the bottom, and a smaller cube on top of it, whose bottom vertices
+        // penetrate the fixed cube's top face (away from its edges and diagonals).
+        auto const nVertices = P.cols();
+        auto const nElements = T.cols();
+        MatrixX X(3, 2 * nVertices);
+        X.leftCols(nVertices) = P;
+        X.rightCols(nVertices) =
+            (Scalar{0.5} * P).colwise() + Vector<3>{Scalar{0.3}, Scalar{0.1}, Scalar{0.95}};
+        IndexMatrixX C(4, 2 * nElements);
+        C.leftCols(nElements)  = T;
+        C.rightCols(nElements) = T.array() + nVertices;
+        IndexMatrixX CF(3, 2 * F.cols());
+        CF.leftCols(F.cols())  = F;
+        CF.rightCols(F.cols()) = F.array() + nVertices;
+        IndexVectorX V(2 * nVertices);
+        V.setLinSpaced(0, static_cast<Index>(V.size() - 1));
+        IndexVectorX dbc = V.head(nVertices);
+        MatrixX aext = MatrixX::Zero(3, 2 * nVertices);
+        IndexVector<4> const bottom{8, 9, 10, 11};
+        auto constexpr kC = Scalar{1e9};
+
+        // Act
+        // Vertex partitions are computed by Construct()
+        using pbat::sim::vbd::Integrator;
+        Integrator vbd{MakeData(X, C)
+                           .WithSurfaceMesh(V, CF)
+                           .WithAcceleration(aext)
+                           .WithDirichletConstrainedVertices(dbc)
+                           .WithCollisionPenalty(kC)
+                           .Construct()};
+        vbd.Step(dt, iterations, substeps);
+
+        // Assert
+        bool const bFixedCubeDidNotMove = vbd.data.x.leftCols(nVertices).isApprox(P);
+        CHECK(bFixedCubeDidNotMove);
+        bool const bContactsDetected = (vbd.data.FC(bottom).array() >= 0).all();
+        CHECK(bContactsDetected);
+        VectorX const zBottom         = vbd.data.x(2, bottom);
+        VectorX const zBottom0        = X(2, bottom);
+        bool const bPenetrationReduced = (zBottom.array() > zBottom0.array()).all();
+        CHECK(bPenetrationReduced);
+        bool const bPartitionsAreFree = std::ranges::none_of(
+            vbd.data.partitions,
+            [&](std::vector<Index> const& partition) {
+                return std::ranges::any_of(partition, [&](Index i) { return i < nVertices; });
+            });
+        CHECK(bPartitionsAreFree);
+    }
+}
@@ -5,19 +5,60 @@
 #include "PhysicsBasedAnimationToolkitExport.h"
 #include "pbat/Aliases.h"
 
+#include <memory>
+#include <vector>
+
 namespace pbat {
 namespace sim {
 namespace vbd {
 
+/**
+ * @brief Convergence telemetry of the last call to Integrator::Step
+ */
+struct Stats
+{
+    std::vector<Index> iterations; ///< |#substeps| number of BCD iterations run per substep
+    std::vector<std::vector<Scalar>>
+        residuals; ///< residuals[s][k] is the max norm of vertex gradients at the k^{th} BCD
+                   ///< iteration of substep s
+    std::vector<std::vector<Scalar>>
+        displacements; ///< displacements[s][k] is the max vertex displacement at the k^{th} BCD
+                       ///< iteration of substep s
+    std::vector<std::vector<Index>>
+        evaluations; ///< evaluations[s][k] is the number of quad.pt. elastic energy derivative
+                     ///< evaluations at the k^{th} BCD iteration of substep s
+    std::vector<Scalar> rho; ///< |#substeps| spectral radius used by Chebyshev acceleration per
+                             ///< substep, or 0 if not accelerated
+};
+
+class CollisionGroupHierarchies;
+
 class Integrator
 {
   public:
     PBAT_API Integrator(Data data);
 
+    /**
+     * @brief Integrates the simulation 1 time step.
+     *
+     * Each substep runs at most iterations BCD iterations, but stops early once the convergence
+     * tolerances in data are met (see Data::WithConvergenceTolerances).
+     *
+     * @param dt Time step
+     * @param iterations Maximum number of BCD iterations per substep
+     * @param substeps Number of substeps
+     * @param rho Chebyshev semi-iterative method's estimated spectral radius. Ignored if data
+     * estimates the spectral radius (see Data::WithSpectralRadiusEstimation).
+     */
     PBAT_API void
     Step(Scalar dt, Index iterations, Index substeps = Index{1}, Scalar rho = Scalar{1});
 
     PBAT_API Data data;
+    PBAT_API Stats stats; ///< Convergence telemetry of the last Step
+
+  private:
+    std::shared_ptr<CollisionGroupHierarchies>
+        mCollisionHierarchies; ///< Contact broad phase hierarchies, kept across steps
 };
 
 } // namespace vbd
@@ -4,6 +4,7 @@
 #include "Enums.h"
 #include "pbat/HostDevice.h"
 #include "pbat/common/ConstexprFor.h"
+#include "pbat/geometry/ClosestPointQueries.h"
 #include "pbat/math/linalg/mini/Mini.h"
 
 #include <cmath>
@@ -92,7 +93,7 @@ PBAT_HOST ScalarType ChebyshevOmega(IndexType k, ScalarType rho2, ScalarType ome
 {
     return (k == IndexType(0)) ? ScalarType{1} :
            (k == IndexType(1)) ? ScalarType{2} / (ScalarType{2} - rho2) :
-                                 ScalarType{4} / ScalarType{4} - rho2 * omega;
+                                 ScalarType{4} / (ScalarType{4} - rho2 * omega);
 }
 
 template <
@@ -164,6 +165,43 @@ PBAT_HOST_DEVICE void AccumulateElasticGradient(
         [&]<auto k>() { gi += wg * GP(ilocal, k) * gF.template Slice<kDims, 1>(k * kDims, 0); });
 }
 
+template <
+    mini::CMatrix TMatrixXV,
+    mini::CMatrix TMatrixXF,
+    mini::CMatrix TMatrixG,
+    mini::CMatrix TMatrixH,
+    class IndexType,
+    class ScalarType = typename TMatrixXV::ScalarType>
+PBAT_HOST_DEVICE void AddVertexTriangleContactDerivatives(
+    IndexType ilocal,
+    ScalarType kC,
+    TMatrixXV const& xv,
+    TMatrixXF const& xf,
+    TMatrixG& g,
+    TMatrixH& H)
+{
+    // Penalty energy 1/2 kC d^2 of the penetration depth d < 0 of vertex xv along the normal of
+    // triangle xf, which we assume constant (as in XPBD's collision constraint). The vertex
+    // ilocal is 0 for xv, or 1+j for the j^{th} vertex of xf.
+    using namespace mini;
+    SVector<ScalarType, 3> n         = Cross(xf.Col(1) - xf.Col(0), xf.Col(2) - xf.Col(0));
+    ScalarType const doublearea      = Norm(n);
+    bool const bIsTriangleDegenerate = doublearea <= ScalarType{1e-8};
+    if (bIsTriangleDegenerate)
+        return;
+    n /= doublearea;
+    // Barycentric coordinates of the point on the triangle closest to xv
+    SVector<ScalarType, 3> const b =
+        geometry::ClosestPointQueries::UvwPointInTriangle(xv, xf.Col(0), xf.Col(1), xf.Col(2));
+    ScalarType const d = Dot(n, xv - xf * b);
+    // xv is positively oriented w.r.t. triangle xf, i.e. there is no penetration
+    if (d >= ScalarType{0})
+        return;
+    ScalarType const dddx = (ilocal == IndexType(0)) ? ScalarType{1} : -b(ilocal - 1);
+    g += (kC * d * dddx) * n;
+    H += (kC * dddx * dddx) * (n * n.Transpose());
+}
+
 template <
     mini::CMatrix TMatrixXT,
     mini::CMatrix TMatrixX,
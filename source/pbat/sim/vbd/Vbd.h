@@ -1,7 +1,9 @@
 #ifndef PBAT_SIM_VBD_VBD_H
 #define PBAT_SIM_VBD_VBD_H
 
-#include "Builder.h"
+#include "BatchIntegrator.h"
+#include "Data.h"
+#include "Enums.h"
 #include "Integrator.h"
 #include "Kernels.h"
 
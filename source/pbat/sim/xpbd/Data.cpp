@@ -1,9 +1,217 @@
 #include "Data.h"
 
+#include "pbat/physics/HyperElasticity.h"
+
+#include <Eigen/LU>
+#include <algorithm>
+#include <exception>
+#include <fmt/format.h>
+#include <string>
+
 namespace pbat {
 namespace sim {
 namespace xpbd {
 
-} // namespace xpbd 
+Data& Data::WithVolumeMesh(
+    Eigen::Ref<MatrixX const> const& Vin,
+    Eigen::Ref<IndexMatrixX const> const& Ein)
+{
+    this->x = Vin;
+    this->T = Ein;
+    return *this;
+}
+
+Data& Data::WithSurfaceMesh(
+    Eigen::Ref<IndexVectorX const> const& Vin,
+    Eigen::Ref<IndexMatrixX const> const& Fin)
+{
+    this->V = Vin;
+    this->F = Fin;
+    return *this;
+}
+
+Data& Data::WithBodies(Eigen::Ref<IndexVectorX const> const& Bin)
+{
+    this->B = Bin;
+    return *this;
+}
+
+Data& Data::WithVelocity(Eigen::Ref<MatrixX const> const& vIn)
+{
+    this->v = vIn;
+    return *this;
+}
+
+Data& Data::WithAcceleration(Eigen::Ref<MatrixX const> const& aextIn)
+{
+    this->aext = aextIn;
+    return *this;
+}
+
+Data& Data::WithMassInverse(Eigen::Ref<VectorX const> const& minvIn)
+{
+    this->minv = minvIn;
+    return *this;
+}
+
+Data& Data::WithElasticMaterial(Eigen::Ref<MatrixX const> const& lameIn)
+{
+    this->lame = lameIn;
+    return *this;
+}
+
+Data& Data::WithCompliance(Eigen::Ref<VectorX const> const& alphaIn, EConstraint eConstraint)
+{
+    this->alpha[static_cast<int>(eConstraint)] = alphaIn;
+    return *this;
+}
+
+Data& Data::WithFrictionCoefficients(Scalar muSin, Scalar muKin)
+{
+    this->muS = muSin;
+    this->muK = muKin;
+    return *this;
+}
+
+Data& Data::WithPartitions(std::vector<std::vector<Index>> const& partitionsIn)
+{
+    this->partitions = partitionsIn;
+    return *this;
+}
+
+Data& Data::WithDirichletConstrainedVertices(IndexVectorX const& dbcIn, bool bDbcSorted)
+{
+    this->dbc = dbcIn;
+    if (not bDbcSorted)
+    {
+        std::sort(this->dbc.begin(), this->dbc.end());
+    }
+    return *this;
+}
+
+Data& Data::Construct(bool bValidate)
+{
+    if (xt.size() == 0)
+    {
+        xt = x;
+    }
+    if (v.size() == 0)
+    {
+        v.setZero(x.rows(), x.cols());
+    }
+    if (minv.size() == 0)
+    {
+        minv.setConstant(x.cols(), Scalar(1e-3));
+    }
+    if (aext.size() == 0)
+    {
+        aext.resizeLike(x);
+        aext.colwise() = Vector<3>{Scalar(0), Scalar(0), Scalar(-9.81)};
+    }
+    if (B.size() == 0)
+    {
+        B.setZero(x.cols());
+    }
+    if (lame.size() == 0)
+    {
+        auto const [mu, lambda] = physics::LameCoefficients(Scalar(1e6), Scalar(0.45));
+        lame.resize(2, T.cols());
+        lame.row(0).setConstant(mu);
+        lame.row(1).setConstant(lambda);
+    }
+    // Precompute rest shape matrix inverses, compliance and rest stability of the Stable
+    // Neo-Hookean constraints
+    auto constexpr kStableNeoHookean = static_cast<int>(EConstraint::StableNeoHookean);
+    auto constexpr kCollision        = static_cast<int>(EConstraint::Collision);
+    bool const bComputeCompliance    = alpha[kStableNeoHookean].size() == 0;
+    if (bComputeCompliance)
+        alpha[kStableNeoHookean].resize(2 * T.cols());
+    DmInv.resize(3, 3 * T.cols());
+    gammaSNH.resize(T.cols());
+    for (auto c = 0; c < T.cols(); ++c)
+    {
+        Matrix<3, 4> const xc       = x(Eigen::all, T.col(c)).topRows<3>();
+        Matrix<3, 3> const Ds       = xc.rightCols<3>().colwise() - xc.col(0);
+        DmInv.block<3, 3>(0, 3 * c) = Ds.inverse();
+        if (bComputeCompliance)
+        {
+            Scalar const tetVolume = Ds.determinant() / Scalar(6);
+            alpha[kStableNeoHookean].segment<2>(2 * c) =
+                (Scalar(1) / (lame.col(c).array() * tetVolume)).matrix();
+        }
+        gammaSNH(c) = Scalar(1) + lame(0, c) / lame(1, c);
+    }
+    if (alpha[kCollision].size() == 0)
+    {
+        alpha[kCollision].setZero(V.size());
+    }
+    lambda[kStableNeoHookean].setZero(alpha[kStableNeoHookean].size());
+    lambda[kCollision].setZero(alpha[kCollision].size());
+    // Constrained vertices must not move
+    v(Eigen::all, dbc).setZero();
+    aext(Eigen::all, dbc).setZero();
+    minv(dbc).setZero();
+
+    if (bValidate)
+    {
+        // clang-format off
+        bool const bPerParticleQuantityDimensionsValid = 
+            x.cols() == xt.cols() and
+            x.cols() == v.cols() and
+            x.cols() == aext.cols() and
+            x.cols() == minv.size() and 
+            x.cols() == B.size() and 
+            x.rows() == xt.rows() and
+            x.rows() == v.rows() and
+            x.rows() == aext.rows() and
+            x.rows() == 3;
+        // clang-format on
+        if (not bPerParticleQuantityDimensionsValid)
+        {
+            std::string const what = fmt::format(
+                "x, v, aext, minv and B must have same #columns={} as x, and "
+                "3 rows (except minv and B)",
+                x.cols());
+            throw std::invalid_argument(what);
+        }
+        // clang-format off
+        bool const bElementDimensionsValid = 
+            T.rows()    == 4 and 
+            lame.rows() == 2 and 
+            lame.cols() == T.cols() and
+            alpha[kStableNeoHookean].size() == 2 * T.cols();
+        // clang-format on
+        if (not bElementDimensionsValid)
+        {
+            std::string const what = fmt::format(
+                "With #elements={0}, expected T=4x{0}, lame=2x{0} and Stable Neo-Hookean "
+                "compliance of size={1}",
+                T.cols(),
+                2 * T.cols());
+            throw std::invalid_argument(what);
+        }
+        // clang-format off
+        bool const bCollisionDimensionsValid = 
+            (F.size() == 0 or F.rows() == 3) and 
+            alpha[kCollision].size() == V.size();
+        // clang-format on
+        if (not bCollisionDimensionsValid)
+        {
+            std::string const what = fmt::format(
+                "Expected 3x|#collision triangles| F and collision compliance of size={}",
+                V.size());
+            throw std::invalid_argument(what);
+        }
+        bool const bHasPartitions = T.cols() == 0 or not partitions.empty();
+        if (not bHasPartitions)
+        {
+            throw std::invalid_argument(
+                "Expected partitions of the elastic constraints for parallel projection");
+        }
+    }
+    return *this;
+}
+
+} // namespace xpbd
 } // namespace sim
-} // namespace pbat
\ No newline at end of file
+} // namespace pbat
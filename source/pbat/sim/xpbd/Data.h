@@ -1,12 +1,72 @@
 #ifndef PBAT_SIM_XPBD_DATA_H
 #define PBAT_SIM_XPBD_DATA_H
 
+#include "Enums.h"
+#include "PhysicsBasedAnimationToolkitExport.h"
+#include "pbat/Aliases.h"
+
+#include <array>
+#include <vector>
+
 namespace pbat {
 namespace sim {
 namespace xpbd {
 
+PBAT_API struct Data
+{
+  public:
+    static auto constexpr kConstraintTypes =
+        static_cast<int>(EConstraint::NumberOfConstraintTypes);
+
+    Data&
+    WithVolumeMesh(Eigen::Ref<MatrixX const> const& V, Eigen::Ref<IndexMatrixX const> const& E);
+    Data& WithSurfaceMesh(
+        Eigen::Ref<IndexVectorX const> const& V,
+        Eigen::Ref<IndexMatrixX const> const& F);
+    Data& WithBodies(Eigen::Ref<IndexVectorX const> const& B);
+    Data& WithVelocity(Eigen::Ref<MatrixX const> const& v);
+    Data& WithAcceleration(Eigen::Ref<MatrixX const> const& aext);
+    Data& WithMassInverse(Eigen::Ref<VectorX const> const& minv);
+    Data& WithElasticMaterial(Eigen::Ref<MatrixX const> const& lame);
+    Data& WithCompliance(Eigen::Ref<VectorX const> const& alpha, EConstraint eConstraint);
+    Data& WithFrictionCoefficients(Scalar muS, Scalar muK);
+    Data& WithPartitions(std::vector<std::vector<Index>> const& partitions);
+    Data& WithDirichletConstrainedVertices(IndexVectorX const& dbc, bool bDbcSorted = true);
+    Data& Construct(bool bValidate = true);
+
+  public:
+    IndexVectorX V; ///< Collision vertices
+    IndexMatrixX F; ///< Collision triangles (on the boundary of T)
+    IndexMatrixX T; ///< Tetrahedra
+    IndexVectorX B; ///< |#particles| body index of each particle
+
+    MatrixX x;        ///< Particle positions
+    MatrixX v;        ///< Particle velocities
+    MatrixX aext;     ///< Particle external accelerations
+    VectorX minv;     ///< Particle mass inverses
+    MatrixX xt;       ///< Previous particle positions
+    MatrixX lame;     ///< 2x|#elements| Lame coefficients
+    MatrixX DmInv;    ///< 3x|3*#elements| material shape matrix inverses
+    VectorX gammaSNH; ///< |#elements| rest stability terms of Stable Neo-Hookean constraints
+
+    std::array<VectorX, kConstraintTypes>
+        alpha; ///< alpha[c] gives the compliance of constraints of type c, i.e. 2x|#elements|
+               ///< for StableNeoHookean and |#collision vertices| for Collision
+    std::array<VectorX, kConstraintTypes>
+        lambda; ///< lambda[c] gives the "Lagrange" multipliers of constraints of type c
+
+    std::vector<std::vector<Index>>
+        partitions; ///< partitions[p] gives the p^{th} group of elastic constraints (i.e.
+                    ///< tetrahedra) which can all be projected independently in parallel
+
+    IndexVectorX dbc; ///< Dirichlet constrained vertices (sorted)
+
+    Scalar muS{0.5}; ///< Static Coulomb friction coefficient
+    Scalar muK{0.3}; ///< Dynamic Coulomb friction coefficient
+};
+
 } // namespace xpbd
 } // namespace sim
 } // namespace pbat
 
-#endif // PBAT_SIM_XPBD_DATA_H
\ No newline at end of file
+#endif // PBAT_SIM_XPBD_DATA_H
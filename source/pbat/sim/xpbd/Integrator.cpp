@@ -1,9 +1,321 @@
 #include "Integrator.h"
 
+#include "Kernels.h"
+#include "pbat/geometry/DistanceQueries.h"
+#include "pbat/geometry/OverlapQueries.h"
+#include "pbat/geometry/TetrahedralAabbHierarchy.h"
+#include "pbat/geometry/TriangleAabbHierarchy.h"
+#include "pbat/math/linalg/mini/Mini.h"
+#include "pbat/profiling/Profiling.h"
+
+#include <limits>
+#include <tbb/parallel_for.h>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
 namespace pbat {
 namespace sim {
 namespace xpbd {
 
+namespace {
+
+/**
+ * @brief Finds, for each collision vertex penetrating a tetrahedron, its nearest collision
+ * triangle belonging to a different body.
+ * @param data
+ * @return |#collision vertices| array of contact triangles, or -1 for vertices without contact
+ */
+IndexVectorX DetectVertexTriangleContacts(Data const& data)
+{
+    PBAT_PROFILE_NAMED_SCOPE("pbat.sim.xpbd.Integrator.DetectVertexTriangleContacts");
+    auto const nCollisionVertices = data.V.size();
+    IndexVectorX fc               = IndexVectorX::Constant(nCollisionVertices, Index(-1));
+    if (nCollisionVertices == 0 or data.F.cols() == 0 or data.T.cols() == 0)
+        return fc;
+
+    using TetrahedronBvh = geometry::TetrahedralAabbHierarchy;
+    using TriangleBvh    = geometry::TriangleAabbHierarchy<3>;
+    TetrahedronBvh const Tbvh(data.x, data.T);
+    TriangleBvh const Fbvh(data.x, data.F);
+    using math::linalg::mini::FromEigen;
+    tbb::parallel_for(Index(0), Index(nCollisionVertices), [&](Index c) {
+        Index const i = data.V(c);
+        auto const xi = data.x.col(i).head<3>();
+        // Collision vertex must penetrate a tetrahedron which it is not a vertex of
+        std::vector<Index> const overlaps = Tbvh.PrimitivesIntersecting(
+            [&](TetrahedronBvh::BoundingVolumeType const& bv) -> bool {
+                return bv.contains(xi);
+            },
+            [&](TetrahedronBvh::PrimitiveType const& T) -> bool {
+                bool const bAreTopologicallySeparate = (T.array() != i).all();
+                if (not bAreTopologicallySeparate)
+                    return false;
+                auto const xT = data.x(Eigen::all, T);
+                return geometry::OverlapQueries::PointTetrahedron3D(
+                    FromEigen(xi),
+                    FromEigen(xT.col(0).head<3>()),
+                    FromEigen(xT.col(1).head<3>()),
+                    FromEigen(xT.col(2).head<3>()),
+                    FromEigen(xT.col(3).head<3>()));
+            },
+            1ULL);
+        if (overlaps.empty())
+            return;
+        // Contact triangle is the nearest topologically separate triangle of another body
+        Scalar constexpr kInvalidDistance = std::numeric_limits<Scalar>::max();
+        auto const [nearestTriangles, distances] = Fbvh.NearestPrimitivesTo(
+            [&](TriangleBvh::BoundingVolumeType const& bv) -> Scalar {
+                return bv.squaredExteriorDistance(xi);
+            },
+            [&](TriangleBvh::PrimitiveType const& F) -> Scalar {
+                bool const bFromDifferentBodies      = data.B(F(0)) != data.B(i);
+                bool const bAreTopologicallySeparate = (F.array() != i).all();
+                if (not(bFromDifferentBodies and bAreTopologicallySeparate))
+                    return kInvalidDistance;
+                auto const xF = data.x(Eigen::all, F);
+                return geometry::DistanceQueries::PointTriangle(
+                    FromEigen(xi),
+                    FromEigen(xF.col(0).head<3>()),
+                    FromEigen(xF.col(1).head<3>()),
+                    FromEigen(xF.col(2).head<3>()));
+            },
+            1ULL);
+        bool const bHasContact = not nearestTriangles.empty() and
+                                 distances.front() < kInvalidDistance;
+        if (bHasContact)
+            fc(c) = nearestTriangles.front();
+    });
+    return fc;
+}
+
+} // namespace
+
+Integrator::Integrator(Data dataIn) : data(std::move(dataIn)) {}
+
+void Integrator::Step(Scalar dt, Index iterations, Index substeps)
+{
+    PBAT_PROFILE_NAMED_SCOPE("pbat.sim.xpbd.Integrator.Step");
+
+    Scalar const sdt              = dt / (static_cast<Scalar>(substeps));
+    Scalar const sdt2             = sdt * sdt;
+    auto const nParticles         = data.x.cols();
+    auto const nCollisionVertices = data.V.size();
+    using IndexType               = std::remove_const_t<decltype(nParticles)>;
+    using namespace math::linalg;
+    using mini::FromEigen;
+    using mini::ToEigen;
+    // Detect collision candidates and setup collision constraint solve
+    IndexVectorX const fc   = DetectVertexTriangleContacts(data);
+    bool const bHasContacts = (fc.array() >= Index(0)).any();
+    MatrixX xk{};
+
+    auto constexpr kStableNeoHookean = static_cast<int>(EConstraint::StableNeoHookean);
+    auto constexpr kCollision        = static_cast<int>(EConstraint::Collision);
+    VectorX const& alphaSNH          = data.alpha[kStableNeoHookean];
+    VectorX const& alphaCollision    = data.alpha[kCollision];
+    VectorX& lambdaSNH               = data.lambda[kStableNeoHookean];
+    VectorX& lambdaCollision         = data.lambda[kCollision];
+    for (auto s = 0; s < substeps; ++s)
+    {
+        // Reset "Lagrange" multipliers
+        for (auto& lambdac : data.lambda)
+            lambdac.setZero();
+        // Store previous positions
+        data.xt = data.x;
+        // Initialize constraint solve
+        tbb::parallel_for(IndexType(0), nParticles, [&](IndexType i) {
+            auto x = kernels::InitialPosition(
+                FromEigen(data.xt.col(i).head<3>()),
+                FromEigen(data.v.col(i).head<3>()),
+                FromEigen(data.aext.col(i).head<3>()),
+                sdt,
+                sdt2);
+            data.x.col(i) = ToEigen(x);
+        });
+        // Solve constraints
+        for (auto k = 0; k < iterations; ++k)
+        {
+            // Elastic constraints
+            for (auto const& partition : data.partitions)
+            {
+                auto const nConstraintsInPartition = static_cast<std::size_t>(partition.size());
+                tbb::parallel_for(std::size_t(0), nConstraintsInPartition, [&](std::size_t p) {
+                    auto const c  = partition[p];
+                    auto const Tc = data.T.col(c);
+                    mini::SMatrix<Scalar, 3, 4> xc =
+                        FromEigen(data.x(Eigen::all, Tc).block<3, 4>(0, 0));
+                    mini::SVector<Scalar, 4> minvc   = FromEigen(data.minv(Tc).head<4>());
+                    mini::SVector<Scalar, 2> lambdac = FromEigen(lambdaSNH.segment<2>(2 * c));
+                    kernels::ProjectStableNeoHookean(
+                        FromEigen(data.DmInv.block<3, 3>(0, 3 * c)),
+                        data.gammaSNH(c),
+                        minvc,
+                        FromEigen(alphaSNH.segment<2>(2 * c)),
+                        sdt2,
+                        lambdac,
+                        xc);
+                    lambdaSNH.segment<2>(2 * c) = ToEigen(lambdac);
+                    data.x(Eigen::all, Tc)      = ToEigen(xc);
+                });
+            }
+            // Collision constraints
+            if (not bHasContacts)
+                continue;
+            // Contact triangles are read from a snapshot of the positions, since their vertices
+            // may themselves be projected concurrently as collision vertices.
+            xk = data.x;
+            tbb::parallel_for(Index(0), Index(nCollisionVertices), [&](Index c) {
+                auto const f = fc(c);
+                if (f < 0)
+                    return;
+                auto const i                   = data.V(c);
+                auto const Ff                  = data.F.col(f);
+                mini::SVector<Scalar, 3> xv    = FromEigen(data.x.col(i).head<3>());
+                mini::SMatrix<Scalar, 3, 3> xf = FromEigen(xk(Eigen::all, Ff).block<3, 3>(0, 0));
+                mini::SVector<Scalar, 3> xvt   = FromEigen(data.xt.col(i).head<3>());
+                mini::SMatrix<Scalar, 3, 3> xft =
+                    FromEigen(data.xt(Eigen::all, Ff).block<3, 3>(0, 0));
+                Scalar const atildec  = alphaCollision(c) / sdt2;
+                Scalar lambdac        = lambdaCollision(c);
+                bool const bProjected = kernels::ProjectVertexTriangle(
+                    data.minv(i),
+                    xvt,
+                    xft,
+                    xf,
+                    data.muS,
+                    data.muK,
+                    atildec,
+                    lambdac,
+                    xv);
+                if (not bProjected)
+                    return;
+                lambdaCollision(c) = lambdac;
+                data.x.col(i)      = ToEigen(xv);
+            });
+        }
+        // Update velocity
+        tbb::parallel_for(IndexType(0), nParticles, [&](IndexType i) {
+            auto v = kernels::IntegrateVelocity(
+                FromEigen(data.xt.col(i).head<3>()),
+                FromEigen(data.x.col(i).head<3>()),
+                sdt);
+            data.v.col(i) = ToEigen(v);
+        });
+    }
+}
+
 } // namespace xpbd
 } // namespace sim
-} // namespace pbat
\ No newline at end of file
+} // namespace pbat
+
+#include "pbat/physics/HyperElasticity.h"
+
+#include <doctest/doctest.h>
+
+TEST_CASE("[sim][xpbd] Integrator")
+{
+    using namespace pbat;
+    // Arrange
+    // Cube mesh
+    MatrixX P(3, 8);
+    IndexMatrixX T(4, 5);
+    IndexMatrixX F(3, 12);
+    // clang-format off
+    P << 0.f, 1.f, 0.f, 1.f, 0.f, 1.f, 0.f, 1.f,
+         0.f, 0.f, 1.f, 1.f, 0.f, 0.f, 1.f, 1.f,
+         0.f, 0.f, 0.f, 0.f, 1.f, 1.f, 1.f, 1.f;
+    T << 0, 3, 5, 6, 0,
+         1, 2, 4, 7, 5,
+         3, 0, 6, 5, 3,
+         5, 6, 0, 3, 6;
+    F << 0, 1, 1, 3, 3, 2, 2, 0, 0, 0, 4, 5,
+         1, 5, 3, 7, 2, 6, 0, 4, 3, 2, 5, 7,
+         4, 4, 5, 5, 7, 7, 6, 6, 1, 3, 6, 6;
+    // clang-format on
+    // Tetrahedra of the cube mesh all share vertices
+    std::vector<std::vector<Index>> partitions{{0}, {1}, {2}, {3}, {4}};
+    // Material parameters
+    auto constexpr Y        = Scalar{1e6};
+    auto constexpr nu       = Scalar{0.45};
+    auto const [mu, lambda] = physics::LameCoefficients(Y, nu);
+    MatrixX lame(2, T.cols());
+    lame.row(0).setConstant(mu);
+    lame.row(1).setConstant(lambda);
+    auto constexpr dt         = Scalar{1e-2};
+    auto constexpr substeps   = 1;
+    auto constexpr iterations = 10;
+    auto constexpr zero       = Scalar{1e-4};
+
+    SUBCASE("Free fall")
+    {
+        // Act
+        using pbat::sim::xpbd::Integrator;
+        Integrator xpbd{sim::xpbd::Data()
+                            .WithVolumeMesh(P, T)
+                            .WithElasticMaterial(lame)
+                            .WithPartitions(partitions)
+                            .Construct()};
+        xpbd.Step(dt, iterations, substeps);
+
+        // Assert
+        MatrixX dx                           = xpbd.data.x - P;
+        bool const bVerticesFallUnderGravity = (dx.row(2).array() < Scalar{0}).all();
+        CHECK(bVerticesFallUnderGravity);
+        // Unconverged elastic constraints may deform the cube slightly, but its center of mass
+        // must only fall
+        Vector<3> const dxc       = dx.rowwise().mean();
+        bool const bCubeOnlyFalls = (dxc.head<2>().array().abs() < zero).all();
+        CHECK(bCubeOnlyFalls);
+    }
+    SUBCASE("Contact")
+    {
+        // Arrange
+        // Fixed cube at the bottom, and a smaller cube on top of it, whose bottom vertices
+        // penetrate the fixed cube's top face (away from its edges and diagonals).
+        auto const nVertices = P.cols();
+        auto const nElements = T.cols();
+        MatrixX X(3, 2 * nVertices);
+        X.leftCols(nVertices) = P;
+        X.rightCols(nVertices) =
+            (Scalar{0.5} * P).colwise() + Vector<3>{Scalar{0.3}, Scalar{0.1}, Scalar{0.95}};
+        IndexMatrixX C(4, 2 * nElements);
+        C.leftCols(nElements)  = T;
+        C.rightCols(nElements) = T.array() + nVertices;
+        IndexMatrixX CF(3, 2 * F.cols());
+        CF.leftCols(F.cols())  = F;
+        CF.rightCols(F.cols()) = F.array() + nVertices;
+        IndexVectorX V(2 * nVertices);
+        V.setLinSpaced(0, static_cast<Index>(V.size() - 1));
+        IndexVectorX B(2 * nVertices);
+        B.head(nVertices).setZero();
+        B.tail(nVertices).setOnes();
+        IndexVectorX dbc = V.head(nVertices);
+        MatrixX lames(2, 2 * nElements);
+        lames << lame, lame;
+        std::vector<std::vector<Index>> cpartitions = partitions;
+        for (auto const& partition : partitions)
+            cpartitions.push_back({partition.front() + nElements});
+        MatrixX aext = MatrixX::Zero(3, 2 * nVertices);
+
+        // Act
+        using pbat::sim::xpbd::Integrator;
+        Integrator xpbd{sim::xpbd::Data()
+                            .WithVolumeMesh(X, C)
+                            .WithSurfaceMesh(V, CF)
+                            .WithBodies(B)
+                            .WithAcceleration(aext)
+                            .WithElasticMaterial(lames)
+                            .WithPartitions(cpartitions)
+                            .WithDirichletConstrainedVertices(dbc)
+                            .Construct()};
+        xpbd.Step(dt, iterations, substeps);
+
+        // Assert
+        bool const bFixedCubeDidNotMove = xpbd.data.x.leftCols(nVertices).isApprox(P);
+        CHECK(bFixedCubeDidNotMove);
+        auto const xBottom = xpbd.data.x(Eigen::all, IndexVector<4>{8, 9, 10, 11});
+        bool const bPenetrationResolved = (xBottom.row(2).array() >= Scalar{1} - zero).all();
+        CHECK(bPenetrationResolved);
+    }
+}
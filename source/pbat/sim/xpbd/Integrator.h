@@ -1,12 +1,26 @@
 #ifndef PBAT_SIM_XPBD_INTEGRATOR_H
 #define PBAT_SIM_XPBD_INTEGRATOR_H
 
+#include "Data.h"
+#include "PhysicsBasedAnimationToolkitExport.h"
+#include "pbat/Aliases.h"
+
 namespace pbat {
 namespace sim {
 namespace xpbd {
 
+class Integrator
+{
+  public:
+    PBAT_API Integrator(Data data);
+
+    PBAT_API void Step(Scalar dt, Index iterations, Index substeps = Index{1});
+
+    PBAT_API Data data;
+};
+
 } // namespace xpbd
 } // namespace sim
 } // namespace pbat
 
-#endif // PBAT_SIM_XPBD_INTEGRATOR_H
\ No newline at end of file
+#endif // PBAT_SIM_XPBD_INTEGRATOR_H
@@ -1,12 +1,207 @@
 #ifndef PBAT_SIM_XPBD_KERNELS_H
 #define PBAT_SIM_XPBD_KERNELS_H
 
+#include "pbat/HostDevice.h"
+#include "pbat/geometry/ClosestPointQueries.h"
+#include "pbat/geometry/IntersectionQueries.h"
+#include "pbat/math/linalg/mini/Mini.h"
+
+#include <algorithm>
+
 namespace pbat {
 namespace sim {
 namespace xpbd {
+namespace kernels {
+
+namespace mini = math::linalg::mini;
+
+template <
+    mini::CMatrix TMatrixXT,
+    mini::CMatrix TMatrixVT,
+    mini::CMatrix TMatrixA,
+    class ScalarType = typename TMatrixXT::ScalarType>
+PBAT_HOST_DEVICE mini::SVector<ScalarType, TMatrixXT::kRows> InitialPosition(
+    TMatrixXT const& xt,
+    TMatrixVT const& vt,
+    TMatrixA const& aext,
+    ScalarType dt,
+    ScalarType dt2)
+{
+    return xt + dt * vt + dt2 * aext;
+}
+
+template <mini::CMatrix TMatrixMinv, class ScalarType = typename TMatrixMinv::ScalarType>
+PBAT_HOST_DEVICE void ProjectBlockNeoHookean(
+    ScalarType C,
+    mini::SMatrix<ScalarType, 3, 4> const& gradC,
+    TMatrixMinv const& minvc,
+    ScalarType atilde,
+    ScalarType& lambdac,
+    mini::SMatrix<ScalarType, 3, 4>& xc)
+{
+    using namespace mini;
+    ScalarType dlambda =
+        -(C + atilde * lambdac) /
+        (minvc(0) * SquaredNorm(gradC.Col(0)) + minvc(1) * SquaredNorm(gradC.Col(1)) +
+         minvc(2) * SquaredNorm(gradC.Col(2)) + minvc(3) * SquaredNorm(gradC.Col(3)) + atilde);
+    lambdac += dlambda;
+    xc.Col(0) += (minvc(0) * dlambda) * gradC.Col(0);
+    xc.Col(1) += (minvc(1) * dlambda) * gradC.Col(1);
+    xc.Col(2) += (minvc(2) * dlambda) * gradC.Col(2);
+    xc.Col(3) += (minvc(3) * dlambda) * gradC.Col(3);
+}
+
+template <
+    mini::CMatrix TMatrixDmInv,
+    mini::CMatrix TMatrixMinv,
+    class ScalarType = typename TMatrixDmInv::ScalarType>
+PBAT_HOST_DEVICE void ProjectDeviatoric(
+    TMatrixDmInv const& DmInv,
+    TMatrixMinv const& minvc,
+    ScalarType atilde,
+    ScalarType& lambdac,
+    mini::SMatrix<ScalarType, 3, 4>& xc)
+{
+    using namespace mini;
+    SMatrix<ScalarType, 3, 3> F =
+        (xc.template Slice<3, 3>(0, 1) - Repeat<1, 3>(xc.Col(0))) * DmInv;
+    ScalarType C = Norm(F);
+    SMatrix<ScalarType, 3, 4> gradC{};
+    gradC.template Slice<3, 3>(0, 1) = (F * DmInv.Transpose()) / C;
+    gradC.Col(0)                     = -(gradC.Col(1) + gradC.Col(2) + gradC.Col(3));
+    ProjectBlockNeoHookean(C, gradC, minvc, atilde, lambdac, xc);
+}
+
+template <
+    mini::CMatrix TMatrixDmInv,
+    mini::CMatrix TMatrixMinv,
+    class ScalarType = typename TMatrixDmInv::ScalarType>
+PBAT_HOST_DEVICE void ProjectHydrostatic(
+    TMatrixDmInv const& DmInv,
+    ScalarType gamma,
+    TMatrixMinv const& minvc,
+    ScalarType atilde,
+    ScalarType& lambdac,
+    mini::SMatrix<ScalarType, 3, 4>& xc)
+{
+    using namespace mini;
+    SMatrix<ScalarType, 3, 3> F =
+        (xc.template Slice<3, 3>(0, 1) - Repeat<1, 3>(xc.Col(0))) * DmInv;
+    ScalarType C = Determinant(F) - gamma;
+    SMatrix<ScalarType, 3, 3> P{};
+    P.Col(0) = Cross(F.Col(1), F.Col(2));
+    P.Col(1) = Cross(F.Col(2), F.Col(0));
+    P.Col(2) = Cross(F.Col(0), F.Col(1));
+    SMatrix<ScalarType, 3, 4> gradC{};
+    gradC.template Slice<3, 3>(0, 1) = P * DmInv.Transpose();
+    gradC.Col(0)                     = -(gradC.Col(1) + gradC.Col(2) + gradC.Col(3));
+    ProjectBlockNeoHookean(C, gradC, minvc, atilde, lambdac, xc);
+}
+
+template <
+    mini::CMatrix TMatrixDmInv,
+    mini::CMatrix TMatrixMinv,
+    mini::CMatrix TMatrixAlpha,
+    mini::CMatrix TMatrixLambda,
+    class ScalarType = typename TMatrixDmInv::ScalarType>
+PBAT_HOST_DEVICE void ProjectStableNeoHookean(
+    TMatrixDmInv const& DmInv,
+    ScalarType gamma,
+    TMatrixMinv const& minvc,
+    TMatrixAlpha const& alphac,
+    ScalarType dt2,
+    TMatrixLambda& lambdac,
+    mini::SMatrix<ScalarType, 3, 4>& xc)
+{
+    ProjectDeviatoric(DmInv, minvc, alphac(0) / dt2, lambdac(0), xc);
+    ProjectHydrostatic(DmInv, gamma, minvc, alphac(1) / dt2, lambdac(1), xc);
+}
+
+template <
+    mini::CMatrix TMatrixXVT,
+    mini::CMatrix TMatrixXFT,
+    mini::CMatrix TMatrixXF,
+    mini::CMatrix TMatrixXV,
+    class ScalarType = typename TMatrixXVT::ScalarType>
+PBAT_HOST_DEVICE bool ProjectVertexTriangle(
+    ScalarType minvv,
+    TMatrixXVT const& xvt,
+    TMatrixXFT const& xft,
+    TMatrixXF const& xf,
+    ScalarType muS,
+    ScalarType muK,
+    ScalarType atildec,
+    ScalarType& lambdac,
+    TMatrixXV& xv)
+{
+    using namespace mini;
+    // Numerically zero inverse mass makes the Schur complement ill-conditioned/singular
+    if (minvv < ScalarType{1e-10})
+        return false;
+    // Compute triangle normal
+    SVector<ScalarType, 3> T1        = xf.Col(1) - xf.Col(0);
+    SVector<ScalarType, 3> T2        = xf.Col(2) - xf.Col(0);
+    SVector<ScalarType, 3> n         = Cross(T1, T2);
+    ScalarType const doublearea      = Norm(n);
+    bool const bIsTriangleDegenerate = doublearea <= ScalarType{1e-8};
+    if (bIsTriangleDegenerate)
+        return false;
+
+    n /= doublearea;
+    using namespace pbat::geometry;
+    SVector<ScalarType, 3> xc = ClosestPointQueries::PointOnPlane(xv, xf.Col(0), n);
+    // Check if xv projects to the triangle's interior by checking its barycentric coordinates
+    SVector<ScalarType, 3> b =
+        IntersectionQueries::TriangleBarycentricCoordinates(xc - xf.Col(0), T1, T2);
+    // If xv doesn't project inside triangle, then we don't generate a contact response
+    // clang-format off
+    bool const bIsVertexInsideTriangle = 
+        (b(0) >= ScalarType{0}) and (b(0) <= ScalarType{1}) and
+        (b(1) >= ScalarType{0}) and (b(1) <= ScalarType{1}) and
+        (b(2) >= ScalarType{0}) and (b(2) <= ScalarType{1});
+    // clang-format on
+    if (not bIsVertexInsideTriangle)
+        return false;
+
+    // If xv is positively oriented w.r.t. triangles xf, there is no penetration
+    ScalarType const C = Dot(n, xv - xf.Col(0));
+    if (C > ScalarType{0})
+        return false;
+
+    // We assume that the triangle is static (although it is not), so that the gradient is n for
+    // the vertex.
+
+    // Collision constraint
+    ScalarType dlambda        = -(C + atildec * lambdac) / (minvv + atildec);
+    SVector<ScalarType, 3> dx = dlambda * minvv * n;
+    xv += dx;
+    lambdac += dlambda;
+
+    // Friction constraint (see https://dl.acm.org/doi/10.1145/2601097.2601152)
+    ScalarType const d   = Norm(dx);
+    dx                   = (xv - xvt) - (xf * b - xft * b);
+    dx                   = dx - n * n.Transpose() * dx;
+    ScalarType const dxd = Norm(dx);
+    if (dxd > muS * d)
+        dx *= std::min(muK * d / dxd, ScalarType{1});
+
+    xv += dx;
+    return true;
+}
+
+template <
+    mini::CMatrix TMatrixXT,
+    mini::CMatrix TMatrixX,
+    class ScalarType = typename TMatrixXT::ScalarType>
+PBAT_HOST_DEVICE mini::SVector<ScalarType, TMatrixXT::kRows>
+IntegrateVelocity(TMatrixXT const& xt, TMatrixX const& x, ScalarType dt)
+{
+    return (x - xt) / dt;
+}
 
+} // namespace kernels
 } // namespace xpbd
 } // namespace sim
 } // namespace pbat
 
-#endif // PBAT_SIM_XPBD_KERNELS_H
\ No newline at end of file
+#endif // PBAT_SIM_XPBD_KERNELS_H